@@ -0,0 +1,220 @@
+#include "AABB.h"
+#include "FileSystem.h"
+#include "ThreadPool.h"
+#include <limits>
+#include <cmath>
+#include <mutex>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define AABB_USE_AVX
+#define AABB_USE_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define AABB_USE_SSE
+#endif
+
+// Below this many vertices splitting across threads costs more than it saves
+#define PARALLEL_BOUNDS_THRESHOLD 262144
+#define PARALLEL_BOUNDS_CHUNK 65536
+
+AABB::AABB()
+    : min(std::numeric_limits<float>::max()),
+    max(std::numeric_limits<float>::lowest())
+{
+}
+
+AABB::AABB(const glm::vec3& min, const glm::vec3& max) : min(min), max(max)
+{
+}
+
+void AABB::Enclose(const glm::vec3& point)
+{
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void AABB::Enclose(const AABB& other)
+{
+    if (!other.IsValid()) return;
+
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+}
+
+AABB AABB::Transformed(const glm::mat4& matrix) const
+{
+    if (!IsValid()) return AABB();
+
+    glm::vec3 center = GetCenter();
+    glm::vec3 extents = GetExtents();
+
+    glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+
+    // Each world axis extent is the sum of the absolute projections of the local extents
+    glm::vec3 newExtents;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        newExtents[axis] =
+            std::abs(matrix[0][axis]) * extents.x +
+            std::abs(matrix[1][axis]) * extents.y +
+            std::abs(matrix[2][axis]) * extents.z;
+    }
+
+    return AABB(newCenter - newExtents, newCenter + newExtents);
+}
+
+bool AABB::Contains(const glm::vec3& point) const
+{
+    return point.x >= min.x && point.x <= max.x &&
+        point.y >= min.y && point.y <= max.y &&
+        point.z >= min.z && point.z <= max.z;
+}
+
+bool AABB::Contains(const AABB& other) const
+{
+    return other.min.x >= min.x && other.max.x <= max.x &&
+        other.min.y >= min.y && other.max.y <= max.y &&
+        other.min.z >= min.z && other.max.z <= max.z;
+}
+
+bool AABB::Intersects(const AABB& other) const
+{
+    return min.x <= other.max.x && max.x >= other.min.x &&
+        min.y <= other.max.y && max.y >= other.min.y &&
+        min.z <= other.max.z && max.z >= other.min.z;
+}
+
+bool AABB::IntersectsSphere(const glm::vec3& center, float radius) const
+{
+    glm::vec3 closest = glm::clamp(center, min, max);
+    glm::vec3 offset = center - closest;
+    return glm::dot(offset, offset) <= radius * radius;
+}
+
+bool AABB::IntersectsRay(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& tNear) const
+{
+    glm::vec3 t0 = (min - origin) * invDirection;
+    glm::vec3 t1 = (max - origin) * invDirection;
+
+    glm::vec3 tMin = glm::min(t0, t1);
+    glm::vec3 tMax = glm::max(t0, t1);
+
+    float entry = std::max(std::max(tMin.x, tMin.y), tMin.z);
+    float exit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDistance));
+
+    if (entry > exit || exit < 0.0f) return false;
+
+    tNear = entry >= 0.0f ? entry : exit;
+    return true;
+}
+
+// Min/max over a range of vertices. Vertex::position is followed by the normal,
+// so a 4-wide load at the position is always in bounds and lane 3 is ignored.
+static void VertexBoundsKernel(const Vertex* vertices, size_t count, glm::vec3& outMin, glm::vec3& outMax)
+{
+    size_t i = 0;
+
+#if defined(AABB_USE_AVX)
+    // Two vertices per 256-bit register, two accumulators to hide latency
+    __m128 first = _mm_loadu_ps(&vertices[0].position.x);
+    __m256 min0 = _mm256_insertf128_ps(_mm256_castps128_ps256(first), first, 1);
+    __m256 max0 = min0;
+    __m256 min1 = min0;
+    __m256 max1 = min0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256 p01 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&vertices[i].position.x)),
+            _mm_loadu_ps(&vertices[i + 1].position.x), 1);
+        __m256 p23 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&vertices[i + 2].position.x)),
+            _mm_loadu_ps(&vertices[i + 3].position.x), 1);
+
+        min0 = _mm256_min_ps(min0, p01);
+        max0 = _mm256_max_ps(max0, p01);
+        min1 = _mm256_min_ps(min1, p23);
+        max1 = _mm256_max_ps(max1, p23);
+    }
+
+    min0 = _mm256_min_ps(min0, min1);
+    max0 = _mm256_max_ps(max0, max1);
+
+    __m128 minV = _mm_min_ps(_mm256_castps256_ps128(min0), _mm256_extractf128_ps(min0, 1));
+    __m128 maxV = _mm_max_ps(_mm256_castps256_ps128(max0), _mm256_extractf128_ps(max0, 1));
+#elif defined(AABB_USE_SSE)
+    __m128 minV = _mm_loadu_ps(&vertices[0].position.x);
+    __m128 maxV = minV;
+    __m128 min1 = minV;
+    __m128 max1 = minV;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128 p0 = _mm_loadu_ps(&vertices[i].position.x);
+        __m128 p1 = _mm_loadu_ps(&vertices[i + 1].position.x);
+
+        minV = _mm_min_ps(minV, p0);
+        maxV = _mm_max_ps(maxV, p0);
+        min1 = _mm_min_ps(min1, p1);
+        max1 = _mm_max_ps(max1, p1);
+    }
+
+    minV = _mm_min_ps(minV, min1);
+    maxV = _mm_max_ps(maxV, max1);
+#endif
+
+#if defined(AABB_USE_SSE)
+    // Remaining vertices
+    for (; i < count; ++i)
+    {
+        __m128 p = _mm_loadu_ps(&vertices[i].position.x);
+        minV = _mm_min_ps(minV, p);
+        maxV = _mm_max_ps(maxV, p);
+    }
+
+    alignas(16) float minOut[4];
+    alignas(16) float maxOut[4];
+    _mm_store_ps(minOut, minV);
+    _mm_store_ps(maxOut, maxV);
+
+    outMin = glm::vec3(minOut[0], minOut[1], minOut[2]);
+    outMax = glm::vec3(maxOut[0], maxOut[1], maxOut[2]);
+#else
+    outMin = vertices[0].position;
+    outMax = vertices[0].position;
+
+    for (; i < count; ++i)
+    {
+        outMin = glm::min(outMin, vertices[i].position);
+        outMax = glm::max(outMax, vertices[i].position);
+    }
+#endif
+}
+
+AABB ComputeVertexBounds(const Vertex* vertices, size_t count)
+{
+    if (vertices == nullptr || count == 0)
+    {
+        return AABB(glm::vec3(0.0f), glm::vec3(0.0f));
+    }
+
+    AABB bounds;
+
+    if (count < PARALLEL_BOUNDS_THRESHOLD)
+    {
+        VertexBoundsKernel(vertices, count, bounds.min, bounds.max);
+        return bounds;
+    }
+
+    std::mutex boundsMutex;
+    ThreadPool::GetInstance().ParallelFor(count, [&](size_t begin, size_t end)
+    {
+        AABB partial;
+        VertexBoundsKernel(vertices + begin, end - begin, partial.min, partial.max);
+
+        std::lock_guard<std::mutex> lock(boundsMutex);
+        bounds.Enclose(partial);
+    }, PARALLEL_BOUNDS_CHUNK);
+
+    return bounds;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+struct Vertex;
+
+// Axis-aligned bounding box
+struct AABB
+{
+    glm::vec3 min;
+    glm::vec3 max;
+
+    // Empty box (min > max) so the first Enclose sets it
+    AABB();
+    AABB(const glm::vec3& min, const glm::vec3& max);
+
+    bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+    glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 GetSize() const { return max - min; }
+    glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+    void Enclose(const glm::vec3& point);
+    void Enclose(const AABB& other);
+
+    // Box enclosing this one after a transform (center/extents form, no per-corner work)
+    AABB Transformed(const glm::mat4& matrix) const;
+
+    bool Contains(const glm::vec3& point) const;
+    bool Contains(const AABB& other) const;
+    bool Intersects(const AABB& other) const;
+    bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+    // Slab test. invDirection is 1 / ray direction per axis; tNear is the entry distance, or the
+    // exit distance when the origin is inside so that boxes around the camera do not win every pick.
+    bool IntersectsRay(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& tNear) const;
+};
+
+// Exact bounds of the vertex positions. Uses SSE/AVX min/max and splits
+// very large meshes across the thread pool.
+AABB ComputeVertexBounds(const Vertex* vertices, size_t count);
@@ -1,5 +1,9 @@
 #include "Application.h"
 #include <iostream>
+#include "ThreadPool.h"
+#include "VirtualFileSystem.h"
+#include "RedrawScheduler.h"
+#include "RenderThread.h"
 
 Application::Application() : isRunning(true)
 {
@@ -61,6 +65,9 @@ bool Application::Start()
 
     if (result)
     {
+        // From here on GL calls go through the render thread
+        RenderThread::GetInstance().Start(window->GetWindow(), renderContext->GetContext());
+
         LOG_CONSOLE("Engine ready - All systems initialized");
     }
 
@@ -76,7 +83,13 @@ bool Application::Update()
         return false;
     }
 
-    bool ret = true;
+    // Nothing to redraw: sleep on the event queue instead of spinning
+    RedrawScheduler& redraw = RedrawScheduler::GetInstance();
+    if (!redraw.IsRedrawPending())
+        redraw.WaitForEvents();
+
+    // Input runs first, its events decide whether this iteration draws
+    bool ret = input->PreUpdate();
 
     if (input->GetWindowEvent(WE_QUIT) == true) {
         LOG_DEBUG("Window close event detected");
@@ -84,15 +97,33 @@ bool Application::Update()
         ret = false;
     }
 
+    // Lines logged by other threads since the last iteration
+    if (ConsoleLog::GetInstance().Flush() > 0)
+        redraw.RequestRedraw(RedrawReason::UI);
+
+    // The last presented frame stays on screen
+    if (ret == true && !redraw.BeginFrame()) {
+        time->SkipFrame();
+        return true;
+    }
+
     if (ret == true)
         ret = PreUpdate();
 
+    // As many fixed steps as the accumulated frame time allows, then one render update
+    for (int step = 0; ret == true && step < time->GetFixedStepsThisFrame(); ++step)
+        ret = DoFixedUpdate();
+
     if (ret == true)
         ret = DoUpdate();
 
     if (ret == true)
         ret = PostUpdate();
 
+    // Frame pacing: sleeps instead of spinning when a frame rate cap is set or the editor is idle
+    if (ret == true)
+        time->WaitForNextFrame();
+
     return ret;
 }
 
@@ -101,6 +132,10 @@ bool Application::PreUpdate()
     //Iterates the module list and calls PreUpdate on each module
     bool result = true;
     for (const auto& module : moduleList) {
+        if (module == input) {
+            continue;
+        }
+
         result = module.get()->PreUpdate();
         if (!result) {
             break;
@@ -110,6 +145,23 @@ bool Application::PreUpdate()
     return result;
 }
 
+// Call modules once per fixed simulation step
+bool Application::DoFixedUpdate()
+{
+    time->BeginFixedStep();
+
+    bool result = true;
+    for (const auto& module : moduleList) {
+        result = module.get()->FixedUpdate();
+        if (!result) {
+            break;
+        }
+    }
+
+    time->EndFixedStep();
+    return result;
+}
+
 // Call modules on each loop iteration
 bool Application::DoUpdate()
 {
@@ -154,6 +206,9 @@ bool Application::CleanUp()
     LOG_DEBUG("=== Cleaning Up Application ===");
     LOG_CONSOLE("Cleaning up modules...");
 
+    // The modules release their GL resources on this thread
+    RenderThread::GetInstance().Stop();
+
     bool result = true;
     for (const auto& module : moduleList) {
         result = module.get()->CleanUp();
@@ -176,6 +231,9 @@ bool Application::CleanUp()
     delete selectionManager;
     selectionManager = nullptr;
 
+    ThreadPool::GetInstance().Shutdown();
+    VirtualFileSystem::GetInstance().Shutdown();
+
     ConsoleLog::GetInstance().Shutdown();
 
     LOG_DEBUG("=== Application Cleanup Complete ===");
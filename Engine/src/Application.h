@@ -67,6 +67,9 @@ private:
     // Call modules before each loop iteration
     bool PreUpdate();
 
+    // Call modules once per fixed simulation step
+    bool DoFixedUpdate();
+
     // Call modules on each loop iteration
     bool DoUpdate();
 
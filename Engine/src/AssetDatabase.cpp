@@ -0,0 +1,724 @@
+#include "AssetDatabase.h"
+#include <assimp/scene.h>
+#include <assimp/cimport.h>
+#include <windows.h>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <cctype>
+#include "FileSystem.h"
+#include "SceneSerializer.h"
+#include "Texture.h"
+#include "TextureCooker.h"
+#include "ThreadPool.h"
+#include "VirtualFileSystem.h"
+#include "Log.h"
+
+#define ASSET_DATABASE_MAGIC 0x53424441 // "ADBS"
+#define ASSET_DATABASE_VERSION 1
+#define ASSET_DATABASE_FILE "Library\\AssetDatabase.adb"
+#define LIBRARY_FOLDER "Library"
+
+// Bump when ProcessMesh, the optimizer or the LOD generation change their output
+#define MODEL_COOK_VERSION 1
+
+struct AssetDatabaseHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordCount;
+    uint32_t dependencyCount;
+    uint32_t outputCount;
+    uint32_t stringBytes;
+};
+
+// Range of the string table
+struct AssetString
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct AssetFileRecord
+{
+    uint64_t id;
+    uint64_t stamp;
+    uint64_t contentHash;
+    uint64_t cookedKey;
+    AssetString path;
+    uint32_t type;
+    uint32_t firstDependency;
+    uint32_t dependencyCount;
+    uint32_t firstOutput;
+    uint32_t outputCount;
+    uint32_t reserved;
+};
+
+struct AssetFileDependency
+{
+    AssetString reference;
+    uint64_t asset;
+};
+
+static uint64_t HashCombine(uint64_t hash, uint64_t value)
+{
+    return (hash ^ value) * 1099511628211ull;
+}
+
+// Lowercase with '/' separators, ids and lookups use this form
+static std::string NormalizePath(const std::string& path)
+{
+    std::string normalized = path;
+    for (char& c : normalized)
+        c = (c == '\\') ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return normalized;
+}
+
+static uint64_t GetPathId(const std::string& normalizedPath)
+{
+    return AssetDatabase::HashContent(normalizedPath.data(), normalizedPath.size());
+}
+
+static bool FileExists(const std::string& path)
+{
+    return GetFileAttributesA(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+}
+
+AssetDatabase& AssetDatabase::GetInstance()
+{
+    static AssetDatabase instance;
+    return instance;
+}
+
+uint64_t AssetDatabase::HashContent(const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+AssetType AssetDatabase::GetAssetType(const std::string& path)
+{
+    size_t extensionStart = path.find_last_of('.');
+    if (extensionStart == std::string::npos)
+        return AssetType::Unknown;
+
+    std::string extension = NormalizePath(path.substr(extensionStart + 1));
+
+    if (extension == "fbx" || extension == "obj")
+        return AssetType::Model;
+
+    if (extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "tga" ||
+        extension == "bmp" || extension == "dds")
+        return AssetType::Texture;
+
+    return AssetType::Unknown;
+}
+
+uint64_t AssetDatabase::GetCookKey(AssetType type, uint64_t contentHash)
+{
+    uint64_t key = HashCombine(contentHash, static_cast<uint64_t>(type));
+
+    if (type == AssetType::Model)
+    {
+        key = HashCombine(key, MODEL_COOK_VERSION);
+        key = HashCombine(key, FileSystem::GetImportFlags());
+    }
+    else if (type == AssetType::Texture)
+    {
+        key = HashCombine(key, TextureCooker::GetVersion());
+    }
+
+    return key;
+}
+
+std::string AssetDatabase::GetDatabasePath()
+{
+    std::string execDir = VirtualFileSystem::GetExecutableDirectory();
+    CreateDirectoryA((execDir + "\\" + LIBRARY_FOLDER).c_str(), NULL);
+    return execDir + "\\" + ASSET_DATABASE_FILE;
+}
+
+bool AssetDatabase::ToRelative(const std::string& path, std::string& relative, size_t* prefixLength) const
+{
+    if (directory.empty())
+        return false;
+
+    std::string normalized = NormalizePath(path);
+    std::string prefixes[2] = { NormalizePath(mountPoint) + "/", NormalizePath(directory) + "/" };
+
+    for (const std::string& prefix : prefixes)
+    {
+        if (normalized.size() > prefix.size() && normalized.compare(0, prefix.size(), prefix) == 0)
+        {
+            relative = normalized.substr(prefix.size());
+            if (prefixLength != nullptr)
+                *prefixLength = prefix.size();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool AssetDatabase::Open(const std::string& assetsDirectory, const std::string& assetsMountPoint)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    directory = assetsDirectory;
+    mountPoint = assetsMountPoint;
+    records.clear();
+
+    std::string path = GetDatabasePath();
+    std::vector<unsigned char> bytes;
+    if (!FileExists(path) || !VirtualFileSystem::GetInstance().ReadFile(path, bytes, IOPriority::Urgent) ||
+        bytes.size() < sizeof(AssetDatabaseHeader))
+    {
+        LOG_DEBUG("AssetDatabase: no database yet, every asset will be hashed on the first refresh");
+        return true;
+    }
+
+    AssetDatabaseHeader header;
+    memcpy(&header, bytes.data(), sizeof(header));
+
+    size_t expectedSize = sizeof(AssetDatabaseHeader) +
+        static_cast<size_t>(header.recordCount) * sizeof(AssetFileRecord) +
+        static_cast<size_t>(header.dependencyCount) * sizeof(AssetFileDependency) +
+        static_cast<size_t>(header.outputCount) * sizeof(uint64_t) +
+        header.stringBytes;
+
+    // An outdated or damaged database is only a cache, it is rebuilt
+    if (header.magic != ASSET_DATABASE_MAGIC || header.version != ASSET_DATABASE_VERSION || bytes.size() != expectedSize)
+    {
+        LOG_DEBUG("AssetDatabase: %s is not a database of version %d, starting over", path.c_str(), ASSET_DATABASE_VERSION);
+        return true;
+    }
+
+    const unsigned char* cursor = bytes.data() + sizeof(AssetDatabaseHeader);
+    const AssetFileRecord* fileRecords = reinterpret_cast<const AssetFileRecord*>(cursor);
+    cursor += header.recordCount * sizeof(AssetFileRecord);
+    const AssetFileDependency* fileDependencies = reinterpret_cast<const AssetFileDependency*>(cursor);
+    cursor += header.dependencyCount * sizeof(AssetFileDependency);
+    const unsigned char* fileOutputs = cursor;
+    cursor += header.outputCount * sizeof(uint64_t);
+    const char* strings = reinterpret_cast<const char*>(cursor);
+
+    auto validString = [&header](const AssetString& entry)
+    {
+        return entry.offset <= header.stringBytes && entry.length <= header.stringBytes - entry.offset;
+    };
+
+    for (uint32_t i = 0; i < header.recordCount; ++i)
+    {
+        AssetFileRecord fileRecord;
+        memcpy(&fileRecord, &fileRecords[i], sizeof(fileRecord));
+
+        bool valid = validString(fileRecord.path) &&
+            fileRecord.firstDependency <= header.dependencyCount &&
+            fileRecord.dependencyCount <= header.dependencyCount - fileRecord.firstDependency &&
+            fileRecord.firstOutput <= header.outputCount &&
+            fileRecord.outputCount <= header.outputCount - fileRecord.firstOutput;
+        if (!valid)
+        {
+            LOG_DEBUG("AssetDatabase: invalid record in %s, starting over", path.c_str());
+            records.clear();
+            return true;
+        }
+
+        AssetRecord& record = records[fileRecord.id];
+        record.id = fileRecord.id;
+        record.path.assign(strings + fileRecord.path.offset, fileRecord.path.length);
+        record.type = static_cast<AssetType>(fileRecord.type);
+        record.stamp = fileRecord.stamp;
+        record.contentHash = fileRecord.contentHash;
+        record.cookedKey = fileRecord.cookedKey;
+
+        for (uint32_t d = fileRecord.firstDependency; d < fileRecord.firstDependency + fileRecord.dependencyCount; ++d)
+        {
+            AssetFileDependency fileDependency;
+            memcpy(&fileDependency, &fileDependencies[d], sizeof(fileDependency));
+            if (!validString(fileDependency.reference))
+                continue;
+
+            AssetDependency dependency;
+            dependency.reference.assign(strings + fileDependency.reference.offset, fileDependency.reference.length);
+            dependency.asset = fileDependency.asset;
+            record.dependencies.push_back(dependency);
+        }
+
+        record.outputs.resize(fileRecord.outputCount);
+        memcpy(record.outputs.data(), fileOutputs + fileRecord.firstOutput * sizeof(uint64_t), fileRecord.outputCount * sizeof(uint64_t));
+    }
+
+    LOG_DEBUG("AssetDatabase: %u assets loaded from %s", header.recordCount, path.c_str());
+    return true;
+}
+
+bool AssetDatabase::Save()
+{
+    if (!IsOpen())
+        return false;
+
+    std::vector<AssetFileRecord> fileRecords;
+    std::vector<AssetFileDependency> fileDependencies;
+    std::vector<uint64_t> fileOutputs;
+    std::string strings;
+
+    auto addString = [&strings](const std::string& text)
+    {
+        AssetString entry;
+        entry.offset = static_cast<uint32_t>(strings.size());
+        entry.length = static_cast<uint32_t>(text.size());
+        strings += text;
+        return entry;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fileRecords.reserve(records.size());
+
+        for (const auto& entry : records)
+        {
+            const AssetRecord& record = entry.second;
+
+            AssetFileRecord fileRecord;
+            memset(&fileRecord, 0, sizeof(fileRecord));
+            fileRecord.id = record.id;
+            fileRecord.stamp = record.stamp;
+            fileRecord.contentHash = record.contentHash;
+            fileRecord.cookedKey = record.cookedKey;
+            fileRecord.path = addString(record.path);
+            fileRecord.type = static_cast<uint32_t>(record.type);
+            fileRecord.firstDependency = static_cast<uint32_t>(fileDependencies.size());
+            fileRecord.dependencyCount = static_cast<uint32_t>(record.dependencies.size());
+            fileRecord.firstOutput = static_cast<uint32_t>(fileOutputs.size());
+            fileRecord.outputCount = static_cast<uint32_t>(record.outputs.size());
+
+            for (const AssetDependency& dependency : record.dependencies)
+            {
+                AssetFileDependency fileDependency;
+                memset(&fileDependency, 0, sizeof(fileDependency));
+                fileDependency.reference = addString(dependency.reference);
+                fileDependency.asset = dependency.asset;
+                fileDependencies.push_back(fileDependency);
+            }
+
+            fileOutputs.insert(fileOutputs.end(), record.outputs.begin(), record.outputs.end());
+            fileRecords.push_back(fileRecord);
+        }
+    }
+
+    AssetDatabaseHeader header;
+    header.magic = ASSET_DATABASE_MAGIC;
+    header.version = ASSET_DATABASE_VERSION;
+    header.recordCount = static_cast<uint32_t>(fileRecords.size());
+    header.dependencyCount = static_cast<uint32_t>(fileDependencies.size());
+    header.outputCount = static_cast<uint32_t>(fileOutputs.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+
+    std::string path = GetDatabasePath();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        LOG_DEBUG("AssetDatabase: could not open %s for writing", path.c_str());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(fileRecords.data()), fileRecords.size() * sizeof(AssetFileRecord));
+    file.write(reinterpret_cast<const char*>(fileDependencies.data()), fileDependencies.size() * sizeof(AssetFileDependency));
+    file.write(reinterpret_cast<const char*>(fileOutputs.data()), fileOutputs.size() * sizeof(uint64_t));
+    file.write(strings.data(), strings.size());
+
+    return static_cast<bool>(file);
+}
+
+bool AssetDatabase::IsCooked(const AssetRecord& record) const
+{
+    if (record.cookedKey == 0 || record.cookedKey != GetCookKey(record.type, record.contentHash))
+        return false;
+
+    if (record.type == AssetType::Texture)
+        return FileExists(TextureCooker::GetCookedPath(record.path, record.contentHash));
+
+    // A model whose texture was removed resolves its references again
+    for (const AssetDependency& dependency : record.dependencies)
+    {
+        if (dependency.asset != 0 && records.find(dependency.asset) == records.end())
+            return false;
+    }
+
+    for (uint64_t meshId : record.outputs)
+    {
+        if (!FileExists(SceneSerializer::GetMeshPath(meshId)))
+            return false;
+    }
+
+    return record.type == AssetType::Model;
+}
+
+AssetRefreshStats AssetDatabase::Refresh()
+{
+    AssetRefreshStats stats;
+    if (!IsOpen())
+        return stats;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::string> files;
+    VirtualFileSystem::ListFiles(directory, files);
+    stats.files = static_cast<unsigned int>(files.size());
+
+    // Known stamps first, only files whose stamp moved are read and hashed again
+    struct ScannedFile
+    {
+        AssetRecord record;
+        bool hashed = false;
+        bool ok = true;
+    };
+
+    std::vector<ScannedFile> scanned(files.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            uint64_t id = GetPathId(NormalizePath(files[i]));
+            auto found = records.find(id);
+            if (found != records.end())
+                scanned[i].record = found->second;
+
+            scanned[i].record.id = id;
+            scanned[i].record.path = files[i];
+            scanned[i].record.type = GetAssetType(files[i]);
+        }
+    }
+
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+    ThreadPool::GetInstance().ParallelFor(scanned.size(), [&](size_t begin, size_t end)
+    {
+        std::vector<unsigned char> bytes;
+        for (size_t i = begin; i < end; ++i)
+        {
+            AssetRecord& record = scanned[i].record;
+            std::string diskPath = directory + "\\" + record.path;
+
+            uint64_t stamp = vfs.GetStamp(diskPath);
+            if (stamp != 0 && stamp == record.stamp && record.contentHash != 0)
+                continue;
+
+            if (stamp == 0 || !vfs.ReadFile(diskPath, bytes))
+            {
+                scanned[i].ok = false;
+                continue;
+            }
+
+            record.stamp = stamp;
+            record.contentHash = HashContent(bytes.data(), bytes.size());
+            scanned[i].hashed = true;
+        }
+    });
+
+    // Hashes go in before cooking, the texture cooker names its output after them
+    std::vector<AssetRecord> cooking;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::unordered_map<uint64_t, AssetRecord> current;
+        current.reserve(scanned.size());
+        for (ScannedFile& file : scanned)
+        {
+            if (!file.ok)
+            {
+                stats.failed++;
+                continue;
+            }
+            if (file.hashed)
+                stats.hashed++;
+
+            current[file.record.id] = std::move(file.record);
+        }
+
+        for (const auto& entry : records)
+        {
+            if (current.find(entry.first) == current.end())
+                stats.removed++;
+        }
+        records.swap(current);
+
+        for (const auto& entry : records)
+        {
+            if (entry.second.type == AssetType::Unknown)
+                continue;
+
+            if (IsCooked(entry.second))
+                stats.upToDate++;
+            else
+                cooking.push_back(entry.second);
+        }
+    }
+
+    // One asset per task, models split their meshes over the pool again
+    std::vector<char> cooked(cooking.size(), 0);
+    ThreadPool::GetInstance().ParallelFor(cooking.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            AssetRecord& record = cooking[i];
+            std::string diskPath = directory + "\\" + record.path;
+
+            if (record.type == AssetType::Texture)
+            {
+                TextureData data;
+                cooked[i] = Texture::Prepare(diskPath, false, data) && data.error.empty();
+            }
+            else if (record.type == AssetType::Model)
+            {
+                const aiScene* scene = FileSystem::ImportScene(diskPath, IOPriority::Normal);
+                if (scene == nullptr)
+                    continue;
+
+                std::vector<Mesh> meshes;
+                FileSystem::ConvertMeshes(scene, meshes, nullptr);
+                WriteMeshes(meshes, record.outputs);
+                ResolveDependencies(record, scene);
+                aiReleaseImport(scene);
+                cooked[i] = 1;
+            }
+
+            if (cooked[i])
+                record.cookedKey = GetCookKey(record.type, record.contentHash);
+        }
+    }, 1);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < cooking.size(); ++i)
+        {
+            if (!cooked[i])
+            {
+                stats.failed++;
+                continue;
+            }
+
+            auto found = records.find(cooking[i].id);
+            if (found != records.end())
+                found->second = std::move(cooking[i]);
+            stats.cooked++;
+        }
+    }
+
+    stats.ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    lastRefresh = stats;
+
+    LOG_CONSOLE("Asset database: %u files, %u hashed, %u cooked, %u up to date, %u failed, %u removed (%.1f ms)",
+        stats.files, stats.hashed, stats.cooked, stats.upToDate, stats.failed, stats.removed, stats.ms);
+
+    Save();
+    return stats;
+}
+
+uint64_t AssetDatabase::GetContentHash(const std::string& path)
+{
+    std::string relative;
+    if (!ToRelative(path, relative))
+        return 0;
+
+    // A pack mounted over the folder has other stamps, so its entries never match
+    uint64_t stamp = VirtualFileSystem::GetInstance().GetStamp(path);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = records.find(GetPathId(relative));
+    if (found == records.end() || found->second.stamp != stamp)
+        return 0;
+
+    return found->second.contentHash;
+}
+
+bool AssetDatabase::GetCookedMeshes(const std::string& modelPath, uint64_t contentHash, std::vector<uint64_t>& meshIds)
+{
+    std::string relative;
+    if (!ToRelative(modelPath, relative))
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = records.find(GetPathId(relative));
+    if (found == records.end())
+        return false;
+
+    const AssetRecord& record = found->second;
+    if (record.contentHash != contentHash || !IsCooked(record))
+        return false;
+
+    meshIds = record.outputs;
+    return true;
+}
+
+void AssetDatabase::StoreModel(const std::string& modelPath, uint64_t contentHash, const aiScene* scene, const std::vector<Mesh>& meshes)
+{
+    std::string relative;
+    size_t prefixLength = 0;
+    if (!ToRelative(modelPath, relative, &prefixLength))
+        return;
+
+    // Only the loose file is tracked, a pack entry may hold other content under the same name
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+    std::string diskPath = directory + "\\" + modelPath.substr(prefixLength);
+    uint64_t stamp = vfs.GetStamp(diskPath);
+    if (stamp == 0 || stamp != vfs.GetStamp(modelPath))
+        return;
+
+    AssetRecord record;
+    record.id = GetPathId(relative);
+    record.path = modelPath.substr(prefixLength);
+    for (char& c : record.path)
+        c = (c == '\\') ? '/' : c;
+    record.type = AssetType::Model;
+    record.stamp = stamp;
+    record.contentHash = contentHash;
+
+    WriteMeshes(meshes, record.outputs);
+    ResolveDependencies(record, scene);
+    record.cookedKey = GetCookKey(record.type, contentHash);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    records[record.id] = std::move(record);
+}
+
+void AssetDatabase::ResolveDependencies(AssetRecord& record, const aiScene* scene)
+{
+    std::string normalizedPath = NormalizePath(record.path);
+    size_t lastSlash = normalizedPath.find_last_of('/');
+    std::string folder = lastSlash != std::string::npos ? normalizedPath.substr(0, lastSlash + 1) : "";
+
+    record.dependencies.clear();
+
+    for (unsigned int i = 0; i < scene->mNumMaterials; ++i)
+    {
+        aiMaterial* material = scene->mMaterials[i];
+        if (material->GetTextureCount(aiTextureType_DIFFUSE) == 0)
+            continue;
+
+        aiString texturePath;
+        material->GetTexture(aiTextureType_DIFFUSE, 0, &texturePath);
+
+        AssetDependency dependency;
+        dependency.reference = texturePath.C_Str();
+
+        bool known = false;
+        for (const AssetDependency& existing : record.dependencies)
+            known = known || existing.reference == dependency.reference;
+        if (known)
+            continue;
+
+        // Same guesses as the loader: next to the model, in its Textures folder, then the path as written
+        std::string reference = NormalizePath(dependency.reference);
+        size_t nameStart = reference.find_last_of('/');
+        std::string fileName = nameStart != std::string::npos ? reference.substr(nameStart + 1) : reference;
+
+        std::string candidates[3] = { folder + fileName, folder + "textures/" + fileName, reference };
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::string& candidate : candidates)
+        {
+            uint64_t id = GetPathId(candidate);
+            if (records.find(id) != records.end())
+            {
+                dependency.asset = id;
+                break;
+            }
+        }
+
+        record.dependencies.push_back(dependency);
+    }
+}
+
+void AssetDatabase::WriteMeshes(const std::vector<Mesh>& meshes, std::vector<uint64_t>& ids)
+{
+    ids.resize(meshes.size());
+
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        ids[i] = SceneSerializer::HashMesh(meshes[i]);
+
+        // Content addressed: a mesh another model or a scene already wrote is not written again
+        {
+            std::lock_guard<std::mutex> lock(meshMutex);
+            if (!writtenMeshes.insert(ids[i]).second)
+                continue;
+        }
+
+        std::string path = SceneSerializer::GetMeshPath(ids[i]);
+        if (FileExists(path))
+            continue;
+
+        if (!SceneSerializer::WriteMesh(meshes[i], path))
+        {
+            std::lock_guard<std::mutex> lock(meshMutex);
+            writtenMeshes.erase(ids[i]);
+        }
+    }
+}
+
+bool AssetDatabase::ResolveReference(const std::string& modelPath, const std::string& reference, std::string& resolvedPath)
+{
+    std::string relative;
+    size_t prefixLength = 0;
+    if (!ToRelative(modelPath, relative, &prefixLength))
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto model = records.find(GetPathId(relative));
+    if (model == records.end())
+        return false;
+
+    for (const AssetDependency& dependency : model->second.dependencies)
+    {
+        if (dependency.reference != reference)
+            continue;
+
+        auto texture = records.find(dependency.asset);
+        if (texture == records.end())
+            return false;
+
+        resolvedPath = modelPath.substr(0, prefixLength) + texture->second.path;
+        return true;
+    }
+
+    return false;
+}
+
+std::vector<std::string> AssetDatabase::GetDependents(const std::string& path)
+{
+    std::vector<std::string> dependents;
+
+    std::string relative;
+    if (!ToRelative(path, relative))
+        return dependents;
+
+    uint64_t id = GetPathId(relative);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : records)
+    {
+        for (const AssetDependency& dependency : entry.second.dependencies)
+        {
+            if (dependency.asset == id)
+            {
+                dependents.push_back(entry.second.path);
+                break;
+            }
+        }
+    }
+
+    return dependents;
+}
+
+unsigned int AssetDatabase::GetAssetCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<unsigned int>(records.size());
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <cstdint>
+
+struct aiScene;
+struct Mesh;
+
+enum class AssetType : uint32_t
+{
+    Unknown = 0,
+    Model,
+    Texture
+};
+
+// Texture a model references, resolved once when the model is cooked
+struct AssetDependency
+{
+    std::string reference;      // As written in the model file
+    uint64_t asset = 0;         // Id of the asset it resolved to, 0 if none
+};
+
+struct AssetRecord
+{
+    uint64_t id = 0;            // Hash of the relative path, stays the same when the file is edited
+    std::string path;           // Relative to the Assets folder, '/' separated
+    AssetType type = AssetType::Unknown;
+    uint64_t stamp = 0;         // Disk stamp contentHash was computed at
+    uint64_t contentHash = 0;
+    uint64_t cookedKey = 0;     // Content and import settings the Library output was made from, 0 if never cooked
+    std::vector<AssetDependency> dependencies;
+    std::vector<uint64_t> outputs;  // Models: Library mesh id of every aiMesh
+};
+
+// What the last Refresh had to do
+struct AssetRefreshStats
+{
+    unsigned int files = 0;
+    unsigned int hashed = 0;    // Stamp changed, so the file was read again
+    unsigned int cooked = 0;
+    unsigned int upToDate = 0;
+    unsigned int failed = 0;
+    unsigned int removed = 0;
+    float ms = 0.0f;
+};
+
+// Identity and cook state of every file in the Assets folder, kept in Library/AssetDatabase.adb.
+// Cooked output is keyed by a hash of the source content and the import settings, so touching
+// a file, moving it or referencing it from several models never cooks it twice.
+class AssetDatabase
+{
+public:
+    static AssetDatabase& GetInstance();
+
+    // Loads the saved records, paths are resolved against directory or mountPoint
+    bool Open(const std::string& directory, const std::string& mountPoint);
+    bool Save();
+
+    // Rescans the folder, hashes the files whose stamp changed and cooks on the worker pool
+    // only the assets whose content, settings or dependencies differ from the last cook
+    AssetRefreshStats Refresh();
+
+    static uint64_t HashContent(const void* data, size_t size);
+
+    // Content hash of a file in the Assets folder, 0 when unknown or changed since it was hashed.
+    // Thread safe.
+    uint64_t GetContentHash(const std::string& path);
+
+    // Library meshes of a model cooked from exactly this content, thread safe
+    bool GetCookedMeshes(const std::string& modelPath, uint64_t contentHash, std::vector<uint64_t>& meshIds);
+    // Writes freshly converted meshes to the Library and records the model's textures, thread safe
+    void StoreModel(const std::string& modelPath, uint64_t contentHash, const aiScene* scene, const std::vector<Mesh>& meshes);
+
+    // Path of the texture a model reference resolved to, in the same form as modelPath
+    bool ResolveReference(const std::string& modelPath, const std::string& reference, std::string& resolvedPath);
+    // Models referencing an asset
+    std::vector<std::string> GetDependents(const std::string& path);
+
+    unsigned int GetAssetCount();
+    const AssetRefreshStats& GetLastRefresh() const { return lastRefresh; }
+    bool IsOpen() const { return !directory.empty(); }
+
+private:
+    AssetDatabase() = default;
+
+    AssetDatabase(const AssetDatabase&) = delete;
+    AssetDatabase& operator=(const AssetDatabase&) = delete;
+
+    static AssetType GetAssetType(const std::string& path);
+    static uint64_t GetCookKey(AssetType type, uint64_t contentHash);
+    static std::string GetDatabasePath();
+
+    // Normalized path relative to the Assets folder, prefixLength is what precedes it in path
+    bool ToRelative(const std::string& path, std::string& relative, size_t* prefixLength = nullptr) const;
+    bool IsCooked(const AssetRecord& record) const;
+    // Resolves a model's texture references the way the loader guesses them, takes the lock
+    void ResolveDependencies(AssetRecord& record, const aiScene* scene);
+    // Writes each distinct mesh once, thread safe
+    void WriteMeshes(const std::vector<Mesh>& meshes, std::vector<uint64_t>& ids);
+
+    std::string directory;
+    std::string mountPoint;
+
+    std::unordered_map<uint64_t, AssetRecord> records;
+    std::mutex mutex;
+
+    std::unordered_set<uint64_t> writtenMeshes;
+    std::mutex meshMutex;
+
+    AssetRefreshStats lastRefresh;
+};
@@ -0,0 +1,136 @@
+#include "AssetWatcher.h"
+#define NOMINMAX
+#include <windows.h>
+#include <algorithm>
+#include "VirtualFileSystem.h"
+#include "RedrawScheduler.h"
+#include "Log.h"
+
+// Time without further notifications before the tree is rescanned
+#define WATCHER_SETTLE_MS 200
+
+AssetWatcher::~AssetWatcher()
+{
+    Stop();
+}
+
+bool AssetWatcher::Start(const std::string& watchDirectory)
+{
+    Stop();
+
+    HANDLE notification = FindFirstChangeNotificationA(watchDirectory.c_str(), TRUE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (notification == INVALID_HANDLE_VALUE)
+    {
+        LOG_DEBUG("WARNING: Could not watch %s", watchDirectory.c_str());
+        return false;
+    }
+
+    stopEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (stopEvent == NULL)
+    {
+        FindCloseChangeNotification(notification);
+        return false;
+    }
+
+    directory = watchDirectory;
+
+    // The first scan is only the baseline
+    stamps.clear();
+    Scan(false);
+
+    thread = std::thread(&AssetWatcher::WatchLoop, this, notification);
+
+    LOG_DEBUG("Watching %s for changes", directory.c_str());
+    return true;
+}
+
+void AssetWatcher::Stop()
+{
+    if (thread.joinable())
+    {
+        SetEvent(stopEvent);
+        thread.join();
+    }
+
+    if (stopEvent != nullptr)
+    {
+        CloseHandle(stopEvent);
+        stopEvent = nullptr;
+    }
+}
+
+std::vector<std::string> AssetWatcher::TakeChanges()
+{
+    std::vector<std::string> taken;
+    std::lock_guard<std::mutex> lock(changesMutex);
+    taken.swap(changes);
+    return taken;
+}
+
+void AssetWatcher::WatchLoop(void* notification)
+{
+    HANDLE handles[2] = { stopEvent, notification };
+
+    while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0 + 1)
+    {
+        // Keep absorbing notifications until the tree has been quiet for a while
+        do
+        {
+            if (!FindNextChangeNotification(notification))
+            {
+                FindCloseChangeNotification(notification);
+                return;
+            }
+        } while (WaitForMultipleObjects(2, handles, FALSE, WATCHER_SETTLE_MS) == WAIT_OBJECT_0 + 1);
+
+        if (WaitForSingleObject(stopEvent, 0) == WAIT_OBJECT_0)
+            break;
+
+        Scan(true);
+    }
+
+    FindCloseChangeNotification(notification);
+}
+
+void AssetWatcher::Scan(bool report)
+{
+    std::vector<std::string> files;
+    VirtualFileSystem::ListFiles(directory, files);
+
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+    std::vector<std::string> changed;
+    std::unordered_map<std::string, uint64_t> current;
+    current.reserve(files.size());
+
+    for (const std::string& file : files)
+    {
+        uint64_t stamp = vfs.GetStamp(directory + "\\" + file);
+        if (stamp == 0)
+            continue;
+
+        auto previous = stamps.find(file);
+        if (report && (previous == stamps.end() || previous->second != stamp))
+            changed.push_back(file);
+
+        current.emplace(file, stamp);
+    }
+
+    stamps.swap(current);
+
+    if (changed.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(changesMutex);
+        for (const std::string& file : changed)
+        {
+            if (std::find(changes.begin(), changes.end(), file) == changes.end())
+                changes.push_back(file);
+        }
+    }
+
+    // The editor may be asleep waiting for events
+    RedrawScheduler::GetInstance().RequestRedraw(RedrawReason::Import);
+    RedrawScheduler::GetInstance().Wake();
+}
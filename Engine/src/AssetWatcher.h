@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+
+// Watches a folder tree for files that changed on disk. A thread sleeps on a change
+// notification, waits for the writes to settle and then compares the file stamps against
+// the last scan, so an editor saving in several steps reports the file once.
+class AssetWatcher
+{
+public:
+    AssetWatcher() = default;
+    ~AssetWatcher();
+
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    bool Start(const std::string& directory);
+    void Stop();
+    bool IsWatching() const { return thread.joinable(); }
+    const std::string& GetDirectory() const { return directory; }
+
+    // Files created or modified since the last call, relative to the directory and '/' separated
+    std::vector<std::string> TakeChanges();
+
+private:
+    void WatchLoop(void* notification);
+    // Stamps every file and queues the ones that differ from the previous scan
+    void Scan(bool report);
+
+    std::string directory;
+    std::thread thread;
+    void* stopEvent = nullptr;
+
+    std::unordered_map<std::string, uint64_t> stamps;   // Watcher thread only
+
+    std::vector<std::string> changes;
+    std::mutex changesMutex;
+};
@@ -0,0 +1,117 @@
+#include "BindlessTextures.h"
+#include "Texture.h"
+#include "Log.h"
+#include <SDL3/SDL.h>
+#include <string>
+
+BindlessTextures& BindlessTextures::GetInstance()
+{
+    static BindlessTextures instance;
+    return instance;
+}
+
+void BindlessTextures::Init()
+{
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+    bool extensionFound = false;
+    for (GLint i = 0; i < extensionCount && !extensionFound; ++i)
+    {
+        std::string extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        extensionFound = extension == "GL_ARB_bindless_texture";
+    }
+
+    if (extensionFound)
+    {
+        getTextureHandle = reinterpret_cast<PFN_GetTextureHandle>(SDL_GL_GetProcAddress("glGetTextureHandleARB"));
+        makeHandleResident = reinterpret_cast<PFN_MakeTextureHandleResident>(SDL_GL_GetProcAddress("glMakeTextureHandleResidentARB"));
+        makeHandleNonResident = reinterpret_cast<PFN_MakeTextureHandleNonResident>(SDL_GL_GetProcAddress("glMakeTextureHandleNonResidentARB"));
+    }
+
+    supported = getTextureHandle != nullptr && makeHandleResident != nullptr && makeHandleNonResident != nullptr;
+
+    LOG_DEBUG("Bindless textures %s", supported ? "supported" : "not supported, materials are bound per draw");
+}
+
+void BindlessTextures::BeginFrame()
+{
+    frameIndices.clear();
+    frameHandles.clear();
+}
+
+unsigned int BindlessTextures::GetIndex(const Texture* texture)
+{
+    if (!supported || texture == nullptr || texture->GetID() == 0 || texture->IsUploading())
+        return NO_INDEX;
+
+    GLuint textureID = texture->GetID();
+
+    auto frameIt = frameIndices.find(textureID);
+    if (frameIt != frameIndices.end())
+        return frameIt->second;
+
+    auto it = handles.find(textureID);
+    if (it == handles.end())
+    {
+        GLuint64 handle = getTextureHandle(textureID);
+        if (handle == 0)
+            return NO_INDEX;
+
+        makeHandleResident(handle);
+        it = handles.emplace(textureID, handle).first;
+    }
+
+    unsigned int index = static_cast<unsigned int>(frameHandles.size());
+    frameHandles.push_back(it->second);
+    frameIndices.emplace(textureID, index);
+    return index;
+}
+
+void BindlessTextures::Upload()
+{
+    residentCount = static_cast<unsigned int>(handles.size());
+    frameTextureCount = static_cast<unsigned int>(frameHandles.size());
+
+    if (frameHandles.empty())
+        return;
+
+    if (buffer == 0)
+        glGenBuffers(1, &buffer);
+
+    // Orphaned every frame, the driver hands out fresh storage while the last frame is still read
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, frameHandles.size() * sizeof(GLuint64), frameHandles.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer);
+}
+
+void BindlessTextures::ReleaseTexture(GLuint textureID)
+{
+    auto it = handles.find(textureID);
+    if (it == handles.end())
+        return;
+
+    makeHandleNonResident(it->second);
+    handles.erase(it);
+    frameIndices.erase(textureID);
+}
+
+void BindlessTextures::Release()
+{
+    for (const auto& entry : handles)
+        makeHandleNonResident(entry.second);
+
+    handles.clear();
+    frameIndices.clear();
+    frameHandles.clear();
+    residentCount = 0;
+    frameTextureCount = 0;
+
+    if (buffer != 0)
+    {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+}
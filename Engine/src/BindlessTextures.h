@@ -0,0 +1,68 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+
+class Texture;
+
+// ARB_bindless_texture support. Textures drawn in a frame get a slot in a shader storage
+// buffer holding their resident handles, and each draw only sets the slot index, so
+// changing material needs no texture bind. glad is generated without the extension,
+// its entry points are loaded by hand.
+class BindlessTextures
+{
+public:
+    static const unsigned int NO_INDEX = 0xFFFFFFFFu;
+
+    static BindlessTextures& GetInstance();
+
+    // Needs a current GL context
+    void Init();
+    bool IsSupported() const { return supported; }
+    // The shaders using the handles could not be built, the renderer falls back to binding
+    void SetUnsupported() { supported = false; }
+
+    // Slot of the texture's handle in this frame's buffer, NO_INDEX when the texture cannot be
+    // used bindless yet: a handle freezes the texture's state, so textures still receiving
+    // levels from the TextureUploader are bound the usual way until they are complete.
+    void BeginFrame();
+    unsigned int GetIndex(const Texture* texture);
+    // Uploads the frame's handles and binds the buffer to binding point 0
+    void Upload();
+
+    // Must be called before deleting a texture object that may have a handle
+    void ReleaseTexture(GLuint textureID);
+    // Makes every handle non-resident and deletes the buffer, GL thread
+    void Release();
+
+    // Counts as of the last Upload, readable from the main thread while the render thread draws
+    unsigned int GetResidentCount() const { return residentCount.load(); }
+    unsigned int GetFrameTextureCount() const { return frameTextureCount.load(); }
+
+private:
+    BindlessTextures() = default;
+
+    BindlessTextures(const BindlessTextures&) = delete;
+    BindlessTextures& operator=(const BindlessTextures&) = delete;
+
+    typedef GLuint64 (APIENTRYP PFN_GetTextureHandle)(GLuint texture);
+    typedef void (APIENTRYP PFN_MakeTextureHandleResident)(GLuint64 handle);
+    typedef void (APIENTRYP PFN_MakeTextureHandleNonResident)(GLuint64 handle);
+
+    bool supported = false;
+    PFN_GetTextureHandle getTextureHandle = nullptr;
+    PFN_MakeTextureHandleResident makeHandleResident = nullptr;
+    PFN_MakeTextureHandleNonResident makeHandleNonResident = nullptr;
+
+    // Resident handle of every texture object used so far
+    std::unordered_map<GLuint, GLuint64> handles;
+
+    std::unordered_map<GLuint, unsigned int> frameIndices;
+    std::vector<GLuint64> frameHandles;
+    GLuint buffer = 0;
+
+    std::atomic<unsigned int> residentCount{ 0 };
+    std::atomic<unsigned int> frameTextureCount{ 0 };
+};
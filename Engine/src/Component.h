@@ -18,6 +18,7 @@ public:
 
     virtual void Enable() {};
     virtual void Update() {};
+    virtual void FixedUpdate() {};
     virtual void Disable() {};
     virtual void OnEditor() {};  
 
@@ -1,9 +1,12 @@
 ﻿#include "ComponentMaterial.h"
 #include "GameObject.h"
 #include "Texture.h"
+#include "TextureStreamer.h"
 #include <iostream>
 #include "Log.h"
 
+#define CHECKERBOARD_PATH "[Checkerboard Pattern]"
+
 ComponentMaterial::ComponentMaterial(GameObject* owner)
     : Component(owner, ComponentType::MATERIAL),
     texture(nullptr),
@@ -33,15 +36,20 @@ bool ComponentMaterial::LoadTexture(const std::string& path)
 {
     LOG_DEBUG("ComponentMaterial: Loading texture from %s", path.c_str());
 
-    auto newTexture = std::make_unique<Texture>();
+    TextureData data;
+    Texture::Prepare(path, TextureStreamer::GetInstance().IsEnabled(), data);
 
-    if (newTexture->LoadFromFile(path))
-    {
-        texture = std::move(newTexture);
-        texturePath = path;
+    return LoadTexture(data);
+}
 
-        originalTexturePath = path;
-        hasOriginalTexture = true;
+bool ComponentMaterial::LoadTexture(const TextureData& data)
+{
+    const std::string& path = data.requestedPath;
+    auto newTexture = std::make_shared<Texture>();
+
+    if (newTexture->Upload(data))
+    {
+        SetTexture(std::move(newTexture), path);
 
         LOG_DEBUG("ComponentMaterial: Texture loaded");
         LOG_CONSOLE("Texture loaded: %s", path.c_str());
@@ -57,16 +65,36 @@ bool ComponentMaterial::LoadTexture(const std::string& path)
     }
 }
 
-void ComponentMaterial::CreateCheckerboardTexture()
+void ComponentMaterial::SetTexture(std::shared_ptr<Texture> sharedTexture, const std::string& path)
 {
+    texture = std::move(sharedTexture);
+    texturePath = path;
 
-    LOG_DEBUG("ComponentMaterial: Checkerboard texture created");
+    originalTexturePath = path;
+    hasOriginalTexture = true;
+}
 
-    texture = std::make_unique<Texture>();
+bool ComponentMaterial::IsCheckerboard() const
+{
+    return texturePath == CHECKERBOARD_PATH;
+}
 
-    texture->CreateCheckerboard();
+void ComponentMaterial::CreateCheckerboardTexture()
+{
+    // Every material starts with it, one texture object serves them all
+    static std::weak_ptr<Texture> sharedCheckerboard;
+
+    texture = sharedCheckerboard.lock();
+    if (!texture)
+    {
+        texture = std::make_shared<Texture>();
+        texture->CreateCheckerboard();
+        sharedCheckerboard = texture;
+
+        LOG_DEBUG("ComponentMaterial: Checkerboard texture created");
+    }
 
-    texturePath = "[Checkerboard Pattern]";
+    texturePath = CHECKERBOARD_PATH;
 }
 
 void ComponentMaterial::Use()
@@ -103,11 +131,47 @@ int ComponentMaterial::GetTextureHeight() const
     return 0;
 }
 
+AlphaMode ComponentMaterial::GetAlphaMode() const
+{
+    if (texture)
+    {
+        return texture->GetAlphaMode();
+    }
+    return AlphaMode::Opaque;
+}
+
+const char* ComponentMaterial::GetTextureFormatName() const
+{
+    if (texture)
+    {
+        return TextureCooker::GetFormatName(texture->GetFormat());
+    }
+    return "None";
+}
+
+int ComponentMaterial::GetTextureMipCount() const
+{
+    if (texture)
+    {
+        return texture->GetMipCount();
+    }
+    return 0;
+}
+
+size_t ComponentMaterial::GetTextureMemory() const
+{
+    if (texture)
+    {
+        return texture->GetMemorySize();
+    }
+    return 0;
+}
+
 void ComponentMaterial::RestoreOriginalTexture()
 {
     if (hasOriginalTexture && !originalTexturePath.empty())
     {
-        auto newTexture = std::make_unique<Texture>();
+        auto newTexture = std::make_shared<Texture>();
 
         if (newTexture->LoadFromFile(originalTexturePath))
         {
@@ -5,6 +5,8 @@
 #include <memory>
 
 class Texture;
+struct TextureData;
+enum class AlphaMode;
 
 class ComponentMaterial : public Component {
 public:
@@ -15,11 +17,18 @@ public:
     void OnEditor() override;
 
     bool LoadTexture(const std::string& path);
+    // Uploads a texture prepared with Texture::Prepare (on a worker thread)
+    bool LoadTexture(const TextureData& data);
+    // Uses a texture already uploaded for other materials, path is the file it was loaded from
+    void SetTexture(std::shared_ptr<Texture> sharedTexture, const std::string& path);
+    const std::shared_ptr<Texture>& GetSharedTexture() const { return texture; }
+    bool IsCheckerboard() const;
     void CreateCheckerboardTexture();
 	void RestoreOriginalTexture(); // for module editor
     void Use();
     void Unbind();
     bool HasTexture() const { return texture != nullptr; }
+    Texture* GetTexture() const { return texture.get(); }
 	bool HasOriginalTexture() const { return hasOriginalTexture; } // for module editor
 
     const std::string& GetTexturePath() const { return texturePath; }
@@ -27,8 +36,16 @@ public:
     int GetTextureWidth() const;
     int GetTextureHeight() const;
 
+    // Opaque when there is no texture
+    AlphaMode GetAlphaMode() const;
+
+    // "BC1", "RGBA8"... and GPU bytes of the current texture (0 without one)
+    const char* GetTextureFormatName() const;
+    int GetTextureMipCount() const;
+    size_t GetTextureMemory() const;
+
 private:
-    std::unique_ptr<Texture> texture;
+    std::shared_ptr<Texture> texture;
     std::string texturePath;
 
     std::string originalTexturePath; 
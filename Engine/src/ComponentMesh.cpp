@@ -1,21 +1,25 @@
 #include "ComponentMesh.h"
 #include "GameObject.h"
 #include "Application.h"
+#include "Camera.h"
 #include <limits>
 #include <algorithm>  
+#include <cmath>
+
+// Projected height (fraction of the screen) below which LOD 1 is used, halved for every further level
+#define LOD_SCREEN_SIZE 0.5f
+
+// Relative band around each threshold that has to be crossed before switching
+#define LOD_HYSTERESIS 0.1f
 
 ComponentMesh::ComponentMesh(GameObject* owner)
     : Component(owner, ComponentType::MESH),
-    aabbMin(0.0f), aabbMax(0.0f)
+    localAABB(glm::vec3(0.0f), glm::vec3(0.0f))
 {
 }
 
 ComponentMesh::~ComponentMesh()
 {
-    if (HasMesh())
-    {
-        Application::GetInstance().renderer->UnloadMesh(mesh);
-    }
 }
 
 void ComponentMesh::Update()
@@ -28,54 +32,88 @@ void ComponentMesh::OnEditor()
     // Reserved for ImGui editor interface
 }
 
-void ComponentMesh::SetMesh(const Mesh& meshData)
+const Mesh& ComponentMesh::GetMesh() const
 {
-    // Unload previous mesh if exists
-    if (HasMesh())
-    {
-        Application::GetInstance().renderer->UnloadMesh(mesh);
-    }
+    static const Mesh emptyMesh;
+    return mesh ? *mesh : emptyMesh;
+}
 
-    // Copy mesh data
-    mesh.vertices = meshData.vertices;
-    mesh.indices = meshData.indices;
-    mesh.textures = meshData.textures;
+std::shared_ptr<const Mesh> ComponentMesh::CreateShared(Mesh&& meshData)
+{
+    Mesh* uploaded = new Mesh(std::move(meshData));
 
     // Reset OpenGL handles (will be set by renderer)
-    mesh.VAO = 0;
-    mesh.VBO = 0;
-    mesh.EBO = 0;
-
-    // Calculate AABB
-    CalculateAABB();
+    uploaded->VAO = 0;
+    uploaded->VBO = 0;
+    uploaded->EBO = 0;
 
     // Upload to GPU
-    Application::GetInstance().renderer->LoadMesh(mesh);
+    Application::GetInstance().renderer->LoadMesh(*uploaded);
+
+    return std::shared_ptr<const Mesh>(uploaded, [](Mesh* sharedMesh)
+    {
+        if (sharedMesh->IsValid() && Application::GetInstance().renderer)
+        {
+            Application::GetInstance().renderer->UnloadMesh(*sharedMesh);
+        }
+        delete sharedMesh;
+    });
+}
+
+void ComponentMesh::SetMesh(const Mesh& meshData)
+{
+    Mesh copy = meshData;
+    SetMesh(std::move(copy));
 }
 
-void ComponentMesh::CalculateAABB()
+void ComponentMesh::SetMesh(Mesh&& meshData)
 {
-    // If the mesh has no vertices, set the AABB to zero
-    if (mesh.vertices.empty())
+    std::shared_ptr<const Mesh> uploaded = CreateShared(std::move(meshData));
+
+    // Zero-sized box if the mesh has no vertices, otherwise the SIMD min/max kernel
+    AABB bounds = ComputeVertexBounds(uploaded->vertices.data(), uploaded->vertices.size());
+
+    SetSharedMesh(std::move(uploaded), bounds);
+}
+
+void ComponentMesh::SetSharedMesh(std::shared_ptr<const Mesh> sharedMesh, const AABB& bounds)
+{
+    // The previous mesh is unloaded by its owner when no one else uses it
+    mesh = std::move(sharedMesh);
+    localAABB = bounds;
+    currentLOD = 0;
+
+    // New bounds for the scene's spatial index
+    Application::GetInstance().scene->MarkSpatialDirty(owner);
+}
+
+unsigned int ComponentMesh::UpdateLOD(const glm::mat4& modelMatrix, const Camera& camera)
+{
+    unsigned int lodCount = mesh ? mesh->GetLODCount() : 1;
+    if (lodCount == 1)
     {
-        aabbMin = glm::vec3(0.0f);
-        aabbMax = glm::vec3(0.0f);
-        return;
+        currentLOD = 0;
+        return currentLOD;
     }
 
-    // Initialize min and max with the first vertex position
-    aabbMin = mesh.vertices[0].position;
-    aabbMax = mesh.vertices[0].position;
+    // Bounding sphere of the world space box against the vertical view extent at its distance
+    AABB worldAABB = localAABB.Transformed(modelMatrix);
+    float radius = glm::length(worldAABB.GetExtents());
+    float distance = glm::length(worldAABB.GetCenter() - camera.GetPosition());
+    float halfViewHeight = distance * std::tan(glm::radians(camera.GetFov()) * 0.5f);
 
-    // Iterate through all vertices to find the minimum and maximum coordinates
-    for (const auto& vertex : mesh.vertices)
-    {
-        aabbMin.x = std::min(aabbMin.x, vertex.position.x);
-        aabbMin.y = std::min(aabbMin.y, vertex.position.y);
-        aabbMin.z = std::min(aabbMin.z, vertex.position.z);
+    float screenSize = (distance > radius && halfViewHeight > 0.0f) ? radius / halfViewHeight : 1.0f;
 
-        aabbMax.x = std::max(aabbMax.x, vertex.position.x);
-        aabbMax.y = std::max(aabbMax.y, vertex.position.y);
-        aabbMax.z = std::max(aabbMax.z, vertex.position.z);
-    }
+    auto threshold = [](unsigned int level) { return LOD_SCREEN_SIZE * std::pow(0.5f, static_cast<float>(level - 1)); };
+
+    unsigned int lod = std::min(currentLOD, lodCount - 1);
+
+    while (lod + 1 < lodCount && screenSize < threshold(lod + 1) * (1.0f - LOD_HYSTERESIS))
+        ++lod;
+
+    while (lod > 0 && screenSize > threshold(lod) * (1.0f + LOD_HYSTERESIS))
+        --lod;
+
+    currentLOD = lod;
+    return currentLOD;
 }
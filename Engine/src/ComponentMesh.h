@@ -2,7 +2,11 @@
 
 #include "Component.h"
 #include "FileSystem.h" 
+#include "AABB.h"
 #include <glm/glm.hpp>
+#include <memory>
+
+class Camera;
 
 class ComponentMesh : public Component {
 public:
@@ -16,31 +20,55 @@ public:
 
     // Set mesh data and upload it to GPU
     void SetMesh(const Mesh& meshData);
+    void SetMesh(Mesh&& meshData);
+
+    // Uploads a mesh that several components can share. Its GPU buffers are
+    // freed when the last component (or cache) holding it lets it go.
+    static std::shared_ptr<const Mesh> CreateShared(Mesh&& meshData);
+    // Uses an already uploaded mesh, bounds are its local AABB
+    void SetSharedMesh(std::shared_ptr<const Mesh> sharedMesh, const AABB& bounds);
+    const std::shared_ptr<const Mesh>& GetSharedMesh() const { return mesh; }
+
+    // Model file and mesh index the data came from, used to re-import it when the file changes
+    void SetSource(const std::string& path, unsigned int meshIndex) { sourcePath = path; sourceIndex = meshIndex; }
+    const std::string& GetSourcePath() const { return sourcePath; }
+    unsigned int GetSourceIndex() const { return sourceIndex; }
 
-    // Accessors for mesh
-    const Mesh& GetMesh() const { return mesh; }
-    Mesh& GetMesh() { return mesh; }
+    // Accessors for mesh (an empty mesh when none is set)
+    const Mesh& GetMesh() const;
 
     // Validation
-    bool HasMesh() const { return mesh.IsValid(); }
+    bool HasMesh() const { return mesh && mesh->IsValid(); }
 
     // Mesh statistics
-    unsigned int GetNumVertices() const { return static_cast<unsigned int>(mesh.vertices.size()); }
-    unsigned int GetNumIndices() const { return static_cast<unsigned int>(mesh.indices.size()); }
+    unsigned int GetNumVertices() const { return mesh ? static_cast<unsigned int>(mesh->vertices.size()) : 0; }
+    unsigned int GetNumIndices() const { return mesh ? static_cast<unsigned int>(mesh->indices.size()) : 0; }
     unsigned int GetNumTriangles() const { return GetNumIndices() / 3; }
-    unsigned int GetNumTextures() const { return static_cast<unsigned int>(mesh.textures.size()); }
+    unsigned int GetNumTextures() const { return mesh ? static_cast<unsigned int>(mesh->textures.size()) : 0; }
 
     // Axis-Aligned Bounding Box (AABB) accessors
-    glm::vec3 GetAABBMin() const { return aabbMin; }
-    glm::vec3 GetAABBMax() const { return aabbMax; }
+    glm::vec3 GetAABBMin() const { return localAABB.min; }
+    glm::vec3 GetAABBMax() const { return localAABB.max; }
+    const AABB& GetLocalAABB() const { return localAABB; }
+
+    // Level of detail, picked from the projected size of the bounds with some
+    // hysteresis so a mesh sitting on a threshold does not flicker between levels
+    unsigned int UpdateLOD(const glm::mat4& modelMatrix, const Camera& camera);
+    unsigned int GetCurrentLOD() const { return currentLOD; }
+
+    // Frame stamp written by the renderer's frustum query
+    void SetVisibleFrame(unsigned int frame) { visibleFrame = frame; }
+    bool IsVisibleInFrame(unsigned int frame) const { return visibleFrame == frame; }
 
 private:
-    Mesh mesh;                 // Mesh data
+    std::shared_ptr<const Mesh> mesh;   // Mesh data, possibly shared with other components
 
     // Local space bounding box
-    glm::vec3 aabbMin;
-    glm::vec3 aabbMax;
+    AABB localAABB;
+
+    std::string sourcePath;             // Empty for primitives
+    unsigned int sourceIndex = 0;
 
-    // Calculate the AABB from mesh vertices
-    void CalculateAABB();
+    unsigned int currentLOD = 0;
+    unsigned int visibleFrame = 0;
 };
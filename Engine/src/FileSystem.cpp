@@ -6,11 +6,52 @@
 #include <windows.h>
 #include <algorithm>
 #include <limits>
+#include <unordered_map>
+#include <chrono>
 #include "Application.h"
 #include "GameObject.h"
 #include "Transform.h"
 #include "ComponentMesh.h"
 #include "ComponentMaterial.h"
+#include "Texture.h"
+#include "TextureStreamer.h"
+#include "ThreadPool.h"
+#include "VirtualFileSystem.h"
+#include "AssetDatabase.h"
+#include "SceneSerializer.h"
+#include "RedrawScheduler.h"
+#include "AABB.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+#define ASSETS_MOUNT_POINT "Assets"
+#define ASSETS_PACK_FILE "Assets.pack"
+
+struct FileSystem::ReloadedModel
+{
+    std::vector<Mesh> meshes;
+    std::vector<AABB> bounds;
+    bool ok = false;
+};
+
+// Lowercase with '/' separators, so paths stored by different loaders compare equal
+static std::string NormalizeAssetPath(const std::string& path)
+{
+    std::string normalized = path;
+    for (char& c : normalized)
+        c = (c == '\\') ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return normalized;
+}
+
+static void CollectComponents(GameObject* obj, ComponentType type, std::vector<Component*>& components)
+{
+    Component* component = obj->GetComponent(type);
+    if (component != nullptr)
+        components.push_back(component);
+
+    for (GameObject* child : obj->GetChildren())
+        CollectComponents(child, type, components);
+}
 
 FileSystem::FileSystem() : Module() {}
 FileSystem::~FileSystem() {}
@@ -25,40 +66,30 @@ bool FileSystem::Start()
     LOG_DEBUG("Initializing FileSystem module");
     LOG_CONSOLE("FileSystem initialized");
 
-    // Get executable directory
-    char buffer[MAX_PATH];
-    GetModuleFileNameA(NULL, buffer, MAX_PATH);
-    std::string execPath(buffer);
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+    std::string execDir = VirtualFileSystem::GetExecutableDirectory();
 
-    size_t pos = execPath.find_last_of("\\/");
-    std::string currentDir = execPath.substr(0, pos);
+    // Search for the Assets folder, up to 5 levels above the executable
+    assetsDirectory = VirtualFileSystem::FindDirectoryUpwards(execDir, "Assets", 5);
+    if (!assetsDirectory.empty() && vfs.MountDirectory(assetsDirectory, ASSETS_MOUNT_POINT))
+    {
+        LOG_DEBUG("Assets folder found at: %s", assetsDirectory.c_str());
+    }
 
-    // Search for the Assets folder by uploading directories
-    std::string assetsPath;
-    std::string searchDir = currentDir;
-    bool assetsFound = false;
+    if (!assetsDirectory.empty())
+    {
+        AssetDatabase::GetInstance().Open(assetsDirectory, ASSETS_MOUNT_POINT);
+    }
 
-    // Try up to 5 levels up
-    for (int i = 0; i < 5 && !assetsFound; i++)
+    if (!assetsDirectory.empty() && watcher.Start(assetsDirectory))
     {
-        std::string testPath = searchDir + "\\Assets";
+        LOG_CONSOLE("Hot reload: watching %s", assetsDirectory.c_str());
+    }
 
-        // Verificar si existe el directorio Assets
-        DWORD attribs = GetFileAttributesA(testPath.c_str());
-        if (attribs != INVALID_FILE_ATTRIBUTES && (attribs & FILE_ATTRIBUTE_DIRECTORY))
-        {
-            assetsPath = testPath;
-            assetsFound = true;
-            LOG_DEBUG("Assets folder found at: %s", assetsPath.c_str());
-            break;
-        }
+    // A pack next to the executable is mounted last, so it wins over the loose files
+    bool packMounted = vfs.MountPack(execDir + "\\" + ASSETS_PACK_FILE, ASSETS_MOUNT_POINT);
 
-        // Move up a level
-        pos = searchDir.find_last_of("\\/");
-        if (pos == std::string::npos)
-            break;
-        searchDir = searchDir.substr(0, pos);
-    }
+    bool assetsFound = !assetsDirectory.empty() || packMounted;
 
     if (!assetsFound)
     {
@@ -78,7 +109,7 @@ bool FileSystem::Start()
         return true;
     }
 
-    std::string housePath = assetsPath + "\\BakerHouse.fbx";
+    std::string housePath = std::string(ASSETS_MOUNT_POINT) + "/BakerHouse.fbx";
 
     LOG_DEBUG("Attempting to load default model: %s", housePath.c_str());
     LOG_CONSOLE("Loading default scene...");
@@ -113,70 +144,308 @@ bool FileSystem::Start()
 }
 bool FileSystem::Update()
 {
-    if (Application::GetInstance().input->HasDroppedFile())
+    // A multi-file drop arrives as one event per file, all of them are handled
+    InputEvent event;
+    while (Application::GetInstance().input->PollEvent(event))
+    {
+        if (event.type == INPUT_DROP_FILE)
+        {
+            ++droppedFileCount;
+            HandleDroppedFile(event.path, event.fileType);
+        }
+        else if (event.type == INPUT_DROP_COMPLETE)
+        {
+            if (droppedFileCount > 1)
+                LOG_CONSOLE("%d dropped files processed", droppedFileCount);
+            droppedFileCount = 0;
+        }
+    }
+
+    for (const std::string& relativePath : watcher.TakeChanges())
     {
-        std::string filePath = Application::GetInstance().input->GetDroppedFilePath();
-        DroppedFileType fileType = Application::GetInstance().input->GetDroppedFileType();
-        Application::GetInstance().input->ClearDroppedFile();
+        QueueReload(relativePath);
+    }
+    ApplyReloads();
+
+    // Keep polling until the re-imports are swapped in
+    if (GetPendingReloads() > 0)
+    {
+        RedrawScheduler::GetInstance().RequestRedraw(RedrawReason::Import);
+    }
 
-        if (fileType == DROPPED_FBX)
+    return true;
+}
+
+void FileSystem::HandleDroppedFile(const std::string& filePath, DroppedFileType fileType)
+{
+    if (fileType == DROPPED_FBX)
+    {
+        LOG_DEBUG("Dropped FBX file detected: %s", filePath.c_str());
+        LOG_CONSOLE("Loading dropped model...");
+
+        GameObject* loadedModel = LoadFBXAsGameObject(filePath);
+        if (loadedModel != nullptr)
         {
-            LOG_DEBUG("Dropped FBX file detected: %s", filePath.c_str());
-            LOG_CONSOLE("Loading dropped model...");
+            GameObject* root = Application::GetInstance().scene->GetRoot();
+            root->AddChild(loadedModel);
 
-            GameObject* loadedModel = LoadFBXAsGameObject(filePath);
-            if (loadedModel != nullptr)
-            {
-                GameObject* root = Application::GetInstance().scene->GetRoot();
-                root->AddChild(loadedModel);
+            LOG_DEBUG("Model loaded successfully");
+            LOG_DEBUG("   Root GameObject: %s", loadedModel->GetName().c_str());
+            LOG_DEBUG("   Children: %d", loadedModel->GetChildren().size());
+            LOG_CONSOLE("Model loaded successfully: %s", loadedModel->GetName().c_str());
+        }
+        else
+        {
+            LOG_DEBUG("ERROR: Failed to load dropped FBX file");
+            LOG_CONSOLE("Failed to load model");
+        }
+    }
+    else if (fileType == DROPPED_TEXTURE)
+    {
+        LOG_DEBUG("Dropped texture file detected: %s", filePath.c_str());
+        // Get all selected objects in the editor
+        std::vector<GameObject*> selectedObjects =
+            Application::GetInstance().selectionManager->GetSelectedObjects();
+
+        if (!selectedObjects.empty())
+        {
+            // Read and decode once, every selected object gets its own upload of the same data
+            TextureData texture;
+            Texture::Prepare(filePath, TextureStreamer::GetInstance().IsEnabled(), texture);
 
-                LOG_DEBUG("Model loaded successfully");
-                LOG_DEBUG("   Root GameObject: %s", loadedModel->GetName().c_str());
-                LOG_DEBUG("   Children: %d", loadedModel->GetChildren().size());
-                LOG_CONSOLE("Model loaded successfully: %s", loadedModel->GetName().c_str());
+            // Apply the texture to all selected objects
+            int successCount = 0;
+            for (GameObject* obj : selectedObjects)
+            {
+                if (ApplyTextureToGameObject(obj, texture))
+                {
+                    successCount++;
+                }
             }
-            else
+
+            LOG_DEBUG( "✓ Texture applied to %d of %zu selected objects",
+                successCount, selectedObjects.size());
+        }
+        else
+        {
+            // Fallback behavior: load the texture globally if no objects are selected
+            LOG_CONSOLE("Loading texture...");
+            Application::GetInstance().renderer->LoadTexture(filePath);
+        }
+    }
+    else if (fileType == DROPPED_SCENE)
+    {
+        LOG_DEBUG("Dropped scene file detected: %s", filePath.c_str());
+        LOG_CONSOLE("Loading scene...");
+        Application::GetInstance().scene->LoadScene(filePath);
+    }
+}
+
+bool FileSystem::IsAssetPath(const std::string& path, const std::string& relativePath) const
+{
+    std::string normalized = NormalizeAssetPath(path);
+    std::string relative = NormalizeAssetPath(relativePath);
+
+    if (normalized == NormalizeAssetPath(ASSETS_MOUNT_POINT) + "/" + relative)
+        return true;
+
+    return !assetsDirectory.empty() && normalized == NormalizeAssetPath(assetsDirectory) + "/" + relative;
+}
+
+void FileSystem::QueueReload(const std::string& relativePath)
+{
+    GameObject* root = Application::GetInstance().scene->GetRoot();
+
+    // Read the loose file, a mounted pack would still serve the old contents under Assets/
+    std::string diskPath = assetsDirectory + "\\" + relativePath;
+
+    size_t extensionStart = relativePath.find_last_of('.');
+    std::string extension = extensionStart != std::string::npos ? NormalizeAssetPath(relativePath.substr(extensionStart + 1)) : "";
+
+    if (extension == "fbx")
+    {
+        std::vector<Component*> meshComponents;
+        CollectComponents(root, ComponentType::MESH, meshComponents);
+
+        bool used = std::any_of(meshComponents.begin(), meshComponents.end(), [&](Component* component)
+        {
+            return IsAssetPath(static_cast<ComponentMesh*>(component)->GetSourcePath(), relativePath);
+        });
+        if (!used)
+            return;
+
+        LOG_CONSOLE("Hot reload: re-importing %s", relativePath.c_str());
+
+        MeshReload reload;
+        reload.sourcePath = relativePath;
+        reload.result = ThreadPool::GetInstance().Submit([diskPath]()
+        {
+            auto model = std::make_shared<ReloadedModel>();
+            const aiScene* scene = ImportScene(diskPath, IOPriority::Normal);
+            if (scene == nullptr)
+                return model;
+
+            ConvertMeshes(scene, model->meshes, nullptr);
+            aiReleaseImport(scene);
+
+            model->bounds.resize(model->meshes.size());
+            for (size_t i = 0; i < model->meshes.size(); ++i)
             {
-                LOG_DEBUG("ERROR: Failed to load dropped FBX file");
-                LOG_CONSOLE("Failed to load model");
+                model->bounds[i] = ComputeVertexBounds(model->meshes[i].vertices.data(), model->meshes[i].vertices.size());
             }
+            model->ok = true;
+            return model;
+        });
+        meshReloads.push_back(std::move(reload));
+        return;
+    }
+
+    // Anything else is treated as a texture, if some material uses it
+    std::vector<Component*> materials;
+    CollectComponents(root, ComponentType::MATERIAL, materials);
+
+    bool used = std::any_of(materials.begin(), materials.end(), [&](Component* component)
+    {
+        return IsAssetPath(static_cast<ComponentMaterial*>(component)->GetTexturePath(), relativePath);
+    });
+    if (!used)
+        return;
+
+    LOG_CONSOLE("Hot reload: re-cooking %s", relativePath.c_str());
+
+    // The stamp changed, so Prepare cooks the file again instead of reusing the Library copy
+    bool streaming = TextureStreamer::GetInstance().IsEnabled();
+    TextureReload reload;
+    reload.relativePath = relativePath;
+    reload.result = ThreadPool::GetInstance().Submit([diskPath, streaming]()
+    {
+        auto data = std::make_shared<TextureData>();
+        Texture::Prepare(diskPath, streaming, *data);
+        return data;
+    });
+    textureReloads.push_back(std::move(reload));
+}
+
+void FileSystem::ApplyReloads()
+{
+    if (meshReloads.empty() && textureReloads.empty())
+        return;
+
+    GameObject* root = Application::GetInstance().scene->GetRoot();
+
+    for (auto it = textureReloads.begin(); it != textureReloads.end();)
+    {
+        if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        std::shared_ptr<TextureData> data = it->result.get();
+        auto texture = std::make_shared<Texture>();
+
+        if (!data->error.empty() || !texture->Upload(*data))
+        {
+            LOG_CONSOLE("Hot reload: could not reload %s (%s)", it->relativePath.c_str(), data->error.c_str());
         }
-        else if (fileType == DROPPED_TEXTURE)
+        else
         {
-            LOG_DEBUG("Dropped texture file detected: %s", filePath.c_str());
-            // Get all selected objects in the editor
-            std::vector<GameObject*> selectedObjects =
-                Application::GetInstance().selectionManager->GetSelectedObjects();
+            // One texture for every material using the file, each keeps the path it had
+            std::vector<Component*> materials;
+            CollectComponents(root, ComponentType::MATERIAL, materials);
 
-            if (!selectedObjects.empty())
+            int count = 0;
+            for (Component* component : materials)
             {
-                // Apply the texture to all selected objects
-                int successCount = 0;
-                for (GameObject* obj : selectedObjects)
-                {
-                    if (ApplyTextureToGameObject(obj, filePath))
-                    {
-                        successCount++;
-                    }
-                }
+                ComponentMaterial* material = static_cast<ComponentMaterial*>(component);
+                if (!IsAssetPath(material->GetTexturePath(), it->relativePath))
+                    continue;
 
-                LOG_DEBUG( "✓ Texture applied to %d of %zu selected objects",
-                    successCount, selectedObjects.size());
+                std::string path = material->GetTexturePath();
+                material->SetTexture(texture, path);
+                count++;
             }
-            else
+
+            LOG_CONSOLE("Hot reload: %s updated on %d materials", it->relativePath.c_str(), count);
+        }
+
+        it = textureReloads.erase(it);
+    }
+
+    for (auto it = meshReloads.begin(); it != meshReloads.end();)
+    {
+        if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        std::shared_ptr<ReloadedModel> model = it->result.get();
+
+        if (!model->ok)
+        {
+            LOG_CONSOLE("Hot reload: could not re-import %s", it->sourcePath.c_str());
+        }
+        else
+        {
+            // Uploaded on first use, components sharing a mesh keep sharing the new one
+            std::vector<std::shared_ptr<const Mesh>> uploaded(model->meshes.size());
+            std::vector<Component*> meshComponents;
+            CollectComponents(root, ComponentType::MESH, meshComponents);
+
+            int count = 0;
+            for (Component* component : meshComponents)
             {
-                // Fallback behavior: load the texture globally if no objects are selected
-                LOG_CONSOLE("Loading texture...");
-                Application::GetInstance().renderer->LoadTexture(filePath);
+                ComponentMesh* meshComponent = static_cast<ComponentMesh*>(component);
+                unsigned int index = meshComponent->GetSourceIndex();
+                if (!IsAssetPath(meshComponent->GetSourcePath(), it->sourcePath) || index >= model->meshes.size())
+                    continue;
+
+                if (!uploaded[index])
+                    uploaded[index] = ComponentMesh::CreateShared(std::move(model->meshes[index]));
+
+                meshComponent->SetSharedMesh(uploaded[index], model->bounds[index]);
+                count++;
             }
+
+            LOG_CONSOLE("Hot reload: %s updated on %d meshes", it->sourcePath.c_str(), count);
         }
+
+        it = meshReloads.erase(it);
     }
+}
 
-    return true;
+bool FileSystem::BuildAssetsPack()
+{
+    if (assetsDirectory.empty())
+    {
+        LOG_CONSOLE("ERROR: No Assets folder to pack");
+        return false;
+    }
+
+    // The mounted pack is mapped, it has to go before the file can be rewritten
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+    std::string packPath = VirtualFileSystem::GetExecutableDirectory() + "\\" + ASSETS_PACK_FILE;
+    vfs.Unmount(packPath);
+
+    if (!VirtualFileSystem::BuildPack(assetsDirectory, packPath))
+    {
+        LOG_CONSOLE("ERROR: Failed to build %s", packPath.c_str());
+        return false;
+    }
+
+    return vfs.MountPack(packPath, ASSETS_MOUNT_POINT);
 }
 
 bool FileSystem::CleanUp()
 {
+    watcher.Stop();
+    AssetDatabase::GetInstance().Save();
+
+    // Re-imports still running only hold their own data, their results are dropped
+    meshReloads.clear();
+    textureReloads.clear();
+
     aiDetachAllLogStreams();
     LOG_CONSOLE("FileSystem cleaned up");
     return true;
@@ -188,17 +457,17 @@ GameObject* FileSystem::LoadFBXAsGameObject(const std::string& file_path)
     LOG_DEBUG("File: %s", file_path.c_str());
     LOG_CONSOLE("Loading model with ASSIMP...");
 
-    unsigned int importFlags =
-        aiProcess_Triangulate |
-        aiProcess_GenNormals |
-        aiProcess_FlipUVs |
-        aiProcess_JoinIdenticalVertices |
-        aiProcess_OptimizeMeshes |
-        aiProcess_ValidateDataStructure;
-        
     LOG_DEBUG("ASSIMP import flags: TargetRealtime_MaxQuality | ConvertToLeftHanded");
 
-    const aiScene* scene = aiImportFile(file_path.c_str(), importFlags);
+    if (!VirtualFileSystem::GetInstance().Exists(file_path))
+    {
+        LOG_DEBUG("ERROR: Could not read %s", file_path.c_str());
+        LOG_CONSOLE("ERROR: Failed to load model - file not found");
+        return nullptr;
+    }
+
+    uint64_t contentHash = 0;
+    const aiScene* scene = ImportScene(file_path, IOPriority::Urgent, &contentHash);
 
     if (scene == nullptr)
     {
@@ -223,14 +492,73 @@ GameObject* FileSystem::LoadFBXAsGameObject(const std::string& file_path)
     LOG_DEBUG("  Materials: %d", scene->mNumMaterials);
     LOG_CONSOLE("ASSIMP: Found %d meshes, %d materials", scene->mNumMeshes, scene->mNumMaterials);
 
-    GameObject* rootObj = ProcessNode(scene->mRootNode, scene, directory);
+    // Hierarchy and GPU upload stay on the main thread
+    std::vector<Mesh> meshes;
+    std::vector<MeshOptimizationStats> optimizationStats;
+
+    // A model cooked from the same bytes and settings skips the conversion, optimization and LODs
+    AssetDatabase& assets = AssetDatabase::GetInstance();
+    std::vector<uint64_t> cookedMeshes;
+    if (assets.GetCookedMeshes(file_path, contentHash, cookedMeshes) && cookedMeshes.size() == scene->mNumMeshes &&
+        ReadCookedMeshes(cookedMeshes, meshes))
+    {
+        LOG_CONSOLE("ASSIMP: %d meshes read from the Library, already cooked", scene->mNumMeshes);
+    }
+    else
+    {
+        ConvertMeshes(scene, meshes, &optimizationStats);
+        assets.StoreModel(file_path, contentHash, scene, meshes);
+    }
+
+    // Totals are weighted by triangles (ACMR) and vertices (ATVR)
+    double acmrBefore = 0.0, acmrAfter = 0.0, atvrBefore = 0.0, atvrAfter = 0.0;
+    size_t totalTriangles = 0, totalVertices = 0;
 
-    glm::vec3 minBounds(std::numeric_limits<float>::max());
-    glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
-    glm::mat4 identity(1.0f);
-    CalculateBoundingBox(rootObj, minBounds, maxBounds, identity);
+    for (unsigned int i = 0; i < optimizationStats.size(); i++)
+    {
+        const Mesh& mesh = meshes[i];
+        const MeshOptimizationStats& stats = optimizationStats[i];
+        LOG_DEBUG("      Mesh processed: Vertices: %d, Indices: %d, Triangles: %d", mesh.vertices.size(), mesh.indices.size(), mesh.indices.size() / 3);
+        LOG_DEBUG("      Vertex cache: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f", stats.before.acmr, stats.after.acmr, stats.before.atvr, stats.after.atvr);
+        for (size_t lod = 0; lod < mesh.lods.size(); ++lod)
+        {
+            LOG_DEBUG("      LOD %d: %d triangles, error %.4f", lod + 1, mesh.lods[lod].indices.size() / 3, mesh.lods[lod].error);
+        }
+        LOG_CONSOLE("  Mesh processed: %d vertices, %d triangles", mesh.vertices.size(), mesh.indices.size() / 3);
+
+        acmrBefore += stats.before.acmr * stats.triangles;
+        acmrAfter += stats.after.acmr * stats.triangles;
+        atvrBefore += stats.before.atvr * stats.vertices;
+        atvrAfter += stats.after.atvr * stats.vertices;
+        totalTriangles += stats.triangles;
+        totalVertices += stats.vertices;
+    }
+
+    if (totalTriangles > 0 && totalVertices > 0)
+    {
+        LOG_CONSOLE("Mesh optimization: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+            acmrBefore / totalTriangles, acmrAfter / totalTriangles,
+            atvrBefore / totalVertices, atvrAfter / totalVertices);
+    }
+
+    // Nodes referencing the same aiMesh share one uploaded mesh
+    std::vector<std::shared_ptr<const Mesh>> sharedMeshes(scene->mNumMeshes);
+    std::vector<AABB> meshBounds(scene->mNumMeshes);
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+    {
+        meshBounds[i] = ComputeVertexBounds(meshes[i].vertices.data(), meshes[i].vertices.size());
+        sharedMeshes[i] = ComponentMesh::CreateShared(std::move(meshes[i]));
+    }
+
+    std::vector<PendingTexture> textures;
+    GameObject* rootObj = ProcessNode(scene->mRootNode, scene, file_path, directory, sharedMeshes, meshBounds, textures);
+    LoadTextures(textures);
+
+    // Bounds are computed once from the mesh AABBs and reused for the scale normalization
+    AABB bounds;
+    CalculateBoundingBox(rootObj, bounds);
 
-    glm::vec3 size = maxBounds - minBounds;
+    glm::vec3 size = bounds.GetSize();
     LOG_DEBUG("Model Dimensions: X=%.2f Y=%.2f Z=%.2f", size.x, size.y, size.z);
 
     //std::string fileName = file_path.substr(file_path.find_last_of("/\\") + 1);
@@ -267,7 +595,7 @@ GameObject* FileSystem::LoadFBXAsGameObject(const std::string& file_path)
     //}
 
     // Normalize scale
-    NormalizeModelScale(rootObj, 5.0f);
+    NormalizeModelScale(rootObj, bounds, 5.0f);
 
     aiReleaseImport(scene);
 
@@ -278,7 +606,140 @@ GameObject* FileSystem::LoadFBXAsGameObject(const std::string& file_path)
     return rootObj;
 }
 
-GameObject* FileSystem::ProcessNode(aiNode* node, const aiScene* scene, const std::string& directory)
+unsigned int FileSystem::GetImportFlags()
+{
+    return aiProcess_Triangulate |
+        aiProcess_GenNormals |
+        aiProcess_FlipUVs |
+        aiProcess_JoinIdenticalVertices |
+        aiProcess_OptimizeMeshes |
+        aiProcess_ValidateDataStructure;
+}
+
+const aiScene* FileSystem::ImportScene(const std::string& path, IOPriority priority, uint64_t* contentHash)
+{
+    // Read through the VFS so models inside packs load too, Assimp parses from memory
+    std::vector<unsigned char> bytes;
+    if (!VirtualFileSystem::GetInstance().ReadFile(path, bytes, priority))
+        return nullptr;
+
+    if (contentHash != nullptr)
+        *contentHash = AssetDatabase::HashContent(bytes.data(), bytes.size());
+
+    size_t extensionStart = path.find_last_of('.');
+    std::string extension = extensionStart != std::string::npos ? path.substr(extensionStart + 1) : "";
+
+    return aiImportFileFromMemory(reinterpret_cast<const char*>(bytes.data()),
+        static_cast<unsigned int>(bytes.size()), GetImportFlags(), extension.c_str());
+}
+
+bool FileSystem::ReadCookedMeshes(const std::vector<uint64_t>& meshIds, std::vector<Mesh>& meshes)
+{
+    meshes.clear();
+    meshes.resize(meshIds.size());
+
+    std::vector<char> loaded(meshIds.size(), 0);
+    ThreadPool::GetInstance().ParallelFor(meshIds.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            loaded[i] = SceneSerializer::ReadMesh(SceneSerializer::GetMeshPath(meshIds[i]), meshes[i]);
+    }, 1);
+
+    return std::find(loaded.begin(), loaded.end(), 0) == loaded.end();
+}
+
+void FileSystem::ConvertMeshes(const aiScene* scene, std::vector<Mesh>& meshes, std::vector<MeshOptimizationStats>* stats)
+{
+    // Each mesh is reordered for the GPU caches and gets its LOD chain before it ever reaches the renderer
+    meshes.clear();
+    meshes.resize(scene->mNumMeshes);
+    if (stats != nullptr)
+    {
+        stats->clear();
+        stats->resize(scene->mNumMeshes);
+    }
+
+    ThreadPool::GetInstance().ParallelFor(scene->mNumMeshes, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            meshes[i] = ProcessMesh(scene->mMeshes[i], scene);
+            MeshOptimizer::Optimize(meshes[i], stats != nullptr ? &(*stats)[i] : nullptr);
+            MeshSimplifier::GenerateLODs(meshes[i]);
+        }
+    });
+}
+
+void FileSystem::LoadTextures(const std::vector<PendingTexture>& textures)
+{
+    if (textures.empty())
+        return;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Materials often share a texture, each distinct one is read and decoded once
+    std::vector<const std::vector<std::string>*> files;
+    std::vector<size_t> fileIndex(textures.size());
+    std::unordered_map<std::string, size_t> fileLookup;
+
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+        auto inserted = fileLookup.emplace(textures[i].candidates.front(), files.size());
+        if (inserted.second)
+            files.push_back(&textures[i].candidates);
+        fileIndex[i] = inserted.first->second;
+    }
+
+    // Everything up to the GL upload runs on the workers
+    bool streaming = TextureStreamer::GetInstance().IsEnabled();
+    std::vector<TextureData> prepared(files.size());
+    ThreadPool::GetInstance().ParallelFor(files.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (const std::string& path : *files[i])
+            {
+                if (Texture::Prepare(path, streaming, prepared[i]))
+                    break;
+            }
+        }
+    }, 1);
+
+    float prepareMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    LOG_CONSOLE("Textures: %zu files read and decoded in %.1f ms", files.size(), prepareMs);
+
+    // One texture object per file, shared by the materials using it
+    std::vector<std::shared_ptr<Texture>> uploaded(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (!prepared[i].error.empty())
+            continue;
+
+        auto texture = std::make_shared<Texture>();
+        if (texture->Upload(prepared[i]))
+            uploaded[i] = std::move(texture);
+    }
+
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+        const TextureData& data = prepared[fileIndex[i]];
+        const std::shared_ptr<Texture>& texture = uploaded[fileIndex[i]];
+
+        if (texture)
+        {
+            textures[i].material->SetTexture(texture, data.requestedPath);
+            LOG_DEBUG("      Texture loaded successfully from: %s", data.requestedPath.c_str());
+        }
+        else
+        {
+            LOG_DEBUG("      Texture '%s' not found, using checkerboard", textures[i].candidates.back().c_str());
+        }
+    }
+}
+
+GameObject* FileSystem::ProcessNode(aiNode* node, const aiScene* scene, const std::string& sourcePath,
+    const std::string& directory, const std::vector<std::shared_ptr<const Mesh>>& meshes,
+    const std::vector<AABB>& meshBounds, std::vector<PendingTexture>& textures)
 {
     std::string nodeName = node->mName.C_Str();
     if (nodeName.empty()) nodeName = "Unnamed";
@@ -308,10 +769,10 @@ GameObject* FileSystem::ProcessNode(aiNode* node, const aiScene* scene, const st
 
         LOG_DEBUG("  Processing mesh %d: %s", i, aiMesh->mName.C_Str());
 
-        Mesh mesh = ProcessMesh(aiMesh, scene);
-
         ComponentMesh* meshComponent = static_cast<ComponentMesh*>(gameObject->CreateComponent(ComponentType::MESH));
-        meshComponent->SetMesh(mesh);
+
+        meshComponent->SetSharedMesh(meshes[meshIndex], meshBounds[meshIndex]);
+        meshComponent->SetSource(sourcePath, meshIndex);
 
         // Load diffuse textures if available
         if (aiMesh->mMaterialIndex >= 0)
@@ -341,28 +802,24 @@ GameObject* FileSystem::ProcessNode(aiNode* node, const aiScene* scene, const st
                 else
                     fileName = textureFile;
 
-                std::vector<std::string> searchPaths = {
-                    directory + "\\" + fileName,
-                    directory + "\\Textures\\" + fileName,
-                    textureFile
-                };
+                PendingTexture pending;
+                pending.material = matComponent;
 
-                bool loaded = false;
-                for (const auto& path : searchPaths)
+                // The asset database resolved this reference when the model was cooked
+                std::string resolvedPath;
+                if (AssetDatabase::GetInstance().ResolveReference(sourcePath, textureFile, resolvedPath))
                 {
-                    LOG_DEBUG("      Trying texture at: %s", path.c_str());
-                    if (matComponent->LoadTexture(path))
-                    {
-                        LOG_DEBUG("      Texture loaded successfully from: %s", path.c_str());
-                        loaded = true;
-                        break;
-                    }
+                    pending.candidates = { resolvedPath };
                 }
-
-                if (!loaded)
+                else
                 {
-                    LOG_DEBUG("      Texture '%s' not found, using checkerboard", fileName.c_str());
+                    pending.candidates = {
+                        directory + "\\" + fileName,
+                        directory + "\\Textures\\" + fileName,
+                        textureFile
+                    };
                 }
+                textures.push_back(pending);
             }
         }
     }
@@ -370,7 +827,7 @@ GameObject* FileSystem::ProcessNode(aiNode* node, const aiScene* scene, const st
     // Recursively process child nodes
     for (unsigned int i = 0; i < node->mNumChildren; i++)
     {
-        GameObject* child = ProcessNode(node->mChildren[i], scene, directory);
+        GameObject* child = ProcessNode(node->mChildren[i], scene, sourcePath, directory, meshes, meshBounds, textures);
         if (child != nullptr)
         {
             gameObject->AddChild(child);
@@ -382,74 +839,100 @@ GameObject* FileSystem::ProcessNode(aiNode* node, const aiScene* scene, const st
 
 Mesh FileSystem::ProcessMesh(aiMesh* aiMesh, const aiScene* scene)
 {
+    // Runs on worker threads: no OpenGL calls here
     Mesh mesh;
 
-    mesh.vertices.reserve(aiMesh->mNumVertices);
-    mesh.indices.reserve(aiMesh->mNumFaces * 3);
+    const unsigned int numVertices = aiMesh->mNumVertices;
+    mesh.vertices.resize(numVertices);
+    Vertex* vertices = mesh.vertices.data();
 
-    // Vertices
-    for (unsigned int i = 0; i < aiMesh->mNumVertices; i++)
+    // Attribute presence is checked once per mesh, each loop is a plain strided copy
+    const aiVector3D* positions = aiMesh->mVertices;
+    for (unsigned int i = 0; i < numVertices; i++)
     {
-        Vertex vertex;
-
-        vertex.position = glm::vec3(
-            aiMesh->mVertices[i].x,
-            aiMesh->mVertices[i].y,
-            aiMesh->mVertices[i].z
-        );
+        vertices[i].position = glm::vec3(positions[i].x, positions[i].y, positions[i].z);
+    }
 
-        if (aiMesh->HasNormals())
+    if (aiMesh->HasNormals())
+    {
+        const aiVector3D* normals = aiMesh->mNormals;
+        for (unsigned int i = 0; i < numVertices; i++)
         {
-            vertex.normal = glm::vec3(
-                aiMesh->mNormals[i].x,
-                aiMesh->mNormals[i].y,
-                aiMesh->mNormals[i].z
-            );
+            vertices[i].normal = glm::vec3(normals[i].x, normals[i].y, normals[i].z);
         }
-        else
+    }
+    else
+    {
+        for (unsigned int i = 0; i < numVertices; i++)
         {
-            vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            vertices[i].normal = glm::vec3(0.0f, 1.0f, 0.0f);
         }
+    }
 
-        if (aiMesh->HasTextureCoords(0))
+    if (aiMesh->HasTextureCoords(0))
+    {
+        const aiVector3D* texCoords = aiMesh->mTextureCoords[0];
+        for (unsigned int i = 0; i < numVertices; i++)
         {
-            vertex.texCoords = glm::vec2(
-                aiMesh->mTextureCoords[0][i].x,
-                aiMesh->mTextureCoords[0][i].y
-            );
+            vertices[i].texCoords = glm::vec2(texCoords[i].x, texCoords[i].y);
         }
-        else
+    }
+    else
+    {
+        for (unsigned int i = 0; i < numVertices; i++)
         {
-            vertex.texCoords = glm::vec2(0.0f, 0.0f);
+            vertices[i].texCoords = glm::vec2(0.0f, 0.0f);
         }
+    }
+
+    // Indices (Triangulate can still leave point and line faces, those are not drawable as triangles)
+    const unsigned int numFaces = aiMesh->mNumFaces;
+    const aiFace* faces = aiMesh->mFaces;
 
-        mesh.vertices.push_back(vertex);
+    size_t numTriangles = numFaces;
+    if (aiMesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE)
+    {
+        numTriangles = 0;
+        for (unsigned int i = 0; i < numFaces; i++)
+        {
+            numTriangles += (faces[i].mNumIndices == 3) ? 1 : 0;
+        }
     }
 
-    // Indices
-    for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
+    mesh.indices.resize(numTriangles * 3);
+    unsigned int* indices = mesh.indices.data();
+
+    if (numTriangles == numFaces)
     {
-        aiFace face = aiMesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; j++)
+        for (unsigned int i = 0; i < numFaces; i++)
         {
-            mesh.indices.push_back(face.mIndices[j]);
+            const unsigned int* face = faces[i].mIndices;
+            indices[i * 3 + 0] = face[0];
+            indices[i * 3 + 1] = face[1];
+            indices[i * 3 + 2] = face[2];
+        }
+    }
+    else
+    {
+        size_t written = 0;
+        for (unsigned int i = 0; i < numFaces; i++)
+        {
+            if (faces[i].mNumIndices != 3) continue;
+
+            indices[written++] = faces[i].mIndices[0];
+            indices[written++] = faces[i].mIndices[1];
+            indices[written++] = faces[i].mIndices[2];
         }
     }
 
-    LOG_DEBUG("      Mesh processed: Vertices: %d, Indices: %d, Triangles: %d", mesh.vertices.size(), mesh.indices.size(), mesh.indices.size() / 3);
-    LOG_CONSOLE("  Mesh processed: %d vertices, %d triangles", mesh.vertices.size(), mesh.indices.size() / 3);
     return mesh;
 }
 
-void FileSystem::NormalizeModelScale(GameObject* rootObject, float targetSize)
+void FileSystem::NormalizeModelScale(GameObject* rootObject, const AABB& bounds, float targetSize)
 {
-    glm::vec3 minBounds(std::numeric_limits<float>::max());
-    glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+    if (!bounds.IsValid()) return;
 
-    glm::mat4 identity(1.0f);
-    CalculateBoundingBox(rootObject, minBounds, maxBounds, identity);
-
-    glm::vec3 size = maxBounds - minBounds;
+    glm::vec3 size = bounds.GetSize();
 
     float maxDimension = std::max({ size.x, size.y, size.z });
 
@@ -468,49 +951,25 @@ void FileSystem::NormalizeModelScale(GameObject* rootObject, float targetSize)
     }
 }
 
-void FileSystem::CalculateBoundingBox(GameObject* obj, glm::vec3& minBounds, glm::vec3& maxBounds, const glm::mat4& parentTransform)
+void FileSystem::CalculateBoundingBox(GameObject* obj, AABB& bounds)
 {
     Transform* t = static_cast<Transform*>(obj->GetComponent(ComponentType::TRANSFORM));
-    glm::mat4 localTransform(1.0f);
-
-    if (t != nullptr)
-    {
-        glm::vec3 pos = t->GetPosition();
-        glm::vec3 scale = t->GetScale();
-        glm::quat rot = t->GetRotationQuat();
 
-        glm::mat4 translation = glm::translate(glm::mat4(1.0f), pos);
-        glm::mat4 rotation = glm::mat4_cast(rot);
-        glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), scale);
+    // Global matrices are cached by Transform (the hierarchy is not attached to the scene yet)
+    glm::mat4 worldTransform = (t != nullptr) ? t->GetGlobalMatrix() : glm::mat4(1.0f);
 
-        localTransform = translation * rotation * scaleMatrix;
-    }
-
-    glm::mat4 worldTransform = parentTransform * localTransform;
-
-    ComponentMesh* meshComp = static_cast<ComponentMesh*>(obj->GetComponent(ComponentType::MESH));
-    if (meshComp != nullptr)
+    // Each mesh contributes its local AABB transformed by the node, no per-vertex work
+    for (Component* comp : obj->GetComponentsOfType(ComponentType::MESH))
     {
-        const Mesh& mesh = meshComp->GetMesh();
+        ComponentMesh* meshComp = static_cast<ComponentMesh*>(comp);
+        if (meshComp->GetNumVertices() == 0) continue;
 
-        for (const auto& vertex : mesh.vertices)
-        {
-            glm::vec4 worldPos = worldTransform * glm::vec4(vertex.position, 1.0f);
-            glm::vec3 pos3(worldPos.x, worldPos.y, worldPos.z);
-
-            minBounds.x = std::min(minBounds.x, pos3.x);
-            minBounds.y = std::min(minBounds.y, pos3.y);
-            minBounds.z = std::min(minBounds.z, pos3.z);
-
-            maxBounds.x = std::max(maxBounds.x, pos3.x);
-            maxBounds.y = std::max(maxBounds.y, pos3.y);
-            maxBounds.z = std::max(maxBounds.z, pos3.z);
-        }
+        bounds.Enclose(meshComp->GetLocalAABB().Transformed(worldTransform));
     }
 
     for (GameObject* child : obj->GetChildren())
     {
-        CalculateBoundingBox(child, minBounds, maxBounds, worldTransform);
+        CalculateBoundingBox(child, bounds);
     }
 }
 
@@ -571,7 +1030,7 @@ void FileSystem::CalculateBoundingBox(GameObject* obj, glm::vec3& minBounds, glm
 //    return correction;
 //}
 
-bool FileSystem::ApplyTextureToGameObject(GameObject* obj, const std::string& texturePath)
+bool FileSystem::ApplyTextureToGameObject(GameObject* obj, const TextureData& texture)
 {
     if (!obj || !obj->IsActive())
         return false;
@@ -594,7 +1053,7 @@ bool FileSystem::ApplyTextureToGameObject(GameObject* obj, const std::string& te
         }
 
         // Cargar la textura
-        if (matComp->LoadTexture(texturePath))
+        if (matComp->LoadTexture(texture))
         {
             LOG_DEBUG("  ✓ Texture applied to: %s", obj->GetName().c_str());
             applied = true;
@@ -608,7 +1067,7 @@ bool FileSystem::ApplyTextureToGameObject(GameObject* obj, const std::string& te
     // Aplicar recursivamente a los hijos
     for (GameObject* child : obj->GetChildren())
     {
-        if (ApplyTextureToGameObject(child, texturePath))
+        if (ApplyTextureToGameObject(child, texture))
         {
             applied = true;
         }
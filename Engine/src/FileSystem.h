@@ -4,13 +4,23 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <memory>
+#include <future>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include "AssetWatcher.h"
+#include "Input.h"
 
 class GameObject;
+class ComponentMaterial;
+struct TextureData;
 struct aiNode;
 struct aiScene;
 struct aiMesh;
 struct aiMaterial;
+struct AABB;
+struct MeshOptimizationStats;
+enum class IOPriority;
 
 // Vertex data structure
 struct Vertex {
@@ -19,6 +29,28 @@ struct Vertex {
     glm::vec2 texCoords;
 };
 
+// Vertex buffer formats
+enum class VertexLayout {
+    Float,  // Vertex as is, 32 bytes
+    Packed  // PackedVertex, 16 bytes
+};
+
+// Compact GPU vertex: snorm16 position relative to the mesh bounds,
+// octahedral snorm16 normal, unorm16 (or half float) texture coordinates
+struct PackedVertex {
+    short position[4];  // w is padding
+    short normal[2];
+    unsigned short texCoords[2];
+};
+
+// Simplified index buffer drawn instead of the full one at a distance.
+// Uses the same vertices as the mesh it belongs to.
+struct MeshLOD {
+    std::vector<unsigned int> indices;
+    float error = 0.0f;             // Geometric error relative to the mesh size
+    unsigned int indexOffset = 0;   // First index inside the mesh EBO, set by Renderer::LoadMesh
+};
+
 // Texture information
 struct TextureInfo {
     unsigned int id = 0;
@@ -32,12 +64,26 @@ struct Mesh {
     std::vector<unsigned int> indices;
     std::vector<TextureInfo> textures;
 
+    // Coarser versions of indices, LOD 0 is the full mesh itself
+    std::vector<MeshLOD> lods;
+
     // OpenGL buffer IDs 
     unsigned int VAO = 0;
     unsigned int VBO = 0;
     unsigned int EBO = 0;
 
+    // GPU-side format, picked by Renderer::LoadMesh (CPU data always stays full float)
+    VertexLayout layout = VertexLayout::Float;
+    unsigned int indexType = 0;
+
+    // Packed positions are in [-1, 1] over the mesh bounds: position = center + extents * packed
+    glm::vec3 quantizeCenter = glm::vec3(0.0f);
+    glm::vec3 quantizeExtents = glm::vec3(1.0f);
+
     bool IsValid() const { return VAO != 0; }
+
+    unsigned int GetLODCount() const { return 1 + static_cast<unsigned int>(lods.size()); }
+    size_t GetLODIndexCount(unsigned int level) const { return level == 0 ? indices.size() : lods[level - 1].indices.size(); }
 };
 
 // FBX/Model loading and management
@@ -55,21 +101,83 @@ public:
     // Loads an FBX file and converts it into a GameObject hierarchy
     GameObject* LoadFBXAsGameObject(const std::string& file_path);
 
-    // Apply texture to a GameObject and its children
-    bool ApplyTextureToGameObject(GameObject* obj, const std::string& texturePath);
+    // Apply a prepared texture to a GameObject and its children
+    bool ApplyTextureToGameObject(GameObject* obj, const TextureData& texture);
+
+    // Packs the Assets folder into Assets.pack next to the executable and mounts it
+    bool BuildAssetsPack();
+    const std::string& GetAssetsDirectory() const { return assetsDirectory; }
+
+    // Reads a model and parses it with the engine's import flags (thread safe, no logging).
+    // contentHash receives the hash of the file bytes.
+    static const aiScene* ImportScene(const std::string& path, IOPriority priority, uint64_t* contentHash = nullptr);
+    static unsigned int GetImportFlags();
+
+    // Converts every mesh of the scene on the worker pool, reordered for the vertex cache and with its LODs
+    static void ConvertMeshes(const aiScene* scene, std::vector<Mesh>& meshes, std::vector<MeshOptimizationStats>* stats);
+
+    // Changed files in the Assets folder are re-imported and swapped into the components using them
+    bool IsWatchingAssets() const { return watcher.IsWatching(); }
+    unsigned int GetPendingReloads() const { return static_cast<unsigned int>(meshReloads.size() + textureReloads.size()); }
 
 private:
-    // Recursively process scene nodes
-    GameObject* ProcessNode(aiNode* node, const aiScene* scene, const std::string& directory);
+    std::string assetsDirectory;
+
+    // Result of re-importing a model, indexed like the aiScene meshes
+    struct ReloadedModel;
+
+    struct MeshReload {
+        std::string sourcePath;
+        std::future<std::shared_ptr<ReloadedModel>> result;
+    };
+
+    struct TextureReload {
+        std::string relativePath;
+        std::future<std::shared_ptr<TextureData>> result;
+    };
+
+    // Files of the drop in progress
+    int droppedFileCount = 0;
+
+    void HandleDroppedFile(const std::string& filePath, DroppedFileType fileType);
+
+    AssetWatcher watcher;
+    std::vector<MeshReload> meshReloads;
+    std::vector<TextureReload> textureReloads;
+
+    // Starts the re-import of a changed file on the worker pool if anything in the scene uses it
+    void QueueReload(const std::string& relativePath);
+    // Uploads finished re-imports and hands them to the components, without touching the hierarchy
+    void ApplyReloads();
+    // True if path (as stored by a component) names the file relativePath inside the Assets folder
+    bool IsAssetPath(const std::string& path, const std::string& relativePath) const;
+
+    // Diffuse texture of a material, the first candidate path that loads is used
+    struct PendingTexture {
+        ComponentMaterial* material;
+        std::vector<std::string> candidates;
+    };
+
+    // Reads the Library meshes of an already cooked model, false if any is missing
+    static bool ReadCookedMeshes(const std::vector<uint64_t>& meshIds, std::vector<Mesh>& meshes);
+
+    // Recursively process scene nodes, meshes are already converted and uploaded once.
+    // Textures are only collected, LoadTextures reads them all at once afterwards.
+    GameObject* ProcessNode(aiNode* node, const aiScene* scene, const std::string& sourcePath,
+        const std::string& directory, const std::vector<std::shared_ptr<const Mesh>>& meshes,
+        const std::vector<AABB>& meshBounds, std::vector<PendingTexture>& textures);
+
+    // Reads and decodes every distinct texture in parallel, then uploads each one once here
+    void LoadTextures(const std::vector<PendingTexture>& textures);
 
-    // Convert Assimp mesh to engine mesh format
-    Mesh ProcessMesh(aiMesh* aiMesh, const aiScene* scene);
+    // Convert Assimp mesh to engine mesh format (thread safe, runs on the worker pool)
+    static Mesh ProcessMesh(aiMesh* aiMesh, const aiScene* scene);
 
-    // Scale model to fit target size
-    void NormalizeModelScale(GameObject* rootObject, float targetSize);
+    // Scale model to fit target size, using its already computed bounds
+    void NormalizeModelScale(GameObject* rootObject, const AABB& bounds, float targetSize);
 
-    // Calculate world-space bounding box
-    void CalculateBoundingBox(GameObject* obj, glm::vec3& minBounds, glm::vec3& maxBounds, const glm::mat4& parentTransform);
+    // Calculate the bounding box of a hierarchy from the per-mesh local AABBs
+    void CalculateBoundingBox(GameObject* obj, AABB& bounds);
 
     //// Detect and return rotation correction (Z-up to Y-up conversion)
     //glm::quat DetectCorrectionRotation(const aiScene* scene, const glm::vec3& modelSize);
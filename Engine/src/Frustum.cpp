@@ -0,0 +1,59 @@
+#include "Frustum.h"
+#include "AABB.h"
+#include <cmath>
+
+Frustum::Frustum()
+{
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        planes[i] = glm::vec4(0.0f);
+    }
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+    // glm is column major: row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+    glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+    planes[Left] = row3 + row0;
+    planes[Right] = row3 - row0;
+    planes[Bottom] = row3 + row1;
+    planes[Top] = row3 - row1;
+    planes[Near] = row3 + row2;
+    planes[Far] = row3 - row2;
+
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        float length = glm::length(glm::vec3(planes[i]));
+        if (length > 0.0f)
+            planes[i] /= length;
+    }
+}
+
+FrustumTest Frustum::Test(const AABB& box) const
+{
+    glm::vec3 center = box.GetCenter();
+    glm::vec3 extents = box.GetExtents();
+
+    FrustumTest result = FrustumTest::Inside;
+
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        glm::vec3 normal(planes[i]);
+
+        // Signed distance of the center against the projected radius of the box
+        float distance = glm::dot(normal, center) + planes[i].w;
+        float radius = std::abs(normal.x) * extents.x + std::abs(normal.y) * extents.y + std::abs(normal.z) * extents.z;
+
+        if (distance < -radius)
+            return FrustumTest::Outside;
+
+        if (distance < radius)
+            result = FrustumTest::Intersects;
+    }
+
+    return result;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+struct AABB;
+
+enum class FrustumTest
+{
+    Outside,
+    Intersects,
+    Inside
+};
+
+// View frustum as six inward facing planes (xyz = normal, w = distance)
+struct Frustum
+{
+    enum Plane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    glm::vec4 planes[PlaneCount];
+
+    Frustum();
+
+    // Planes taken straight from a projection * view matrix
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    FrustumTest Test(const AABB& box) const;
+    bool Intersects(const AABB& box) const { return Test(box) != FrustumTest::Outside; }
+};
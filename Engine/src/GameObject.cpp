@@ -3,12 +3,23 @@
 #include "Transform.h"
 #include "ComponentMesh.h"
 #include "ComponentMaterial.h"
+#include "Application.h"
 
 GameObject::GameObject(const std::string& name) : name(name), active(true), parent(nullptr) {
     CreateComponent(ComponentType::TRANSFORM);
 }
 
 GameObject::~GameObject() {
+    // Never leave a dangling pointer in the selection
+    if (selected && Application::GetInstance().selectionManager) {
+        Application::GetInstance().selectionManager->RemoveFromSelection(this);
+    }
+
+    // Same for the scene's spatial index
+    if (Application::GetInstance().scene) {
+        Application::GetInstance().scene->RemoveFromSpatialIndex(this);
+    }
+
     components.clear();
     componentOwners.clear();
 
@@ -75,6 +86,20 @@ std::vector<Component*> GameObject::GetComponentsOfType(ComponentType type) cons
     return result;
 }
 
+static void MarkTransformDirty(GameObject* gameObject) {
+    Transform* transform = static_cast<Transform*>(gameObject->GetComponent(ComponentType::TRANSFORM));
+    if (transform) {
+        transform->MarkGlobalDirty();
+    }
+}
+
+// Objects moved under (or out of) a selected one change their "ancestor selected" mark
+static void MarkSelectionDirty() {
+    if (Application::GetInstance().selectionManager) {
+        Application::GetInstance().selectionManager->MarkHierarchyDirty();
+    }
+}
+
 void GameObject::AddChild(GameObject* child) {
     if (child && child != this) {
         if (child->parent) {
@@ -83,6 +108,10 @@ void GameObject::AddChild(GameObject* child) {
 
         child->parent = this;
         children.push_back(child);
+
+        // The child now inherits this object's global matrix
+        MarkTransformDirty(child);
+        MarkSelectionDirty();
     }
 }
 
@@ -91,6 +120,9 @@ void GameObject::RemoveChild(GameObject* child) {
     if (it != children.end()) {
         (*it)->parent = nullptr;
         children.erase(it);
+
+        MarkTransformDirty(child);
+        MarkSelectionDirty();
     }
 }
 
@@ -103,6 +135,27 @@ void GameObject::SetParent(GameObject* newParent) {
     }
 }
 
+bool GameObject::IsActiveInHierarchy() const {
+    for (const GameObject* gameObject = this; gameObject != nullptr; gameObject = gameObject->parent) {
+        if (!gameObject->active) return false;
+    }
+    return true;
+}
+
+void GameObject::FixedUpdate() {
+    if (!active) return;
+
+    for (auto* component : components) {
+        if (component->IsActive()) {
+            component->FixedUpdate();
+        }
+    }
+
+    for (auto* child : children) {
+        child->FixedUpdate();
+    }
+}
+
 void GameObject::Update() {
     if (!active) return;
 
@@ -22,11 +22,14 @@ public:
     void SetParent(GameObject* newParent);
 
     void Update();
+    void FixedUpdate();
 
     const std::string& GetName() const { return name; }
     void SetName(const std::string& newName) { name = newName; }
     bool IsActive() const { return active; }
     void SetActive(bool state) { active = state; }
+    // False when this object or any of its ancestors is disabled
+    bool IsActiveInHierarchy() const;
     GameObject* GetParent() const { return parent; }
     const std::vector<GameObject*>& GetChildren() const { return children; }
     const std::vector<Component*>& GetComponents() const { return components; }
@@ -34,6 +37,9 @@ public:
     void MarkForDeletion() { markedForDeletion = true; }
     bool IsMarkedForDeletion() const { return markedForDeletion; }
 
+    // Selection state, owned by SelectionManager
+    bool IsSelected() const { return selected; }
+
 public:
     std::string name;
     bool active = true;
@@ -47,4 +53,9 @@ private:
 
     bool markedForDeletion = false;
 
+    // Selection flags (written only by SelectionManager)
+    friend class SelectionManager;
+    bool selected = false;
+    unsigned int hierarchySelectionStamp = 0; // Matches the manager stamp when this object or an ancestor is selected
+
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Application.h"
 #include "Shaders.h"
 #include "Camera.h"
+#include "RenderThread.h"
 #include <glm/gtc/type_ptr.hpp>
 
 Grid::Grid() : Module(), VAO(0), VBO(0), numVertices(0), gridSize(20.0f), gridDivisions(5), enabled(true)
@@ -91,28 +92,38 @@ void Grid::Draw()
 {
     if (VAO == 0) return;
 
-    Shader* shader = Application::GetInstance().renderer->GetDefaultShader();
-    if (shader == nullptr) return;
-
-    shader->Use();
-
     // Get camera matrices
     Camera* camera = Application::GetInstance().renderer->GetCamera();
     if (camera == nullptr) return;
 
+    // Drawn later on the render thread with this frame's camera
+    glm::mat4 projection = camera->GetProjectionMatrix();
+    glm::mat4 view = camera->GetViewMatrix();
+    RenderThread::GetInstance().Enqueue([this, projection, view]()
+    {
+        Submit(projection, view);
+    });
+}
+
+void Grid::Submit(const glm::mat4& projection, const glm::mat4& view)
+{
+    Shader* shader = Application::GetInstance().renderer->GetSolidShader();
+    if (shader == nullptr) return;
+
+    shader->Use();
+
     GLuint shaderProgram = shader->GetProgramID();
 
     // Send matrices to the shader
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
 
     // Identity model matrix (the grid is at the origin)
     glm::mat4 modelMatrix = glm::mat4(1.0f);
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(modelMatrix));
 
-    // Configure to use solid color instead of texture
-    glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 0);
-    glUniform4f(glGetUniformLocation(shaderProgram, "solidColor"), 0.5f, 0.5f, 0.5f, 1.0f); // Gray
+    // Untextured variant, the tint is the line color
+    shader->SetVec3("tintColor", glm::vec3(0.5f, 0.5f, 0.5f)); // Gray
 
     // Draw the grid
     glBindVertexArray(VAO);
@@ -1,5 +1,6 @@
 #pragma once
 #include "Module.h"
+#include <glm/glm.hpp>
 
 class Grid : public Module
 {
@@ -15,6 +16,8 @@ public:
 
 private:
     void CreateGrid();
+    // GL part of Draw, on the render thread
+    void Submit(const glm::mat4& projection, const glm::mat4& view);
 
     unsigned int VAO;
     unsigned int VBO;
@@ -0,0 +1,29 @@
+#include "ImageDecoder.h"
+
+// stb_image keeps its failure reason in a thread local, the rest of its state lives on the stack
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_FAILURE_USERMSG
+#include <stb_image.h>
+
+bool ImageDecoder::Decode(const unsigned char* data, size_t size, DecodedImage& image, std::string& error)
+{
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    // Always expanded to RGBA, like the rest of the texture pipeline expects
+    stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, STBI_rgb_alpha);
+    if (pixels == nullptr)
+    {
+        const char* reason = stbi_failure_reason();
+        error = reason ? reason : "unknown error";
+        return false;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    return true;
+}
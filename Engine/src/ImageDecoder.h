@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// RGBA8 pixels, first row at the top
+struct DecodedImage
+{
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// Image file decoding (PNG, JPG, TGA, BMP, PSD, GIF, HDR, PIC, PNM) with stb_image.
+// Everything works on caller owned memory with no shared state, so any number of
+// worker threads can decode at the same time. No logging: errors come back as text.
+class ImageDecoder
+{
+public:
+    static bool Decode(const unsigned char* data, size_t size, DecodedImage& image, std::string& error);
+};
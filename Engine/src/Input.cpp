@@ -8,11 +8,33 @@
 #include "GameObject.h"
 #include "Transform.h"
 #include "ComponentMesh.h"
+#include "RedrawScheduler.h"
 #include <limits>
 
 #define MAX_KEYS 300
+#define MAX_INPUT_EVENTS 256
 
-Input::Input() : Module(), droppedFile(false), droppedFilePath(""), droppedFileType(DROPPED_NONE)
+static DroppedFileType GetDroppedFileType(const std::string& path)
+{
+	if (path.size() < 4)
+		return DROPPED_NONE;
+
+	std::string extension = path.substr(path.size() - 4);
+	for (char& c : extension) c = tolower(c);
+
+	std::string sceneExtension = path.size() >= 6 ? path.substr(path.size() - 6) : "";
+	for (char& c : sceneExtension) c = tolower(c);
+
+	if (extension == ".fbx")
+		return DROPPED_FBX;
+	if (extension == ".png" || extension == ".dds")
+		return DROPPED_TEXTURE;
+	if (sceneExtension == ".scene")
+		return DROPPED_SCENE;
+	return DROPPED_NONE;
+}
+
+Input::Input() : Module(), events(MAX_INPUT_EVENTS)
 {
 	keyboard = new KeyState[MAX_KEYS];
 	// reserve memory
@@ -50,9 +72,6 @@ bool Input::PreUpdate()
 	static SDL_Event event;
 	const bool* keys = SDL_GetKeyboardState(NULL);
 
-	// Reset dropped file flag every frame
-	droppedFile = false;
-
 	for (int i = 0; i < MAX_KEYS; ++i)
 	{
 		if (keys[i])
@@ -78,8 +97,19 @@ bool Input::PreUpdate()
 			mouseButtons[i] = KEY_IDLE;
 	}
 
-	while (SDL_PollEvent(&event))
+	// Any event or held key keeps the editor drawing, held keys move the camera every frame
+	bool activity = false;
+	for (int i = 0; i < MAX_KEYS && !activity; ++i)
+		activity = keyboard[i] != KEY_IDLE;
+	for (int i = 0; i < NUM_MOUSE_BUTTONS && !activity; ++i)
+		activity = mouseButtons[i] != KEY_IDLE;
+
+	// An SDL event queues at most one InputEvent. With the queue full the remaining events stay
+	// in SDL's queue until the consumer catches up, instead of being dropped here.
+	while (events.GetSizeApprox() < events.GetCapacity() && SDL_PollEvent(&event))
 	{
+		activity = true;
+
 		// Process ImGui events first
 		ImGui_ImplSDL3_ProcessEvent(&event);
 
@@ -150,10 +180,13 @@ bool Input::PreUpdate()
 							screenWidth / scale,
 							screenHeight / scale);
 
-						// Find the closest object intersected by the ray
-						GameObject* root = Application::GetInstance().scene->GetRoot();
+						// Find the closest object intersected by the ray (octree, no full scene walk)
 						float minDist = std::numeric_limits<float>::max();
-						GameObject* clicked = FindClosestObjectToRay(root, rayOrigin, rayDir, minDist);
+						GameObject* clicked = Application::GetInstance().scene->Raycast(rayOrigin, rayDir, minDist);
+						if (clicked)
+						{
+							LOG_DEBUG("Ray hit '%s' at distance %.2f", clicked->GetName().c_str(), minDist);
+						}
 
 						bool shiftPressed = keys[SDL_SCANCODE_LSHIFT] || keys[SDL_SCANCODE_RSHIFT];
 
@@ -232,25 +265,22 @@ bool Input::PreUpdate()
 		case SDL_EVENT_DROP_FILE:
 			if (event.drop.data != nullptr)
 			{
-				droppedFilePath = event.drop.data;
-				droppedFile = true;
-
-				// Determine dropped file type
-				if (droppedFilePath.size() >= 4)
-				{
-					std::string extension = droppedFilePath.substr(droppedFilePath.size() - 4);
-					for (char& c : extension) c = tolower(c);
-
-					if (extension == ".fbx")
-						droppedFileType = DROPPED_FBX;
-					else if (extension == ".png" || extension == ".dds")
-						droppedFileType = DROPPED_TEXTURE;
-					else
-						droppedFileType = DROPPED_NONE;
-				}
+				InputEvent dropped;
+				dropped.type = INPUT_DROP_FILE;
+				dropped.path = event.drop.data;
+				dropped.fileType = GetDroppedFileType(dropped.path);
+				PushEvent(std::move(dropped));
 			}
 			break;
 
+		case SDL_EVENT_DROP_COMPLETE:
+		{
+			InputEvent complete;
+			complete.type = INPUT_DROP_COMPLETE;
+			PushEvent(std::move(complete));
+			break;
+		}
+
 		case SDL_EVENT_MOUSE_WHEEL:
 			if (!imguiWantCaptureMouse)
 			{
@@ -261,6 +291,9 @@ bool Input::PreUpdate()
 		}
 	}
 
+	if (activity)
+		RedrawScheduler::GetInstance().RequestRedraw(RedrawReason::Input);
+
 	// Camera movement with WASD + right mouse button
 	ImGuiIO& io = ImGui::GetIO();
 	Camera* camera = Application::GetInstance().renderer->GetCamera();
@@ -366,94 +399,10 @@ bool Input::GetWindowEvent(EventWindow ev)
 {
 	return windowEvents[ev];
 }
-// Ray-AABB intersection using slab method
-bool RayIntersectsAABB(const glm::vec3& rayOrigin, const glm::vec3& rayDir,
-	const glm::vec3& aabbMin, const glm::vec3& aabbMax,
-	float& distance)
-{
-	// Compute inverse direction to avoid division in loop
-	glm::vec3 invDir;
-	invDir.x = (std::abs(rayDir.x) > 0.0001f) ? 1.0f / rayDir.x : std::numeric_limits<float>::max();
-	invDir.y = (std::abs(rayDir.y) > 0.0001f) ? 1.0f / rayDir.y : std::numeric_limits<float>::max();
-	invDir.z = (std::abs(rayDir.z) > 0.0001f) ? 1.0f / rayDir.z : std::numeric_limits<float>::max();
-
-	glm::vec3 t0 = (aabbMin - rayOrigin) * invDir;
-	glm::vec3 t1 = (aabbMax - rayOrigin) * invDir;
-
-	glm::vec3 tmin = glm::min(t0, t1);
-	glm::vec3 tmax = glm::max(t0, t1);
-
-	float tNear = glm::max(glm::max(tmin.x, tmin.y), tmin.z);
-	float tFar = glm::min(glm::min(tmax.x, tmax.y), tmax.z);
-
-	if (tNear > tFar || tFar < 0.0f)
-	{
-		return false;
-	}
-
-	distance = (tNear > 0.0f) ? tNear : tFar;
-	return true;
-}
 
-// Recursively find closest object intersected by ray
-GameObject* FindClosestObjectToRay(GameObject* obj, const glm::vec3& rayOrigin, const glm::vec3& rayDir, float& minDist)
+void Input::PushEvent(InputEvent&& event)
 {
-	if (!obj || !obj->IsActive()) return nullptr;
-
-	GameObject* closest = nullptr;
-
-	ComponentMesh* mesh = static_cast<ComponentMesh*>(obj->GetComponent(ComponentType::MESH));
-	if (mesh && mesh->IsActive() && mesh->HasMesh())
-	{
-		Transform* t = static_cast<Transform*>(obj->GetComponent(ComponentType::TRANSFORM));
-		if (t)
-		{
-			glm::vec3 localMin = mesh->GetAABBMin();
-			glm::vec3 localMax = mesh->GetAABBMax();
-
-			glm::mat4 globalMatrix = t->GetGlobalMatrix();
-
-			// Transform AABB to world space by transforming all 8 corners
-			glm::vec3 corners[8] = {
-				glm::vec3(globalMatrix * glm::vec4(localMin.x, localMin.y, localMin.z, 1.0f)),
-				glm::vec3(globalMatrix * glm::vec4(localMax.x, localMin.y, localMin.z, 1.0f)),
-				glm::vec3(globalMatrix * glm::vec4(localMin.x, localMax.y, localMin.z, 1.0f)),
-				glm::vec3(globalMatrix * glm::vec4(localMax.x, localMax.y, localMin.z, 1.0f)),
-				glm::vec3(globalMatrix * glm::vec4(localMin.x, localMin.y, localMax.z, 1.0f)),
-				glm::vec3(globalMatrix * glm::vec4(localMax.x, localMin.y, localMax.z, 1.0f)),
-				glm::vec3(globalMatrix * glm::vec4(localMin.x, localMax.y, localMax.z, 1.0f)),
-				glm::vec3(globalMatrix * glm::vec4(localMax.x, localMax.y, localMax.z, 1.0f))
-			};
-
-			// Recompute axis-aligned bounding box in world space
-			glm::vec3 worldMin = corners[0];
-			glm::vec3 worldMax = corners[0];
-
-			for (int i = 1; i < 8; ++i)
-			{
-				worldMin = glm::min(worldMin, corners[i]);
-				worldMax = glm::max(worldMax, corners[i]);
-			}
-
-			float dist;
-			if (RayIntersectsAABB(rayOrigin, rayDir, worldMin, worldMax, dist))
-			{
-				if (dist < minDist)
-				{
-					minDist = dist;
-					closest = obj;
-					LOG_DEBUG("Ray hit '%s' at distance %.2f", obj->GetName().c_str(), dist);
-				}
-			}
-		}
-	}
-
-	// Recursively check children
-	for (GameObject* child : obj->GetChildren())
-	{
-		GameObject* childResult = FindClosestObjectToRay(child, rayOrigin, rayDir, minDist);
-		if (childResult) closest = childResult;
-	}
-
-	return closest;
+	// Cannot happen while PreUpdate checks for room before polling SDL
+	if (!events.TryPush(std::move(event)))
+		LOG_CONSOLE("ERROR: Input event queue full (%zu), event lost", events.GetCapacity());
 }
\ No newline at end of file
@@ -2,8 +2,7 @@
 #include "Module.h"
 #include <string>
 #include <glm/glm.hpp>
-
-class GameObject;
+#include "LockFreeQueue.h"
 
 #define NUM_MOUSE_BUTTONS 5
 
@@ -27,14 +26,22 @@ enum DroppedFileType
 {
 	DROPPED_NONE = 0,
 	DROPPED_FBX,
-	DROPPED_TEXTURE
+	DROPPED_TEXTURE,
+	DROPPED_SCENE
 };
 
-// Helper functions for object picking 
-bool RayIntersectsAABB(const glm::vec3& rayOrigin, const glm::vec3& rayDir,
-	const glm::vec3& aabbMin, const glm::vec3& aabbMax,
-	float& distance);
-GameObject* FindClosestObjectToRay(GameObject* obj, const glm::vec3& rayOrigin, const glm::vec3& rayDir, float& minDist);
+enum InputEventType
+{
+	INPUT_DROP_FILE = 0,
+	INPUT_DROP_COMPLETE	// Closes a drop, the files before it were dropped together
+};
+
+struct InputEvent
+{
+	InputEventType type = INPUT_DROP_FILE;
+	DroppedFileType fileType = DROPPED_NONE;
+	std::string path;
+};
 
 class Input : public Module
 {
@@ -60,11 +67,10 @@ public:
 
 	bool GetWindowEvent(EventWindow ev);
 
-	// Drag and Drop functions
-	bool HasDroppedFile() const { return droppedFile; }
-	const std::string& GetDroppedFilePath() const { return droppedFilePath; }
-	DroppedFileType GetDroppedFileType() const { return droppedFileType; }
-	void ClearDroppedFile() { droppedFile = false; droppedFilePath.clear(); droppedFileType = DROPPED_NONE; }
+	// Events for other modules, oldest first. Kept until polled, so every file of a
+	// multi-file drop gets through; while the queue is full SDL events wait in SDL.
+	bool PollEvent(InputEvent& event) { return events.TryPop(event); }
+	size_t GetPendingEvents() const { return events.GetSizeApprox(); }
 
 	int GetMouseX() const { return mouseX; }
 	int GetMouseY() const { return mouseY; }
@@ -78,8 +84,8 @@ private:
 	int mouseX;
 	int mouseY;
 
-	// Drag and Drop
-	bool droppedFile;
-	std::string droppedFilePath;
-	DroppedFileType droppedFileType;
+	void PushEvent(InputEvent&& event);
+
+	// Filled in PreUpdate, FileSystem is the one consumer
+	SPSCQueue<InputEvent> events;
 };
\ No newline at end of file
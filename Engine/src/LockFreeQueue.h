@@ -0,0 +1,193 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+// Bounded ring queues for handing messages between threads without a lock.
+// The capacity is rounded up to a power of two and fixed at construction, a full queue
+// refuses the push instead of allocating. Indices written by different threads live on
+// different cache lines, so the producer and consumer do not invalidate each other's lines.
+
+#define QUEUE_CACHE_LINE 64
+
+// One producer thread, one consumer thread
+template<typename T>
+class SPSCQueue
+{
+public:
+    explicit SPSCQueue(size_t capacity)
+        : mask(RoundUpToPowerOfTwo(capacity) - 1), cells(new T[mask + 1])
+    {
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Producer only, false when full
+    bool TryPush(T value)
+    {
+        const size_t tail = producer.index.load(std::memory_order_relaxed);
+
+        // The consumer's position is only re-read when the cached one says the queue is full
+        if (tail - producer.cachedOther > mask)
+        {
+            producer.cachedOther = consumer.index.load(std::memory_order_acquire);
+            if (tail - producer.cachedOther > mask)
+                return false;
+        }
+
+        cells[tail & mask] = std::move(value);
+        producer.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, false when empty
+    bool TryPop(T& value)
+    {
+        const size_t head = consumer.index.load(std::memory_order_relaxed);
+
+        if (head == consumer.cachedOther)
+        {
+            consumer.cachedOther = producer.index.load(std::memory_order_acquire);
+            if (head == consumer.cachedOther)
+                return false;
+        }
+
+        value = std::move(cells[head & mask]);
+        consumer.index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t GetCapacity() const { return mask + 1; }
+    // Exact only when called from the producer or consumer with the other one idle
+    size_t GetSizeApprox() const
+    {
+        return producer.index.load(std::memory_order_acquire) - consumer.index.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Side
+    {
+        std::atomic<size_t> index{ 0 };
+        size_t cachedOther = 0;     // Last seen index of the other side
+        char padding[QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    // Read only after construction
+    const size_t mask;
+    std::unique_ptr<T[]> cells;
+
+    char padding[QUEUE_CACHE_LINE];
+    Side producer;
+    Side consumer;
+};
+
+// Any number of producer threads, one consumer thread. Every cell carries a sequence number
+// telling whether it is free for the lap a producer is on or filled for the consumer, so
+// producers only compete on the tail index and never wait on each other's copies.
+template<typename T>
+class MPSCQueue
+{
+public:
+    explicit MPSCQueue(size_t capacity)
+        : mask(RoundUpToPowerOfTwo(capacity) - 1), cells(new Cell[mask + 1])
+    {
+        for (size_t i = 0; i <= mask; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // Any thread, false when full
+    bool TryPush(T value)
+    {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell& cell = cells[tail & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            ptrdiff_t difference = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(tail);
+
+            if (difference == 0)
+            {
+                // Free for this lap, claim it
+                if (tailIndex.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                // Still holds the previous lap's value
+                return false;
+            }
+            else
+            {
+                // Another producer claimed it first
+                tail = tailIndex.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only, false when empty or when the oldest push is still being written
+    bool TryPop(T& value)
+    {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        Cell& cell = cells[head & mask];
+
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+            return false;
+
+        value = std::move(cell.value);
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        headIndex.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t GetCapacity() const { return mask + 1; }
+    size_t GetSizeApprox() const
+    {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    // Read only after construction
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+
+    char padding[QUEUE_CACHE_LINE];
+    std::atomic<size_t> tailIndex{ 0 };     // Shared by the producers
+    char tailPadding[QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> headIndex{ 0 };     // Consumer only, atomic for GetSizeApprox
+    char headPadding[QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>)];
+};
@@ -4,10 +4,14 @@
 #include <cstdio>
 #include <string>
 
+// Lines other threads can queue between two flushes of the console
+#define CONSOLE_PENDING_LINES 1024
+
 void LogDebug(const char file[], int line, const char* format, ...)
 {
-    static char tmpString1[4096];
-    static va_list ap;
+    // Per thread, any thread may log
+    thread_local char tmpString1[4096];
+    va_list ap;
 
     // Construct the string from variable arguments
     va_start(ap, format);
@@ -24,8 +28,8 @@ void LogDebug(const char file[], int line, const char* format, ...)
 
 void LogConsole(const char file[], int line, const char* format, ...)
 {
-    static char tmpString[4096];
-    static va_list ap;
+    thread_local char tmpString[4096];
+    va_list ap;
 
     va_start(ap, format);
     vsnprintf(tmpString, 4096, format, ap);
@@ -45,7 +49,45 @@ ConsoleLog& ConsoleLog::GetInstance()
     return instance;
 }
 
+ConsoleLog::ConsoleLog() : ownerThread(std::this_thread::get_id()), pending(CONSOLE_PENDING_LINES)
+{
+}
+
 void ConsoleLog::AddLog(const std::string& message)
+{
+    if (std::this_thread::get_id() != ownerThread)
+    {
+        if (!pending.TryPush(message))
+            ++dropped;
+        return;
+    }
+
+    // Earlier lines from other threads go first
+    Flush();
+    Append(message);
+}
+
+unsigned int ConsoleLog::Flush()
+{
+    unsigned int count = 0;
+    std::string message;
+    while (pending.TryPop(message))
+    {
+        Append(message);
+        ++count;
+    }
+
+    unsigned int lost = dropped.exchange(0);
+    if (lost > 0)
+    {
+        Append("ERROR: " + std::to_string(lost) + " console lines from other threads were dropped (queue full)");
+        ++count;
+    }
+
+    return count;
+}
+
+void ConsoleLog::Append(const std::string& message)
 {
     logs.push_back(message);
 
@@ -5,6 +5,9 @@
 #include <cstdarg>
 #include <string>
 #include <vector>
+#include <atomic>
+#include <thread>
+#include "LockFreeQueue.h"
 
 #define LOG_CONSOLE(format, ...) LogConsole(__FILE__, __LINE__, format, ##__VA_ARGS__)
 #define LOG_DEBUG(format, ...) LogDebug(__FILE__, __LINE__, format, ##__VA_ARGS__)
@@ -12,12 +15,17 @@
 void LogConsole(const char file[], int line, const char* format, ...);
 void LogDebug(const char file[], int line, const char* format, ...);
 
+// Lines shown in the editor console. The log belongs to the thread that created it (main, which
+// logs first); other threads may log too, their lines are queued and appear at the next Flush.
 class ConsoleLog
 {
 public:
     static ConsoleLog& GetInstance();
 
+    // Any thread
     void AddLog(const std::string& message);
+    // Owner thread, once per frame: moves the lines queued by other threads in, returns how many
+    unsigned int Flush();
     void Clear();
     const std::vector<std::string>& GetLogs() const { return logs; }
 
@@ -28,13 +36,19 @@ public:
     }
 
 private:
-    ConsoleLog() = default;
+    ConsoleLog();
     ~ConsoleLog() = default;
 
     ConsoleLog(const ConsoleLog&) = delete;
     ConsoleLog& operator=(const ConsoleLog&) = delete;
 
+    void Append(const std::string& message);
+
     std::vector<std::string> logs;
+
+    const std::thread::id ownerThread;
+    MPSCQueue<std::string> pending;
+    std::atomic<unsigned int> dropped{ 0 };   // Lines lost to a full queue since the last Flush
 };
 
 #endif  // __LOG_H__
@@ -0,0 +1,453 @@
+#include "MeshOptimizer.h"
+#include "FileSystem.h"
+#include <algorithm>
+#include <cmath>
+
+// Forsyth scoring model. The scoring cache is larger than the real one on purpose:
+// it only ranks candidates, it does not have to match the hardware.
+#define SCORE_CACHE_SIZE 32
+#define SCORE_MAX_VALENCE 32
+
+static const float CacheDecayPower = 1.5f;
+static const float LastTriangleScore = 0.75f;
+static const float ValenceBoostScale = 2.0f;
+static const float ValenceBoostPower = 0.5f;
+
+namespace
+{
+    struct ScoreTable
+    {
+        // [cache position + 1][min(valence, SCORE_MAX_VALENCE)]
+        float values[SCORE_CACHE_SIZE + 1][SCORE_MAX_VALENCE + 1];
+
+        ScoreTable()
+        {
+            for (int position = -1; position < SCORE_CACHE_SIZE; ++position)
+            {
+                for (int valence = 0; valence <= SCORE_MAX_VALENCE; ++valence)
+                {
+                    values[position + 1][valence] = Compute(position, valence);
+                }
+            }
+        }
+
+        static float Compute(int cachePosition, int valence)
+        {
+            // Vertices with no triangles left are never picked again
+            if (valence == 0) return -1.0f;
+
+            float score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                // The last triangle's vertices get a fixed score so the next one
+                // does not simply reuse the same edge over and over
+                if (cachePosition < 3)
+                {
+                    score = LastTriangleScore;
+                }
+                else
+                {
+                    const float scaler = 1.0f / (SCORE_CACHE_SIZE - 3);
+                    score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+                }
+            }
+
+            // Favour vertices with few triangles left so they get finished off
+            score += ValenceBoostScale * std::pow(static_cast<float>(valence), -ValenceBoostPower);
+            return score;
+        }
+
+        float Get(int cachePosition, unsigned int valence) const
+        {
+            return values[cachePosition + 1][std::min<unsigned int>(valence, SCORE_MAX_VALENCE)];
+        }
+    };
+
+    const ScoreTable& GetScoreTable()
+    {
+        static const ScoreTable table;
+        return table;
+    }
+
+    // FIFO cache simulated with timestamps: a vertex is cached while fewer than
+    // cacheSize misses happened since it was loaded
+    struct FifoCache
+    {
+        std::vector<unsigned int> loadedAt;
+        unsigned int timestamp;
+        unsigned int cacheSize;
+
+        FifoCache(size_t vertexCount, unsigned int size)
+            : loadedAt(vertexCount, 0), timestamp(size + 1), cacheSize(size)
+        {
+        }
+
+        unsigned int Access(unsigned int vertex)
+        {
+            if (timestamp - loadedAt[vertex] > cacheSize)
+            {
+                loadedAt[vertex] = timestamp++;
+                return 1;
+            }
+            return 0;
+        }
+
+        unsigned int AccessTriangle(const unsigned int* triangle)
+        {
+            return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+        }
+
+        void Flush() { timestamp += cacheSize + 1; }
+    };
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize)
+{
+    VertexCacheStats stats;
+
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) return stats;
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+
+    size_t misses = 0;
+    size_t uniqueVertices = 0;
+
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        unsigned int vertex = indices[i];
+        misses += cache.Access(vertex);
+
+        if (!referenced[vertex])
+        {
+            referenced[vertex] = true;
+            ++uniqueVertices;
+        }
+    }
+
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(triangleCount);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(uniqueVertices);
+    return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+{
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2 || vertexCount == 0) return;
+
+    const ScoreTable& scores = GetScoreTable();
+
+    // Vertex -> triangle adjacency in one flat array
+    std::vector<unsigned int> liveValence(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        ++liveValence[indices[i]];
+    }
+
+    std::vector<unsigned int> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + liveValence[v];
+    }
+
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            unsigned int vertex = indices[t * 3 + k];
+            adjacency[fill[vertex]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        vertexScore[v] = scores.Get(-1, liveValence[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+
+    int bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const unsigned int* tri = &indices[t * 3];
+        triangleScore[t] = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+
+        if (triangleScore[t] > bestScore)
+        {
+            bestScore = triangleScore[t];
+            bestTriangle = static_cast<int>(t);
+        }
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+
+    // Room for the full cache plus the three vertices pushed out by a new triangle
+    unsigned int cache[SCORE_CACHE_SIZE + 3];
+    unsigned int newCache[SCORE_CACHE_SIZE + 3];
+    unsigned int cacheCount = 0;
+
+    size_t inputCursor = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        // Nothing adjacent to the cache is left: restart from the first unused triangle
+        if (bestTriangle < 0)
+        {
+            while (emitted[inputCursor]) ++inputCursor;
+            bestTriangle = static_cast<int>(inputCursor);
+        }
+
+        const unsigned int* tri = &indices[bestTriangle * 3];
+        output.insert(output.end(), tri, tri + 3);
+        emitted[bestTriangle] = true;
+
+        // Remove the triangle from the live part of each vertex's adjacency list
+        for (int k = 0; k < 3; ++k)
+        {
+            unsigned int vertex = tri[k];
+            unsigned int* begin = &adjacency[adjacencyOffset[vertex]];
+            unsigned int* end = begin + liveValence[vertex];
+            unsigned int* found = std::find(begin, end, static_cast<unsigned int>(bestTriangle));
+            if (found != end)
+            {
+                std::swap(*found, *(end - 1));
+                --liveValence[vertex];
+            }
+        }
+
+        // The emitted triangle goes to the front, the rest keeps its LRU order
+        unsigned int newCount = 0;
+        newCache[newCount++] = tri[0];
+        newCache[newCount++] = tri[1];
+        newCache[newCount++] = tri[2];
+
+        for (unsigned int i = 0; i < cacheCount; ++i)
+        {
+            unsigned int vertex = cache[i];
+            if (vertex != tri[0] && vertex != tri[1] && vertex != tri[2])
+                newCache[newCount++] = vertex;
+        }
+
+        // Update vertex scores, including the ones that just fell out of the cache
+        for (unsigned int i = 0; i < newCount; ++i)
+        {
+            unsigned int vertex = newCache[i];
+            cachePosition[vertex] = i < SCORE_CACHE_SIZE ? static_cast<int>(i) : -1;
+            vertexScore[vertex] = scores.Get(cachePosition[vertex], liveValence[vertex]);
+        }
+
+        // Only triangles touching changed vertices can change score
+        bestTriangle = -1;
+        bestScore = -1.0f;
+        for (unsigned int i = 0; i < newCount; ++i)
+        {
+            unsigned int vertex = newCache[i];
+            const unsigned int* begin = &adjacency[adjacencyOffset[vertex]];
+            const unsigned int* end = begin + liveValence[vertex];
+
+            for (const unsigned int* it = begin; it != end; ++it)
+            {
+                unsigned int t = *it;
+                const unsigned int* other = &indices[t * 3];
+                triangleScore[t] = vertexScore[other[0]] + vertexScore[other[1]] + vertexScore[other[2]];
+
+                if (triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    bestTriangle = static_cast<int>(t);
+                }
+            }
+        }
+
+        cacheCount = std::min<unsigned int>(newCount, SCORE_CACHE_SIZE);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, float threshold)
+{
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2 || vertices.empty()) return;
+
+    // Hard boundaries: a triangle with three misses starts a new strip of locality,
+    // so moving whole clusters around costs nothing in cache efficiency
+    std::vector<size_t> hardClusters;
+    {
+        FifoCache cache(vertices.size(), StatsCacheSize);
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            if (cache.AccessTriangle(&indices[t * 3]) == 3 || t == 0)
+                hardClusters.push_back(t);
+        }
+    }
+
+    // Soft boundaries: split clusters further as long as each part stays within
+    // threshold of the cluster's own ACMR
+    std::vector<size_t> clusters;
+    clusters.reserve(hardClusters.size());
+    {
+        FifoCache cache(vertices.size(), StatsCacheSize);
+
+        for (size_t c = 0; c < hardClusters.size(); ++c)
+        {
+            size_t start = hardClusters[c];
+            size_t end = c + 1 < hardClusters.size() ? hardClusters[c + 1] : triangleCount;
+
+            cache.Flush();
+            size_t clusterMisses = 0;
+            for (size_t t = start; t < end; ++t)
+            {
+                clusterMisses += cache.AccessTriangle(&indices[t * 3]);
+            }
+
+            float targetAcmr = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+            clusters.push_back(start);
+            cache.Flush();
+
+            size_t runningMisses = 0;
+            size_t runningTriangles = 0;
+            for (size_t t = start; t < end; ++t)
+            {
+                runningMisses += cache.AccessTriangle(&indices[t * 3]);
+                ++runningTriangles;
+
+                if (t + 1 < end && static_cast<float>(runningMisses) / static_cast<float>(runningTriangles) <= targetAcmr)
+                {
+                    clusters.push_back(t + 1);
+                    cache.Flush();
+                    runningMisses = 0;
+                    runningTriangles = 0;
+                }
+            }
+        }
+    }
+
+    size_t clusterCount = clusters.size();
+    if (clusterCount < 2) return;
+
+    // Area weighted centroid and normal of every cluster
+    std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        size_t start = clusters[c];
+        size_t end = c + 1 < clusterCount ? clusters[c + 1] : triangleCount;
+
+        float clusterArea = 0.0f;
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+
+        for (size_t t = start; t < end; ++t)
+        {
+            const glm::vec3& p0 = vertices[indices[t * 3 + 0]].position;
+            const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+
+            // Length of the cross product is twice the area, the factor cancels out
+            glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(cross);
+
+            centroid += (p0 + p1 + p2) * (area / 3.0f);
+            normal += cross;
+            clusterArea += area;
+        }
+
+        meshCentroid += centroid;
+        meshArea += clusterArea;
+
+        float normalLength = glm::length(normal);
+        clusterCentroid[c] = clusterArea > 0.0f ? centroid / clusterArea : glm::vec3(0.0f);
+        clusterNormal[c] = normalLength > 0.0f ? normal / normalLength : glm::vec3(0.0f);
+    }
+
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+    // Clusters far out along their own normal occlude the rest of the mesh from
+    // most view directions, so they are drawn first
+    std::vector<float> sortKey(clusterCount);
+    std::vector<size_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        sortKey[c] = glm::dot(clusterCentroid[c] - meshCentroid, clusterNormal[c]);
+        order[c] = c;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&sortKey](size_t a, size_t b)
+    {
+        return sortKey[a] > sortKey[b];
+    });
+
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+
+    for (size_t c : order)
+    {
+        size_t start = clusters[c];
+        size_t end = c + 1 < clusterCount ? clusters[c + 1] : triangleCount;
+        output.insert(output.end(), indices.begin() + start * 3, indices.begin() + end * 3);
+    }
+
+    // Keep any trailing indices that did not form a full triangle
+    output.insert(output.end(), indices.begin() + triangleCount * 3, indices.end());
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(Mesh& mesh)
+{
+    if (mesh.vertices.empty() || mesh.indices.empty()) return;
+
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(mesh.vertices.size(), unused);
+    unsigned int nextVertex = 0;
+
+    for (unsigned int& index : mesh.indices)
+    {
+        if (remap[index] == unused)
+            remap[index] = nextVertex++;
+
+        index = remap[index];
+    }
+
+    std::vector<Vertex> reordered(nextVertex);
+    for (size_t v = 0; v < mesh.vertices.size(); ++v)
+    {
+        if (remap[v] != unused)
+            reordered[remap[v]] = mesh.vertices[v];
+    }
+
+    mesh.vertices.swap(reordered);
+}
+
+void MeshOptimizer::Optimize(Mesh& mesh, MeshOptimizationStats* stats)
+{
+    if (mesh.indices.size() < 3 || mesh.vertices.empty()) return;
+
+    if (stats)
+        stats->before = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+
+    OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+    OptimizeOverdraw(mesh.indices, mesh.vertices);
+    OptimizeVertexFetch(mesh);
+
+    if (stats)
+    {
+        stats->after = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+        stats->triangles = mesh.indices.size() / 3;
+        stats->vertices = mesh.vertices.size();
+    }
+}
@@ -0,0 +1,388 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "FileSystem.h"
+#include "AABB.h"
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <cmath>
+
+// Meshes below this size are cheap enough at full detail
+#define LOD_MIN_TRIANGLES 256
+#define LOD_MAX_LEVELS 3
+
+// Error budget of the first LOD relative to the mesh size, doubled every level
+#define LOD_BASE_ERROR 0.01f
+
+// A level has to remove at least this fraction of its source triangles to be kept
+#define LOD_MIN_REDUCTION 0.2f
+
+namespace
+{
+    // Symmetric 4x4 error quadric, stored as its 10 unique terms plus the total plane weight
+    struct Quadric
+    {
+        double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+        double b2 = 0.0, bc = 0.0, bd = 0.0;
+        double c2 = 0.0, cd = 0.0;
+        double d2 = 0.0;
+        double weight = 0.0;
+
+        void AddPlane(double a, double b, double c, double d, double w)
+        {
+            a2 += a * a * w; ab += a * b * w; ac += a * c * w; ad += a * d * w;
+            b2 += b * b * w; bc += b * c * w; bd += b * d * w;
+            c2 += c * c * w; cd += c * d * w;
+            d2 += d * d * w;
+            weight += w;
+        }
+
+        void Add(const Quadric& other)
+        {
+            a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+            b2 += other.b2; bc += other.bc; bd += other.bd;
+            c2 += other.c2; cd += other.cd;
+            d2 += other.d2;
+            weight += other.weight;
+        }
+
+        // Weighted mean squared distance from the point to the accumulated planes
+        double Evaluate(const glm::vec3& point) const
+        {
+            double x = point.x, y = point.y, z = point.z;
+            double error =
+                a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x +
+                b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y +
+                c2 * z * z + 2.0 * cd * z +
+                d2;
+
+            return weight > 0.0 ? std::abs(error) / weight : 0.0;
+        }
+    };
+
+    struct EdgeCollapse
+    {
+        unsigned int source;
+        unsigned int target;
+        double cost;
+    };
+
+    struct PositionKey
+    {
+        glm::vec3 position;
+
+        bool operator==(const PositionKey& other) const
+        {
+            return position.x == other.position.x && position.y == other.position.y && position.z == other.position.z;
+        }
+    };
+
+    struct PositionKeyHash
+    {
+        size_t operator()(const PositionKey& key) const
+        {
+            std::hash<float> hasher;
+            size_t hash = hasher(key.position.x);
+            hash ^= hasher(key.position.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            hash ^= hasher(key.position.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    uint64_t EdgeKey(unsigned int a, unsigned int b)
+    {
+        if (a > b) std::swap(a, b);
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+}
+
+std::vector<unsigned int> MeshSimplifier::Simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+    size_t targetIndexCount, float targetError, float* resultError)
+{
+    std::vector<unsigned int> result(indices.begin(), indices.begin() + (indices.size() / 3) * 3);
+
+    if (resultError) *resultError = 0.0f;
+    if (result.size() <= targetIndexCount || vertices.empty()) return result;
+
+    size_t vertexCount = vertices.size();
+
+    AABB bounds = ComputeVertexBounds(vertices.data(), vertexCount);
+    glm::vec3 size = bounds.GetSize();
+    float scale = std::max(size.x, std::max(size.y, size.z));
+    if (scale <= 0.0f) scale = 1.0f;
+
+    double maxCost = static_cast<double>(targetError) * scale;
+    maxCost *= maxCost;
+
+    // Vertices split along UV or normal seams share a position: weld them for topology
+    std::vector<unsigned int> canonical(vertexCount);
+    std::vector<unsigned int> wedgeCount(vertexCount, 0);
+    {
+        std::unordered_map<PositionKey, unsigned int, PositionKeyHash> firstAtPosition;
+        firstAtPosition.reserve(vertexCount);
+
+        for (unsigned int v = 0; v < vertexCount; ++v)
+        {
+            auto inserted = firstAtPosition.emplace(PositionKey{ vertices[v].position }, v);
+            canonical[v] = inserted.first->second;
+            ++wedgeCount[canonical[v]];
+        }
+    }
+
+    // Seams, open borders and non-manifold edges stay in place so the outline
+    // and the texture layout survive the simplification
+    std::vector<bool> locked(vertexCount, false);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+    {
+        if (wedgeCount[canonical[v]] > 1)
+            locked[canonical[v]] = true;
+    }
+
+    {
+        std::unordered_map<uint64_t, unsigned int> edgeUses;
+        edgeUses.reserve(result.size());
+
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                ++edgeUses[EdgeKey(canonical[result[i + k]], canonical[result[i + (k + 1) % 3]])];
+            }
+        }
+
+        for (const auto& edge : edgeUses)
+        {
+            if (edge.second != 2)
+            {
+                locked[static_cast<unsigned int>(edge.first >> 32)] = true;
+                locked[static_cast<unsigned int>(edge.first & 0xFFFFFFFFu)] = true;
+            }
+        }
+    }
+
+    // Area weighted plane quadrics of the surrounding triangles
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        const glm::vec3& p0 = vertices[result[i + 0]].position;
+        const glm::vec3& p1 = vertices[result[i + 1]].position;
+        const glm::vec3& p2 = vertices[result[i + 2]].position;
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(normal);
+        if (length <= 0.0f) continue;
+
+        normal /= length;
+        double d = -glm::dot(normal, p0);
+        double area = length * 0.5;
+
+        for (int k = 0; k < 3; ++k)
+        {
+            quadrics[canonical[result[i + k]]].AddPlane(normal.x, normal.y, normal.z, d, area);
+        }
+    }
+
+    std::vector<unsigned int> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<unsigned int> adjacencyOffset(vertexCount + 1);
+    std::vector<unsigned int> adjacency;
+    std::vector<EdgeCollapse> collapses;
+    double reachedCost = 0.0;
+
+    // Each pass collapses a set of independent edges, cheapest first
+    while (result.size() > targetIndexCount)
+    {
+        size_t triangleCount = result.size() / 3;
+
+        // Vertex -> triangle adjacency for the current index buffer
+        std::fill(adjacencyOffset.begin(), adjacencyOffset.end(), 0);
+        for (unsigned int index : result)
+        {
+            ++adjacencyOffset[index + 1];
+        }
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            adjacencyOffset[v + 1] += adjacencyOffset[v];
+        }
+
+        adjacency.resize(result.size());
+        std::vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            adjacency[fill[result[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        // Every interior edge is seen from both triangles, keep one orientation
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                unsigned int v0 = result[i + k];
+                unsigned int v1 = result[i + (k + 1) % 3];
+                unsigned int c0 = canonical[v0];
+                unsigned int c1 = canonical[v1];
+
+                if (c0 >= c1) continue;
+                if (locked[c0] && locked[c1]) continue;
+
+                Quadric combined = quadrics[c0];
+                combined.Add(quadrics[c1]);
+
+                EdgeCollapse best = { 0, 0, -1.0 };
+
+                if (!locked[c0])
+                    best = { v0, v1, combined.Evaluate(vertices[v1].position) };
+
+                if (!locked[c1])
+                {
+                    double cost = combined.Evaluate(vertices[v0].position);
+                    if (best.cost < 0.0 || cost < best.cost)
+                        best = { v1, v0, cost };
+                }
+
+                if (best.cost <= maxCost)
+                    collapses.push_back(best);
+            }
+        }
+
+        if (collapses.empty()) break;
+
+        std::sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& a, const EdgeCollapse& b)
+        {
+            return a.cost < b.cost;
+        });
+
+        for (unsigned int v = 0; v < vertexCount; ++v)
+        {
+            remap[v] = v;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+
+        size_t trianglesToRemove = triangleCount - targetIndexCount / 3;
+        size_t removedTriangles = 0;
+        size_t collapseCount = 0;
+
+        for (const EdgeCollapse& collapse : collapses)
+        {
+            if (removedTriangles >= trianglesToRemove) break;
+
+            unsigned int sourceId = canonical[collapse.source];
+            unsigned int targetId = canonical[collapse.target];
+
+            // Neighbourhoods already changed in this pass wait for the next one
+            if (touched[sourceId] || touched[targetId]) continue;
+
+            const glm::vec3& targetPosition = vertices[collapse.target].position;
+
+            bool flips = false;
+            size_t collapsedTriangles = 0;
+
+            for (unsigned int a = adjacencyOffset[collapse.source]; a < adjacencyOffset[collapse.source + 1]; ++a)
+            {
+                const unsigned int* triangle = &result[adjacency[a] * 3];
+
+                if (canonical[triangle[0]] == targetId || canonical[triangle[1]] == targetId || canonical[triangle[2]] == targetId)
+                {
+                    ++collapsedTriangles;
+                    continue;
+                }
+
+                // Reject the collapse if any remaining triangle would turn over
+                glm::vec3 before[3];
+                glm::vec3 after[3];
+                for (int k = 0; k < 3; ++k)
+                {
+                    before[k] = vertices[triangle[k]].position;
+                    after[k] = triangle[k] == collapse.source ? targetPosition : before[k];
+                }
+
+                glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+                if (glm::dot(normalBefore, normalAfter) <= 0.0f)
+                {
+                    flips = true;
+                    break;
+                }
+            }
+
+            if (flips) continue;
+
+            remap[collapse.source] = collapse.target;
+            quadrics[targetId].Add(quadrics[sourceId]);
+
+            for (unsigned int a = adjacencyOffset[collapse.source]; a < adjacencyOffset[collapse.source + 1]; ++a)
+            {
+                const unsigned int* triangle = &result[adjacency[a] * 3];
+                touched[canonical[triangle[0]]] = true;
+                touched[canonical[triangle[1]]] = true;
+                touched[canonical[triangle[2]]] = true;
+            }
+
+            removedTriangles += collapsedTriangles;
+            reachedCost = std::max(reachedCost, collapse.cost);
+            ++collapseCount;
+        }
+
+        if (collapseCount == 0) break;
+
+        // Apply the collapses and drop the triangles that became degenerate
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            unsigned int a = remap[result[i + 0]];
+            unsigned int b = remap[result[i + 1]];
+            unsigned int c = remap[result[i + 2]];
+
+            if (canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[a] == canonical[c])
+                continue;
+
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (resultError) *resultError = static_cast<float>(std::sqrt(reachedCost) / scale);
+    return result;
+}
+
+void MeshSimplifier::GenerateLODs(Mesh& mesh)
+{
+    mesh.lods.clear();
+
+    if (mesh.indices.size() / 3 < LOD_MIN_TRIANGLES) return;
+
+    // Each level is simplified from the previous one, which is much cheaper than
+    // starting from full detail every time; the errors add up accordingly
+    std::vector<unsigned int> previous = mesh.indices;
+    float previousError = 0.0f;
+    float errorBudget = LOD_BASE_ERROR;
+
+    for (int level = 1; level <= LOD_MAX_LEVELS; ++level)
+    {
+        size_t targetIndexCount = (previous.size() / 6) * 3;
+
+        float error = 0.0f;
+        std::vector<unsigned int> simplified = Simplify(mesh.vertices, previous, targetIndexCount, errorBudget, &error);
+
+        // Stalled on locked seams or ran out of error budget
+        if (simplified.size() > previous.size() * (1.0f - LOD_MIN_REDUCTION)) break;
+
+        MeshOptimizer::OptimizeVertexCache(simplified, mesh.vertices.size());
+
+        MeshLOD lod;
+        lod.indices = simplified;
+        lod.error = previousError + error;
+        mesh.lods.push_back(std::move(lod));
+
+        if (simplified.size() / 3 < LOD_MIN_TRIANGLES / 2) break;
+
+        previous = std::move(simplified);
+        previousError = mesh.lods.back().error;
+        errorBudget *= 2.0f;
+    }
+}
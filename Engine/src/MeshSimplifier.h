@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+struct Vertex;
+struct Mesh;
+
+// Edge-collapse simplification driven by quadric error metrics (Garland-Heckbert).
+// Only the index buffer changes: every collapse moves a vertex onto one of its
+// neighbours, so all LODs of a mesh share the original vertex buffer.
+class MeshSimplifier
+{
+public:
+    // Simplifies until the index count reaches targetIndexCount or the next collapse would
+    // exceed targetError (relative to the mesh size). Returns the new index buffer and,
+    // optionally, the error actually reached.
+    static std::vector<unsigned int> Simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+        size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+    // Fills mesh.lods with successively coarser versions (about half the triangles each)
+    static void GenerateLODs(Mesh& mesh);
+};
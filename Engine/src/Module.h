@@ -43,6 +43,13 @@ public:
 		return true;
 	}
 
+	// Called zero or more times per loop iteration, between PreUpdate and Update,
+	// each one advancing the simulation by Time::GetFixedDeltaTime()
+	virtual bool FixedUpdate()
+	{
+		return true;
+	}
+
 	// Called each loop iteration
 	virtual bool PostUpdate()
 	{
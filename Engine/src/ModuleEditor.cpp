@@ -3,11 +3,11 @@
 #include <imgui_impl_opengl3.h>
 #include <SDL3/SDL.h>
 #include <glad/glad.h>
-#include <IL/il.h>
 #include <windows.h>
 #include <psapi.h>
 #include <gl/GL.h>
 #include <SDL3/SDL_timer.h>
+#include <lz4.h>
 
 #include "ModuleEditor.h"
 #include "Application.h"
@@ -19,6 +19,17 @@
 #include "ComponentMesh.h"
 #include "ComponentMaterial.h"
 #include "Transform.h"
+#include "ShaderManager.h"
+#include "TextureStreamer.h"
+#include "TextureUploader.h"
+#include "BindlessTextures.h"
+#include "Texture.h"
+#include "SceneSerializer.h"
+#include "VirtualFileSystem.h"
+#include "AssetDatabase.h"
+#include "FileSystem.h"
+#include "RedrawScheduler.h"
+#include "RenderThread.h"
 
 
 ModuleEditor::ModuleEditor() : Module()
@@ -43,6 +54,14 @@ bool ModuleEditor::Start()
 
     ImGui_ImplSDL3_InitForOpenGL(Application::GetInstance().window->GetWindow(), Application::GetInstance().renderContext->GetContext());
     ImGui_ImplOpenGL3_Init();
+    // NewFrame would create them lazily, without a context once the render thread owns it
+    ImGui_ImplOpenGL3_CreateDeviceObjects();
+
+    // Same reason, the hardware info reads these every frame
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    const GLubyte* version = glGetString(GL_VERSION);
+    gpuName = renderer ? reinterpret_cast<const char*>(renderer) : "Unknown";
+    glVersion = version ? reinterpret_cast<const char*>(version) : "Unknown";
 
     ImGui::StyleColorsDark();
 
@@ -122,15 +141,68 @@ bool ModuleEditor::PostUpdate()
 {
     ShowMenuBar();
 
+    // Widgets being dragged or edited animate (text cursor) without sending events
+    if (ImGui::IsAnyItemActive() || ImGui::GetIO().WantTextInput)
+        RedrawScheduler::GetInstance().RequestRedraw(RedrawReason::UI);
+
     ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+    if (RenderThread::GetInstance().IsRunning())
+        QueueDrawData(ImGui::GetDrawData());
+    else
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
     return true;
 }
 
+void ModuleEditor::QueueDrawData(ImDrawData* drawData)
+{
+    RenderThread& renderThread = RenderThread::GetInstance();
+
+#if IMGUI_VERSION_NUM >= 19200
+    // Font atlas changes are uploaded before any copy referencing them is drawn
+    if (drawData->Textures != nullptr)
+    {
+        for (ImTextureData* texture : *drawData->Textures)
+        {
+            if (texture->Status != ImTextureStatus_OK)
+                renderThread.RunSync([texture]() { ImGui_ImplOpenGL3_UpdateTexture(texture); });
+        }
+    }
+#endif
+
+    // The copy of two frames ago has been drawn by now
+    ImDrawData& copy = drawDataCopies[drawDataIndex];
+    drawDataIndex = 1 - drawDataIndex;
+
+    FreeDrawDataCopy(copy);
+    copy = *drawData;
+    for (int i = 0; i < copy.CmdLists.Size; ++i)
+        copy.CmdLists[i] = drawData->CmdLists[i]->CloneOutput();
+#if IMGUI_VERSION_NUM >= 19200
+    copy.Textures = nullptr;
+#endif
+
+    renderThread.Enqueue([&copy]()
+    {
+        ImGui_ImplOpenGL3_RenderDrawData(&copy);
+    });
+}
+
+void ModuleEditor::FreeDrawDataCopy(ImDrawData& copy)
+{
+    for (ImDrawList* list : copy.CmdLists)
+        IM_DELETE(list);
+    copy.CmdLists.clear();
+}
+
 bool ModuleEditor::CleanUp()
 {
     LOG_DEBUG("Cleaning up Editor");
 
+    FreeDrawDataCopy(drawDataCopies[0]);
+    FreeDrawDataCopy(drawDataCopies[1]);
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
@@ -142,6 +214,13 @@ bool ModuleEditor::ShowMenuBar() {
     if (ImGui::BeginMainMenuBar()) {
 
         if (ImGui::BeginMenu("File")) {
+            if (ImGui::MenuItem("Save Scene")) {
+                Application::GetInstance().scene->SaveScene(SceneSerializer::GetDefaultScenePath());
+            }
+            if (ImGui::MenuItem("Load Scene")) {
+                Application::GetInstance().scene->LoadScene(SceneSerializer::GetDefaultScenePath());
+            }
+            ImGui::Separator();
             if (ImGui::MenuItem("Exit")) {
                 Application::GetInstance().RequestExit();
             }
@@ -236,6 +315,22 @@ void ModuleEditor::DrawConfigurationWindow()
 
 	ImGui::Separator();
 
+    // Textures
+    if (ImGui::CollapsingHeader("Textures"))
+    {
+        DrawTextureStreaming();
+    }
+
+    ImGui::Separator();
+
+    // File System
+    if (ImGui::CollapsingHeader("File System"))
+    {
+        DrawFileSystemInfo();
+    }
+
+    ImGui::Separator();
+
     // Hardware
     if (ImGui::CollapsingHeader("Hardware"))
     {
@@ -300,6 +395,54 @@ void ModuleEditor::DrawFPSGraph()
 		// FPS graph
         ImGui::PlotLines("##FPS", fpsHistory.data(), (int)fpsHistory.size(), 0, nullptr, 0.0f, 200.0f, ImVec2(0, 80));
     }
+
+    Time* time = Application::GetInstance().time.get();
+    ImGui::Text("Work per frame: %.3f ms%s", time->GetFrameWorkMs(), time->IsIdle() ? " (idle)" : "");
+
+    // 0 means uncapped
+    int frameRateCap = time->GetFrameRateCap();
+    if (ImGui::SliderInt("Frame Rate Cap", &frameRateCap, 0, 240))
+        time->SetFrameRateCap(frameRateCap);
+
+    int idleFrameRateCap = time->GetIdleFrameRateCap();
+    if (ImGui::SliderInt("Idle Frame Rate Cap", &idleFrameRateCap, 0, 60))
+        time->SetIdleFrameRateCap(idleFrameRateCap);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Used while the window is minimized or unfocused");
+
+    ImGui::Text("Fixed step: %.2f ms, %d this frame, alpha %.2f",
+        time->GetFixedDeltaTime() * 1000.0f, time->GetFixedStepsThisFrame(), time->GetInterpolationAlpha());
+
+    bool interpolation = time->IsInterpolationEnabled();
+    if (ImGui::Checkbox("Interpolate Transforms", &interpolation))
+        time->SetInterpolationEnabled(interpolation);
+
+    RedrawScheduler& redraw = RedrawScheduler::GetInstance();
+    bool redrawOnChange = redraw.IsEnabled();
+    if (ImGui::Checkbox("Redraw Only On Change", &redrawOnChange))
+        redraw.SetEnabled(redrawOnChange);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Sleeps until input, a scene change or a finished load instead of drawing every frame");
+
+    static const char* reasonNames[] = { "input", "transform", "camera", "import", "ui", "streaming" };
+    std::string reasons;
+    for (int i = 0; i < IM_ARRAYSIZE(reasonNames); ++i)
+    {
+        if (redraw.GetLastReasons() & (1u << i))
+            reasons += reasons.empty() ? reasonNames[i] : std::string(", ") + reasonNames[i];
+    }
+
+    ImGui::Text("Frames drawn: %llu, skipped: %llu", (unsigned long long)redraw.GetFramesDrawn(),
+        (unsigned long long)redraw.GetFramesSkipped());
+    ImGui::Text("Last redraw: %s", reasons.empty() ? "-" : reasons.c_str());
+
+    RenderThread& renderThread = RenderThread::GetInstance();
+    bool renderThreadEnabled = renderThread.IsEnabled();
+    if (ImGui::Checkbox("Render Thread", &renderThreadEnabled))
+        renderThread.SetEnabled(renderThreadEnabled);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Draws each frame on its own thread while the next one is simulated");
+
+    ImGui::Text("Render thread: %s, submit %.2f ms, main waited %.2f ms", renderThread.IsRunning() ? "on" : "off",
+        renderThread.GetSubmitMs(), renderThread.GetWaitMs());
+    ImGui::Text("Pipeline drains (loads, deletions): %u", renderThread.GetSyncCount());
 }
 
 void ModuleEditor::DrawHardwareInfo()
@@ -320,7 +463,7 @@ void ModuleEditor::DrawHardwareInfo()
 #endif
 
     // GPU
-    ImGui::Text("GPU: %s", glGetString(GL_RENDERER));
+    ImGui::Text("GPU: %s", gpuName.c_str());
 
     // Libraries versions
     ImGui::Separator();
@@ -334,16 +477,15 @@ void ModuleEditor::DrawHardwareInfo()
     ImGui::BulletText("SDL3: %d.%d.%d", major, minor, patch);
 
 	// OpenGL
-    ImGui::BulletText("OpenGL: %s", glGetString(GL_VERSION));
+    ImGui::BulletText("OpenGL: %s", glVersion.c_str());
 	// ImGui
     ImGui::BulletText("ImGui: %s", IMGUI_VERSION);
 
-	// DevIL
-    ILint devilVersion = ilGetInteger(IL_VERSION_NUM);
-    int devilMajor = devilVersion / 100;
-    int devilMinor = (devilVersion / 10) % 10;
-    int devilPatch = devilVersion % 10;
-    ImGui::BulletText("DevIL: %d.%d.%d", devilMajor, devilMinor, devilPatch);
+	// stb_image
+    ImGui::BulletText("stb_image");
+
+	// LZ4
+    ImGui::BulletText("LZ4: %s", LZ4_versionString());
 }
 
 void ModuleEditor::DrawWindowSettings()
@@ -547,6 +689,22 @@ void ModuleEditor::DrawInspectorWindow()
             ImGui::Text("Indices: %d", (int)mesh.indices.size());
             ImGui::Text("Triangles: %d", (int)mesh.indices.size() / 3);
 
+            // Level of detail
+            if (mesh.lods.empty())
+            {
+                ImGui::TextDisabled("LODs: none");
+            }
+            else
+            {
+                unsigned int lod = meshComp->GetCurrentLOD();
+                int fullTriangles = (int)mesh.indices.size() / 3;
+                int lodTriangles = (int)mesh.GetLODIndexCount(lod) / 3;
+
+                ImGui::Text("LODs: %d", (int)mesh.GetLODCount());
+                ImGui::Text("Active LOD: %u (%d triangles)", lod, lodTriangles);
+                ImGui::Text("Saved this frame: %d triangles", fullTriangles - lodTriangles);
+            }
+
             ImGui::Separator();
 
             // Normals visualization
@@ -584,6 +742,11 @@ void ModuleEditor::DrawInspectorWindow()
 
             ImGui::Text("Size: %d x %d pixels", materialComp->GetTextureWidth(), materialComp->GetTextureHeight());
 
+            const char* alphaModes[] = { "Opaque", "Cutout", "Blend" };
+            ImGui::Text("Alpha: %s", alphaModes[static_cast<int>(materialComp->GetAlphaMode())]);
+            ImGui::Text("Format: %s, %d mips, %.1f KB", materialComp->GetTextureFormatName(),
+                materialComp->GetTextureMipCount(), materialComp->GetTextureMemory() / 1024.0f);
+
             ImGui::Separator();
 
             if (materialComp->HasOriginalTexture())
@@ -787,6 +950,101 @@ void ModuleEditor::DrawRendererSettings()
     }
     if (ImGui::IsItemHovered()) ImGui::SetTooltip("Render meshes as wireframes");
 
+    ImGui::Spacing();
+
+    // Mesh LODs
+    bool meshLOD = renderer->IsMeshLODEnabled();
+    if (ImGui::Checkbox("Mesh LODs", &meshLOD))
+    {
+        renderer->SetMeshLOD(meshLOD);
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Draw simplified versions of meshes that are small on screen");
+
+    bool frustumCulling = renderer->IsFrustumCullingEnabled();
+    if (ImGui::Checkbox("Frustum Culling", &frustumCulling))
+    {
+        renderer->SetFrustumCulling(frustumCulling);
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Skip objects outside the camera view (scene octree query)");
+
+    if (frustumCulling)
+    {
+        ImGui::Indent();
+
+        bool occlusionCulling = renderer->IsOcclusionCullingEnabled();
+        if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling))
+        {
+            renderer->SetOcclusionCulling(occlusionCulling);
+        }
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Skip objects hidden behind large occluders (CPU depth buffer)");
+
+        if (occlusionCulling)
+        {
+            const OcclusionCuller::Stats& occlusion = renderer->GetOcclusionStats();
+            ImGui::Text("Occluders: %u (%u triangles)", occlusion.occluders, occlusion.occluderTriangles);
+            ImGui::Text("Occluded: %u of %u tested", occlusion.occluded, occlusion.tested);
+            ImGui::Text("Raster: %.3f ms, tests: %.3f ms", occlusion.rasterMs, occlusion.testMs);
+        }
+
+        ImGui::Unindent();
+
+        ImGui::Text("Visible objects: %u of %d", renderer->GetVisibleObjectCount(),
+            (int)Application::GetInstance().scene->GetOctree().GetObjectCount());
+    }
+
+    const Renderer::LODStats& lodStats = renderer->GetLODStats();
+    ImGui::Text("Triangles drawn: %u", lodStats.trianglesDrawn);
+    ImGui::Text("Triangles saved by LODs: %u", lodStats.trianglesSaved);
+
+    ImGui::Spacing();
+
+    // Opaque pass ordering
+    bool frontToBack = renderer->IsFrontToBackSortingEnabled();
+    if (ImGui::Checkbox("Front-to-back Opaque", &frontToBack))
+    {
+        renderer->SetFrontToBackSorting(frontToBack);
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Sort opaque meshes by view depth so hidden pixels fail the depth test early");
+
+    bool depthPrepass = renderer->IsDepthPrepassEnabled();
+    if (ImGui::Checkbox("Depth Pre-pass", &depthPrepass))
+    {
+        renderer->SetDepthPrepass(depthPrepass);
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Lay down opaque depth first, then shade every pixel once");
+
+    bool overdrawView = renderer->IsOverdrawViewEnabled();
+    if (ImGui::Checkbox("Overdraw View", &overdrawView))
+    {
+        renderer->SetOverdrawView(overdrawView);
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Show how many times each pixel is shaded (brighter = more overdraw)");
+
+    const Renderer::PassStats& passStats = renderer->GetPassStats();
+    ImGui::Text("Opaque: %u, cutout: %u, transparent: %u", passStats.opaqueDraws, passStats.cutoutDraws, passStats.transparentObjects);
+    ImGui::Text("Opaque pass texture binds: %u", passStats.textureBinds);
+
+    // Greyed out without GL_ARB_bindless_texture (e.g. software drivers), the binding path is used then
+    bool bindless = renderer->IsBindlessEnabled() && renderer->IsBindlessSupported();
+    if (!renderer->IsBindlessSupported()) ImGui::BeginDisabled();
+    if (ImGui::Checkbox("Bindless Textures", &bindless))
+    {
+        renderer->SetBindless(bindless);
+    }
+    if (!renderer->IsBindlessSupported()) ImGui::EndDisabled();
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) ImGui::SetTooltip(renderer->IsBindlessSupported() ?
+        "Opaque materials read resident texture handles from a storage buffer, no binds per material\n(off: texture arrays and binds)" :
+        "GL_ARB_bindless_texture is not available, textures are bound per material");
+    ImGui::Text("Bindless: %u textures this frame, %u resident", BindlessTextures::GetInstance().GetFrameTextureCount(),
+        BindlessTextures::GetInstance().GetResidentCount());
+
+    const ShaderManager::Stats& shaderStats = ShaderManager::GetInstance().GetStats();
+    ImGui::Text("Shaders: %u variants, %u from cache, %u compiled, %u failed (%.1f ms)", ShaderManager::GetInstance().GetVariantCount(),
+        shaderStats.cacheHits, shaderStats.compiled, shaderStats.failed, shaderStats.buildMs);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Binary cache: %s\nParallel compile: %s",
+        ShaderManager::GetInstance().IsBinaryCacheSupported() ? "yes" : "no",
+        ShaderManager::GetInstance().IsParallelCompileSupported() ? "yes" : "no");
+
     ImGui::Spacing();
     ImGui::Separator();
 
@@ -862,6 +1120,101 @@ void ModuleEditor::DrawRendererSettings()
     ImGui::Spacing();
 }
 
+void ModuleEditor::DrawTextureStreaming()
+{
+    TextureStreamer& streamer = TextureStreamer::GetInstance();
+
+    bool streaming = streamer.IsEnabled();
+    if (ImGui::Checkbox("Texture Streaming", &streaming))
+    {
+        streamer.SetEnabled(streaming);
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Load small mips first and stream finer ones by on-screen size\n(applies to textures loaded afterwards)");
+
+    int budgetMB = static_cast<int>(streamer.GetBudget() / (1024 * 1024));
+    if (ImGui::SliderInt("VRAM Budget (MB)", &budgetMB, 16, 2048))
+    {
+        streamer.SetBudget(static_cast<size_t>(budgetMB) * 1024 * 1024);
+    }
+
+    float residentMB = streamer.GetResidentBytes() / (1024.0f * 1024.0f);
+    char overlay[64];
+    snprintf(overlay, sizeof(overlay), "%.1f / %d MB", residentMB, budgetMB);
+    ImGui::ProgressBar(budgetMB > 0 ? residentMB / budgetMB : 0.0f, ImVec2(-1.0f, 0.0f), overlay);
+
+    ImGui::Text("Loads in flight: %u", streamer.GetLoadsInFlight());
+
+    TextureArrays& arrays = TextureArrays::GetInstance();
+    bool packing = arrays.IsEnabled();
+    if (ImGui::Checkbox("Pack Small Textures", &packing))
+    {
+        arrays.SetEnabled(packing);
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Put small textures of the same size and format into shared array textures\n(applies to textures loaded afterwards)");
+    ImGui::Text("Texture arrays: %u, %u layers used, %.1f MB", arrays.GetArrayCount(), arrays.GetUsedLayers(), arrays.GetMemorySize() / (1024.0f * 1024.0f));
+
+    TextureUploader& uploader = TextureUploader::GetInstance();
+    ImGui::Text("Queued uploads: %u levels, %.1f MB", uploader.GetPendingLevels(), uploader.GetPendingBytes() / (1024.0f * 1024.0f));
+
+    ImGui::Separator();
+
+    // Level 0 is the full size texture, higher levels are smaller mips
+    for (const TextureStreamer::TextureInfo& info : streamer.GetTextureInfo())
+    {
+        const std::string& path = info.texture->GetPath();
+        size_t nameStart = path.find_last_of("\\/");
+        std::string name = nameStart == std::string::npos ? path : path.substr(nameStart + 1);
+
+        ImGui::Text("%s  %dx%d  mip %d / desired %d%s  %.1f KB", name.c_str(),
+            info.texture->GetWidth(), info.texture->GetHeight(), info.residentLevel, info.desiredLevel,
+            info.loading ? " (loading)" : "", info.texture->GetMemorySize() / 1024.0f);
+    }
+}
+
+void ModuleEditor::DrawFileSystemInfo()
+{
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+
+    // Later mounts are searched first
+    for (const VirtualFileSystem::MountInfo& mount : vfs.GetMounts())
+    {
+        if (mount.pack)
+            ImGui::BulletText("%s/  <-  %s (pack, %u files)", mount.mountPoint.c_str(), mount.source.c_str(), mount.entryCount);
+        else
+            ImGui::BulletText("%s/  <-  %s", mount.mountPoint.c_str(), mount.source.c_str());
+    }
+
+    ImGui::Text("Queued reads: %u", vfs.GetPendingReads());
+    ImGui::Text("Read so far: %.1f MB", vfs.GetBytesRead() / (1024.0 * 1024.0));
+
+    FileSystem* filesystem = Application::GetInstance().filesystem.get();
+    if (filesystem->IsWatchingAssets())
+        ImGui::Text("Hot reload: on, %u re-imports running", filesystem->GetPendingReloads());
+    else
+        ImGui::TextDisabled("Hot reload: off (no Assets folder)");
+
+    AssetDatabase& assets = AssetDatabase::GetInstance();
+    if (assets.IsOpen())
+    {
+        const AssetRefreshStats& refresh = assets.GetLastRefresh();
+        ImGui::Text("Asset database: %u assets", assets.GetAssetCount());
+        ImGui::Text("Last refresh: %u hashed, %u cooked, %u up to date (%.1f ms)",
+            refresh.hashed, refresh.cooked, refresh.upToDate, refresh.ms);
+
+        if (ImGui::Button("Refresh Library"))
+        {
+            assets.Refresh();
+        }
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Hash the Assets folder and cook, in parallel, only what changed since the last cook");
+    }
+
+    if (ImGui::Button("Build Assets Pack"))
+    {
+        Application::GetInstance().filesystem->BuildAssetsPack();
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Pack the Assets folder into Assets.pack next to the executable and mount it");
+}
+
 void ModuleEditor::DrawConsoleWindow()
 {
     ImGui::Begin("Console", &showConsole);
@@ -903,7 +1256,7 @@ void ModuleEditor::DrawConsoleWindow()
         bool isLoading = false;
         bool isLibraryInfo = false;
 
-        if (log.find("DevIL") != std::string::npos || log.find("SDL3") != std::string::npos || log.find("OpenGL") != std::string::npos || log.find("ASSIMP") != std::string::npos || log.find("Mesh processed") != std::string::npos)
+        if (log.find("stb_image") != std::string::npos || log.find("SDL3") != std::string::npos || log.find("OpenGL") != std::string::npos || log.find("ASSIMP") != std::string::npos || log.find("Mesh processed") != std::string::npos)
         {
             color = ImVec4(0.5f, 0.5f, 0.5f, 1.0f);
             isLibraryInfo = true;
@@ -985,17 +1338,15 @@ void ModuleEditor::DrawAboutWindow()
     ImGui::BulletText("SDL3: %d.%d.%d", major, minor, patch);
 
     // OpenGL
-    ImGui::BulletText("OpenGL: %s", glGetString(GL_VERSION));
+    ImGui::BulletText("OpenGL: %s", glVersion.c_str());
 
     // ImGui
     ImGui::BulletText("ImGui: %s", IMGUI_VERSION);
 
-    // DevIL
-    ILint devilVersion = ilGetInteger(IL_VERSION_NUM);
-    int devilMajor = devilVersion / 100;
-    int devilMinor = (devilVersion / 10) % 10;
-    int devilPatch = devilVersion % 10;
-    ImGui::BulletText("DevIL: %d.%d.%d", devilMajor, devilMinor, devilPatch);
+    // stb_image
+    ImGui::BulletText("stb_image");
+
+    ImGui::BulletText("LZ4");
 
     ImGui::BulletText("Glad");
 
@@ -1136,16 +1487,9 @@ void ModuleEditor::SelectGameObjectAndChildren(GameObject* gameObject)
     if (gameObject == nullptr)
         return;
 
-    // Add GameObject to selection
+    // Add GameObject and all its children to selection
     SelectionManager* selectionManager = Application::GetInstance().selectionManager;
-    selectionManager->AddToSelection(gameObject);
-
-    // Recursively add all children
-    const std::vector<GameObject*>& children = gameObject->GetChildren();
-    for (GameObject* child : children)
-    {
-        SelectGameObjectAndChildren(child);
-    }
+    selectionManager->AddHierarchyToSelection(gameObject);
 }
 
 void ModuleEditor::HandleDeleteKey()
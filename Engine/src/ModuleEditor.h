@@ -34,6 +34,8 @@ private:
     void DrawWindowSettings();
     void DrawCameraSettings();
     void DrawRendererSettings();
+    void DrawTextureStreaming();
+    void DrawFileSystemInfo();
 
     // Hierarchy
     void DrawHierarchyWindow();
@@ -55,6 +57,10 @@ private:
 
     void HandleDeleteKey();
 
+    // Draw data is rebuilt by the next ImGui frame, the render thread draws a copy of it
+    void QueueDrawData(ImDrawData* drawData);
+    void FreeDrawDataCopy(ImDrawData& copy);
+
 private:
 
     // FPS
@@ -101,4 +107,11 @@ private:
     float cameraScrollSpeed = 0.5f;
     float cameraFOV = 45.0f;
     float cameraPanSensitivity = 0.003f;
+
+    // Read once at Start, only the render thread has a context afterwards
+    std::string gpuName;
+    std::string glVersion;
+
+    ImDrawData drawDataCopies[2];
+    int drawDataIndex = 0;
 };
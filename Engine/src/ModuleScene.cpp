@@ -3,6 +3,11 @@
 #include "FileSystem.h"
 #include "GameObject.h"
 #include "Application.h"
+#include "Transform.h"
+#include "ComponentMesh.h"
+#include "SceneSerializer.h"
+#include "RedrawScheduler.h"
+#include <limits>
 
 ModuleScene::ModuleScene() : Module()
 {
@@ -34,8 +39,22 @@ bool ModuleScene::Start()
     return true;
 }
 
+bool ModuleScene::FixedUpdate()
+{
+    if (root)
+    {
+        root->FixedUpdate();
+    }
+    return true;
+}
+
 bool ModuleScene::Update()
 {
+    if (!pendingScenePath.empty())
+    {
+        LoadPendingScene();
+    }
+
     if (root)
     {
         root->Update();
@@ -58,6 +77,9 @@ bool ModuleScene::CleanUp()
         delete root;
         root = nullptr;
     }
+
+    octree.Clear();
+    pendingSpatialUpdates.clear();
     return true;
 }
 
@@ -91,4 +113,126 @@ void ModuleScene::CleanupMarkedObjects(GameObject* parent)
             CleanupMarkedObjects(child);
         }
     }
-}
\ No newline at end of file
+}
+
+bool ModuleScene::SaveScene(const std::string& path)
+{
+    return SceneSerializer::GetInstance().Save(root, path);
+}
+
+void ModuleScene::LoadScene(const std::string& path)
+{
+    pendingScenePath = path;
+
+    // Loaded at the start of the next frame, which has to run even if nothing else changes
+    RedrawScheduler::GetInstance().RequestRedraw(RedrawReason::Import);
+}
+
+void ModuleScene::LoadPendingScene()
+{
+    std::string path = pendingScenePath;
+    pendingScenePath.clear();
+
+    // Built under a new root while the old scene is alive, the meshes and textures
+    // both use are shared instead of being freed and loaded again
+    GameObject* newRoot = new GameObject("Root");
+    if (!SceneSerializer::GetInstance().Load(path, newRoot))
+    {
+        delete newRoot;
+        return;
+    }
+
+    Application::GetInstance().selectionManager->ClearSelection();
+
+    GameObject* oldRoot = root;
+    root = newRoot;
+    delete oldRoot;
+}
+
+const Octree& ModuleScene::GetOctree()
+{
+    UpdateSpatialIndex();
+    return octree;
+}
+
+void ModuleScene::MarkSpatialDirty(GameObject* gameObject)
+{
+    if (gameObject != nullptr)
+    {
+        pendingSpatialUpdates.insert(gameObject);
+    }
+}
+
+void ModuleScene::RemoveFromSpatialIndex(GameObject* gameObject)
+{
+    pendingSpatialUpdates.erase(gameObject);
+    octree.Remove(gameObject);
+}
+
+bool ModuleScene::IsInScene(GameObject* gameObject) const
+{
+    while (gameObject != nullptr)
+    {
+        if (gameObject == root) return true;
+        gameObject = gameObject->GetParent();
+    }
+    return false;
+}
+
+void ModuleScene::UpdateSpatialIndex()
+{
+    if (pendingSpatialUpdates.empty()) return;
+
+    for (GameObject* gameObject : pendingSpatialUpdates)
+    {
+        // Detached objects are not part of any query
+        if (!IsInScene(gameObject))
+        {
+            octree.Remove(gameObject);
+            continue;
+        }
+
+        Transform* transform = static_cast<Transform*>(gameObject->GetComponent(ComponentType::TRANSFORM));
+
+        AABB bounds;
+        if (transform != nullptr)
+        {
+            const glm::mat4& globalMatrix = transform->GetGlobalMatrix();
+
+            for (Component* component : gameObject->GetComponentsOfType(ComponentType::MESH))
+            {
+                ComponentMesh* meshComp = static_cast<ComponentMesh*>(component);
+                if (meshComp->HasMesh())
+                {
+                    bounds.Enclose(meshComp->GetLocalAABB().Transformed(globalMatrix));
+                }
+            }
+        }
+
+        if (bounds.IsValid())
+            octree.Insert(gameObject, bounds);
+        else
+            octree.Remove(gameObject);
+    }
+
+    pendingSpatialUpdates.clear();
+}
+
+GameObject* ModuleScene::Raycast(const glm::vec3& origin, const glm::vec3& direction, float& distance)
+{
+    std::vector<OctreeRayHit> hits;
+    GetOctree().QueryRay(origin, direction, std::numeric_limits<float>::max(), hits);
+
+    for (const OctreeRayHit& hit : hits)
+    {
+        ComponentMesh* mesh = static_cast<ComponentMesh*>(hit.gameObject->GetComponent(ComponentType::MESH));
+
+        if (mesh && mesh->IsActive() && hit.gameObject->IsActiveInHierarchy())
+        {
+            distance = hit.distance;
+            return hit.gameObject;
+        }
+    }
+
+    return nullptr;
+}
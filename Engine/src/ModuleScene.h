@@ -1,5 +1,8 @@
 ﻿#pragma once
 #include "Module.h"
+#include "Octree.h"
+#include <unordered_set>
+#include <string>
 
 class GameObject;
 class FileSystem;
@@ -13,6 +16,7 @@ public:
 
     bool Awake() override;
     bool Start() override;
+    bool FixedUpdate() override;
     bool Update() override;
 	bool PostUpdate() override;
     bool CleanUp() override;
@@ -23,10 +27,33 @@ public:
 
     void CleanupMarkedObjects(GameObject* parent);
 
+    // Binary scene files (SceneSerializer). Loading replaces the whole scene and is
+    // deferred to the next Update, so no object is deleted in the middle of a frame.
+    bool SaveScene(const std::string& path);
+    void LoadScene(const std::string& path);
+
+    // Loose octree of the world space mesh bounds, brought up to date before it is returned
+    const Octree& GetOctree();
+
+    // Queue an object whose world bounds may have changed (moved, reparented, new mesh)
+    void MarkSpatialDirty(GameObject* gameObject);
+    void RemoveFromSpatialIndex(GameObject* gameObject);
+
+    // Closest active object with a mesh whose bounds the ray hits
+    GameObject* Raycast(const glm::vec3& origin, const glm::vec3& direction, float& distance);
+
 private:
+    void UpdateSpatialIndex();
+    bool IsInScene(GameObject* gameObject) const;
+    void LoadPendingScene();
 
     GameObject* root = nullptr;
 
+    Octree octree;
+    std::unordered_set<GameObject*> pendingSpatialUpdates;
+
+    std::string pendingScenePath;
+
 	Renderer* renderer = nullptr;
 	FileSystem* filesystem = nullptr;
 };
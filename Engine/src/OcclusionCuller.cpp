@@ -0,0 +1,271 @@
+#include "OcclusionCuller.h"
+#include "AABB.h"
+#include "FileSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Depth bias for the box test, keeps occluders from hiding themselves through rounding
+#define OCCLUSION_DEPTH_BIAS 1e-5f
+
+static float ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+OcclusionCuller::OcclusionCuller(int width, int height)
+    : width(width), height(height), viewProjection(1.0f)
+{
+    // Allocate the whole pyramid once
+    int levelWidth = width;
+    int levelHeight = height;
+
+    while (true)
+    {
+        levelSizes.push_back(glm::ivec2(levelWidth, levelHeight));
+        levels.emplace_back(static_cast<size_t>(levelWidth) * levelHeight, 1.0f);
+
+        if (levelWidth == 1 && levelHeight == 1) break;
+
+        levelWidth = std::max(1, (levelWidth + 1) / 2);
+        levelHeight = std::max(1, (levelHeight + 1) / 2);
+    }
+}
+
+void OcclusionCuller::BeginFrame(const glm::mat4& viewProjectionMatrix)
+{
+    viewProjection = viewProjectionMatrix;
+    std::fill(levels.front().begin(), levels.front().end(), 1.0f);
+    stats = Stats();
+}
+
+void OcclusionCuller::AddOccluder(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const glm::mat4& modelMatrix)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    glm::mat4 modelViewProjection = viewProjection * modelMatrix;
+
+    std::vector<glm::vec4> clipPositions(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        clipPositions[i] = modelViewProjection * glm::vec4(vertices[i].position, 1.0f);
+    }
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        RasterizeTriangle(clipPositions[indices[i]], clipPositions[indices[i + 1]], clipPositions[indices[i + 2]]);
+    }
+
+    ++stats.occluders;
+    stats.occluderTriangles += static_cast<unsigned int>(indices.size() / 3);
+    stats.rasterMs += ElapsedMs(start);
+}
+
+void OcclusionCuller::RasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+    // Near plane clipping in clip space (z >= -w), a triangle becomes at most a quad
+    const glm::vec4 input[3] = { a, b, c };
+    glm::vec4 clipped[4];
+    int count = 0;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const glm::vec4& current = input[i];
+        const glm::vec4& next = input[(i + 1) % 3];
+
+        float currentDistance = current.z + current.w;
+        float nextDistance = next.z + next.w;
+
+        if (currentDistance >= 0.0f)
+            clipped[count++] = current;
+
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+        {
+            float t = currentDistance / (currentDistance - nextDistance);
+            clipped[count++] = current + (next - current) * t;
+        }
+    }
+
+    if (count < 3) return;
+
+    glm::vec3 screen[4];
+    for (int i = 0; i < count; ++i)
+    {
+        float w = clipped[i].w;
+        if (w <= 0.0f) return;
+
+        float invW = 1.0f / w;
+        screen[i] = glm::vec3(
+            (clipped[i].x * invW * 0.5f + 0.5f) * width,
+            (clipped[i].y * invW * 0.5f + 0.5f) * height,
+            std::min(1.0f, clipped[i].z * invW * 0.5f + 0.5f));
+    }
+
+    RasterizeScreenTriangle(screen[0], screen[1], screen[2]);
+    if (count == 4)
+        RasterizeScreenTriangle(screen[0], screen[2], screen[3]);
+}
+
+void OcclusionCuller::RasterizeScreenTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (std::abs(area) < 1e-8f) return;
+
+    // Occluders are drawn double sided: orient every triangle counter-clockwise
+    const glm::vec3& v0 = a;
+    const glm::vec3& v1 = area > 0.0f ? b : c;
+    const glm::vec3& v2 = area > 0.0f ? c : b;
+    area = std::abs(area);
+
+    int minX = std::max(0, static_cast<int>(std::floor(std::min(v0.x, std::min(v1.x, v2.x)))));
+    int maxX = std::min(width - 1, static_cast<int>(std::ceil(std::max(v0.x, std::max(v1.x, v2.x)))));
+    int minY = std::max(0, static_cast<int>(std::floor(std::min(v0.y, std::min(v1.y, v2.y)))));
+    int maxY = std::min(height - 1, static_cast<int>(std::ceil(std::max(v0.y, std::max(v1.y, v2.y)))));
+
+    if (minX > maxX || minY > maxY) return;
+
+    // Edge functions E(x, y) = A x + B y + C, stepped per pixel
+    float a12 = v1.y - v2.y, b12 = v2.x - v1.x, c12 = v1.x * v2.y - v2.x * v1.y;
+    float a20 = v2.y - v0.y, b20 = v0.x - v2.x, c20 = v2.x * v0.y - v0.x * v2.y;
+    float a01 = v0.y - v1.y, b01 = v1.x - v0.x, c01 = v0.x * v1.y - v1.x * v0.y;
+
+    float invArea = 1.0f / area;
+    float startX = minX + 0.5f;
+
+    std::vector<float>& depth = levels.front();
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        float sampleY = y + 0.5f;
+
+        float w0 = a12 * startX + b12 * sampleY + c12;
+        float w1 = a20 * startX + b20 * sampleY + c20;
+        float w2 = a01 * startX + b01 * sampleY + c01;
+
+        float* row = &depth[static_cast<size_t>(y) * width];
+
+        for (int x = minX; x <= maxX; ++x)
+        {
+            if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f)
+            {
+                float z = (w0 * v0.z + w1 * v1.z + w2 * v2.z) * invArea;
+                if (z < row[x]) row[x] = z;
+            }
+
+            w0 += a12;
+            w1 += a20;
+            w2 += a01;
+        }
+    }
+}
+
+void OcclusionCuller::EndOccluders()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (size_t level = 1; level < levels.size(); ++level)
+    {
+        const std::vector<float>& source = levels[level - 1];
+        std::vector<float>& target = levels[level];
+
+        glm::ivec2 sourceSize = levelSizes[level - 1];
+        glm::ivec2 targetSize = levelSizes[level];
+
+        for (int y = 0; y < targetSize.y; ++y)
+        {
+            int y0 = std::min(y * 2, sourceSize.y - 1);
+            int y1 = std::min(y * 2 + 1, sourceSize.y - 1);
+
+            for (int x = 0; x < targetSize.x; ++x)
+            {
+                int x0 = std::min(x * 2, sourceSize.x - 1);
+                int x1 = std::min(x * 2 + 1, sourceSize.x - 1);
+
+                float farthest = std::max(
+                    std::max(source[y0 * sourceSize.x + x0], source[y0 * sourceSize.x + x1]),
+                    std::max(source[y1 * sourceSize.x + x0], source[y1 * sourceSize.x + x1]));
+
+                target[y * targetSize.x + x] = farthest;
+            }
+        }
+    }
+
+    stats.rasterMs += ElapsedMs(start);
+}
+
+bool OcclusionCuller::IsOccluded(const AABB& worldBounds)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    ++stats.tested;
+
+    float minX = static_cast<float>(width), maxX = 0.0f;
+    float minY = static_cast<float>(height), maxY = 0.0f;
+    float nearestDepth = 1.0f;
+
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        glm::vec3 point(
+            (corner & 1) ? worldBounds.max.x : worldBounds.min.x,
+            (corner & 2) ? worldBounds.max.y : worldBounds.min.y,
+            (corner & 4) ? worldBounds.max.z : worldBounds.min.z);
+
+        glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+
+        // Box reaches the near plane: it is right in front of the camera
+        if (clip.z < -clip.w || clip.w <= 0.0f)
+        {
+            stats.testMs += ElapsedMs(start);
+            return false;
+        }
+
+        float invW = 1.0f / clip.w;
+        float x = (clip.x * invW * 0.5f + 0.5f) * width;
+        float y = (clip.y * invW * 0.5f + 0.5f) * height;
+        float z = clip.z * invW * 0.5f + 0.5f;
+
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearestDepth = std::min(nearestDepth, z);
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+    int x1 = std::min(width - 1, static_cast<int>(std::floor(maxX)));
+    int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+    int y1 = std::min(height - 1, static_cast<int>(std::floor(maxY)));
+
+    // Off screen boxes are left to the frustum test
+    if (x0 > x1 || y0 > y1)
+    {
+        stats.testMs += ElapsedMs(start);
+        return false;
+    }
+
+    // Coarsest level where the rectangle still spans only a couple of texels
+    size_t level = 0;
+    int span = std::max(x1 - x0, y1 - y0);
+    while (span > 2 && level + 1 < levels.size())
+    {
+        span >>= 1;
+        ++level;
+    }
+
+    const std::vector<float>& depth = levels[level];
+    int levelWidth = levelSizes[level].x;
+
+    float farthest = 0.0f;
+    for (int y = y0 >> level; y <= (y1 >> level); ++y)
+    {
+        for (int x = x0 >> level; x <= (x1 >> level); ++x)
+        {
+            farthest = std::max(farthest, depth[y * levelWidth + x]);
+        }
+    }
+
+    bool occluded = nearestDepth > farthest + OCCLUSION_DEPTH_BIAS;
+    if (occluded) ++stats.occluded;
+
+    stats.testMs += ElapsedMs(start);
+    return occluded;
+}
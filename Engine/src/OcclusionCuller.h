@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+
+struct AABB;
+struct Vertex;
+
+// CPU occlusion culling. A few large occluders are software rasterized into a
+// small depth buffer, which is reduced into a max-depth pyramid (HiZ). A box is
+// occluded when its nearest depth is behind the farthest occluder depth over
+// the whole screen rectangle it covers.
+// Pure CPU, no GL calls, so it runs the same with or without a window.
+class OcclusionCuller
+{
+public:
+    struct Stats {
+        unsigned int occluders = 0;
+        unsigned int occluderTriangles = 0;
+        unsigned int tested = 0;
+        unsigned int occluded = 0;
+        float rasterMs = 0.0f;
+        float testMs = 0.0f;
+    };
+
+    OcclusionCuller(int width = 256, int height = 128);
+
+    // Clears the depth buffer and stores the camera for this frame
+    void BeginFrame(const glm::mat4& viewProjection);
+
+    // Rasterizes an indexed triangle list (positions taken from the vertices) as an occluder
+    void AddOccluder(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const glm::mat4& modelMatrix);
+
+    // Builds the depth pyramid, call once after the occluders and before testing
+    void EndOccluders();
+
+    // True when the world space box is certainly hidden behind the occluders
+    bool IsOccluded(const AABB& worldBounds);
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    // Full resolution depth (0 near, 1 far), row 0 at the bottom
+    const std::vector<float>& GetDepthBuffer() const { return levels.front(); }
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    void RasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+    void RasterizeScreenTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+
+    int width;
+    int height;
+    glm::mat4 viewProjection;
+
+    // Level 0 is the depth buffer, every next level keeps the farthest of 2x2 texels
+    std::vector<std::vector<float>> levels;
+    std::vector<glm::ivec2> levelSizes;
+
+    Stats stats;
+};
@@ -0,0 +1,358 @@
+#include "Octree.h"
+#include "Frustum.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// Deeper cells than this are not worth the extra nodes
+#define OCTREE_MAX_DEPTH 10
+
+// Half size of the first cell, grown on demand
+#define OCTREE_MIN_ROOT_HALF_SIZE 64.0f
+
+static float GetRadius(const AABB& bounds)
+{
+    glm::vec3 extents = bounds.GetExtents();
+    return std::max(extents.x, std::max(extents.y, extents.z));
+}
+
+static int GetOctant(const glm::vec3& cellCenter, const glm::vec3& point)
+{
+    return (point.x >= cellCenter.x ? 1 : 0) | (point.y >= cellCenter.y ? 2 : 0) | (point.z >= cellCenter.z ? 4 : 0);
+}
+
+AABB Octree::Node::GetLooseBounds() const
+{
+    glm::vec3 looseExtents(halfSize * 2.0f);
+    return AABB(center - looseExtents, center + looseExtents);
+}
+
+Octree::Octree()
+{
+}
+
+void Octree::Clear()
+{
+    nodes.clear();
+    root = -1;
+    entries.clear();
+    freeEntries.clear();
+    entryLookup.clear();
+}
+
+void Octree::Insert(GameObject* gameObject, const AABB& bounds)
+{
+    if (gameObject == nullptr || !bounds.IsValid()) return;
+
+    GrowToFit(bounds);
+    int node = FindNode(bounds);
+
+    auto found = entryLookup.find(gameObject);
+    if (found != entryLookup.end())
+    {
+        Entry& entry = entries[found->second];
+        entry.bounds = bounds;
+
+        // Small moves usually stay in the same cell
+        if (entry.node != node)
+        {
+            Unlink(found->second);
+            Link(found->second, node);
+        }
+        return;
+    }
+
+    unsigned int index;
+    if (!freeEntries.empty())
+    {
+        index = freeEntries.back();
+        freeEntries.pop_back();
+    }
+    else
+    {
+        index = static_cast<unsigned int>(entries.size());
+        entries.emplace_back();
+    }
+
+    entries[index].gameObject = gameObject;
+    entries[index].bounds = bounds;
+    entryLookup[gameObject] = index;
+    Link(index, node);
+}
+
+void Octree::Remove(GameObject* gameObject)
+{
+    auto found = entryLookup.find(gameObject);
+    if (found == entryLookup.end()) return;
+
+    unsigned int index = found->second;
+    Unlink(index);
+
+    entries[index].gameObject = nullptr;
+    freeEntries.push_back(index);
+    entryLookup.erase(found);
+}
+
+bool Octree::GetBounds(GameObject* gameObject, AABB& bounds) const
+{
+    auto found = entryLookup.find(gameObject);
+    if (found == entryLookup.end()) return false;
+
+    bounds = entries[found->second].bounds;
+    return true;
+}
+
+void Octree::GrowToFit(const AABB& bounds)
+{
+    glm::vec3 center = bounds.GetCenter();
+    float radius = GetRadius(bounds);
+
+    if (root < 0)
+    {
+        Node first;
+        first.center = center;
+        first.halfSize = std::max(OCTREE_MIN_ROOT_HALF_SIZE, radius * 2.0f);
+        nodes.push_back(first);
+        root = 0;
+        return;
+    }
+
+    // The old root cell is exactly one octant of a cell twice its size, so the
+    // tree grows upwards without reinserting anything
+    while (true)
+    {
+        const Node& current = nodes[root];
+        glm::vec3 offset = center - current.center;
+
+        bool centerInside = std::abs(offset.x) <= current.halfSize &&
+            std::abs(offset.y) <= current.halfSize &&
+            std::abs(offset.z) <= current.halfSize;
+
+        if (centerInside && radius <= current.halfSize) break;
+
+        Node grown;
+        grown.halfSize = current.halfSize * 2.0f;
+        grown.center = current.center + glm::vec3(
+            offset.x >= 0.0f ? current.halfSize : -current.halfSize,
+            offset.y >= 0.0f ? current.halfSize : -current.halfSize,
+            offset.z >= 0.0f ? current.halfSize : -current.halfSize);
+        grown.subtreeCount = current.subtreeCount;
+        grown.children[GetOctant(grown.center, current.center)] = root;
+
+        int grownIndex = static_cast<int>(nodes.size());
+        nodes[root].parent = grownIndex;
+        nodes.push_back(grown);
+        root = grownIndex;
+    }
+}
+
+int Octree::FindNode(const AABB& bounds)
+{
+    glm::vec3 center = bounds.GetCenter();
+    float radius = GetRadius(bounds);
+
+    int node = root;
+    for (int depth = 0; depth < OCTREE_MAX_DEPTH; ++depth)
+    {
+        if (radius > nodes[node].halfSize * 0.5f) break;
+
+        int octant = GetOctant(nodes[node].center, center);
+        int child = nodes[node].children[octant];
+        if (child < 0) child = CreateChild(node, octant);
+
+        node = child;
+    }
+
+    return node;
+}
+
+int Octree::CreateChild(int node, int octant)
+{
+    Node child;
+    child.halfSize = nodes[node].halfSize * 0.5f;
+    child.center = nodes[node].center + glm::vec3(
+        (octant & 1) ? child.halfSize : -child.halfSize,
+        (octant & 2) ? child.halfSize : -child.halfSize,
+        (octant & 4) ? child.halfSize : -child.halfSize);
+    child.parent = node;
+
+    int childIndex = static_cast<int>(nodes.size());
+    nodes.push_back(child);
+    nodes[node].children[octant] = childIndex;
+    return childIndex;
+}
+
+void Octree::Link(unsigned int entry, int node)
+{
+    Node& target = nodes[node];
+    entries[entry].node = node;
+    entries[entry].slot = static_cast<unsigned int>(target.entries.size());
+    target.entries.push_back(entry);
+
+    for (int current = node; current >= 0; current = nodes[current].parent)
+    {
+        ++nodes[current].subtreeCount;
+    }
+}
+
+void Octree::Unlink(unsigned int entry)
+{
+    int node = entries[entry].node;
+    std::vector<unsigned int>& list = nodes[node].entries;
+
+    unsigned int slot = entries[entry].slot;
+    unsigned int last = list.back();
+    list[slot] = last;
+    entries[last].slot = slot;
+    list.pop_back();
+
+    for (int current = node; current >= 0; current = nodes[current].parent)
+    {
+        --nodes[current].subtreeCount;
+    }
+
+    entries[entry].node = -1;
+}
+
+void Octree::CollectSubtree(int node, std::vector<GameObject*>& results) const
+{
+    std::vector<int> stack;
+    stack.push_back(node);
+
+    while (!stack.empty())
+    {
+        const Node& current = nodes[stack.back()];
+        stack.pop_back();
+
+        for (unsigned int entry : current.entries)
+        {
+            results.push_back(entries[entry].gameObject);
+        }
+
+        for (int child : current.children)
+        {
+            if (child >= 0 && nodes[child].subtreeCount > 0)
+                stack.push_back(child);
+        }
+    }
+}
+
+template<typename NodeTest, typename ObjectTest>
+void Octree::Traverse(NodeTest nodeTest, ObjectTest objectTest, std::vector<GameObject*>& results) const
+{
+    if (root < 0 || nodes[root].subtreeCount == 0) return;
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(root);
+
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+        Overlap overlap = nodeTest(node.GetLooseBounds());
+
+        if (overlap == Overlap::Outside) continue;
+
+        if (overlap == Overlap::Inside)
+        {
+            CollectSubtree(index, results);
+            continue;
+        }
+
+        for (unsigned int entry : node.entries)
+        {
+            if (objectTest(entries[entry].bounds))
+                results.push_back(entries[entry].gameObject);
+        }
+
+        for (int child : node.children)
+        {
+            if (child >= 0 && nodes[child].subtreeCount > 0)
+                stack.push_back(child);
+        }
+    }
+}
+
+void Octree::QueryFrustum(const Frustum& frustum, std::vector<GameObject*>& results) const
+{
+    Traverse(
+        [&frustum](const AABB& cell)
+        {
+            FrustumTest test = frustum.Test(cell);
+            if (test == FrustumTest::Outside) return Overlap::Outside;
+            return test == FrustumTest::Inside ? Overlap::Inside : Overlap::Partial;
+        },
+        [&frustum](const AABB& bounds) { return frustum.Intersects(bounds); },
+        results);
+}
+
+void Octree::QueryBox(const AABB& box, std::vector<GameObject*>& results) const
+{
+    Traverse(
+        [&box](const AABB& cell)
+        {
+            if (!box.Intersects(cell)) return Overlap::Outside;
+            return box.Contains(cell) ? Overlap::Inside : Overlap::Partial;
+        },
+        [&box](const AABB& bounds) { return box.Intersects(bounds); },
+        results);
+}
+
+void Octree::QuerySphere(const glm::vec3& center, float radius, std::vector<GameObject*>& results) const
+{
+    Traverse(
+        [&center, radius](const AABB& cell)
+        {
+            return cell.IntersectsSphere(center, radius) ? Overlap::Partial : Overlap::Outside;
+        },
+        [&center, radius](const AABB& bounds) { return bounds.IntersectsSphere(center, radius); },
+        results);
+}
+
+void Octree::QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<OctreeRayHit>& results) const
+{
+    // Huge instead of infinite slopes on axis-parallel rays keep the slab test free of NaNs
+    const float huge = std::numeric_limits<float>::max();
+    glm::vec3 invDirection(
+        std::abs(direction.x) > 1e-8f ? 1.0f / direction.x : std::copysign(huge, direction.x),
+        std::abs(direction.y) > 1e-8f ? 1.0f / direction.y : std::copysign(huge, direction.y),
+        std::abs(direction.z) > 1e-8f ? 1.0f / direction.z : std::copysign(huge, direction.z));
+
+    size_t firstResult = results.size();
+
+    if (root >= 0 && nodes[root].subtreeCount > 0)
+    {
+        std::vector<int> stack;
+        stack.reserve(64);
+        stack.push_back(root);
+
+        while (!stack.empty())
+        {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+
+            float distance;
+            if (!node.GetLooseBounds().IntersectsRay(origin, invDirection, maxDistance, distance)) continue;
+
+            for (unsigned int entry : node.entries)
+            {
+                if (entries[entry].bounds.IntersectsRay(origin, invDirection, maxDistance, distance))
+                    results.push_back({ entries[entry].gameObject, distance });
+            }
+
+            for (int child : node.children)
+            {
+                if (child >= 0 && nodes[child].subtreeCount > 0)
+                    stack.push_back(child);
+            }
+        }
+    }
+
+    std::sort(results.begin() + firstResult, results.end(), [](const OctreeRayHit& a, const OctreeRayHit& b)
+    {
+        return a.distance < b.distance;
+    });
+}
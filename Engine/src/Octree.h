@@ -0,0 +1,84 @@
+#pragma once
+
+#include "AABB.h"
+#include <vector>
+#include <unordered_map>
+
+class GameObject;
+struct Frustum;
+
+struct OctreeRayHit
+{
+    GameObject* gameObject;
+    float distance;
+};
+
+// Loose octree of world space bounds. Every object lives in exactly one node: the
+// deepest one whose cell holds the object's center and is at least as big as the
+// object, so a node's loose bounds (twice its cell) always enclose its objects and
+// moving an object never has to split it across nodes.
+class Octree
+{
+public:
+    Octree();
+
+    // Adds an object, or moves it if it is already in the tree
+    void Insert(GameObject* gameObject, const AABB& bounds);
+    void Remove(GameObject* gameObject);
+    void Clear();
+
+    bool Contains(GameObject* gameObject) const { return entryLookup.count(gameObject) != 0; }
+    bool GetBounds(GameObject* gameObject, AABB& bounds) const;
+    size_t GetObjectCount() const { return entryLookup.size(); }
+    size_t GetNodeCount() const { return nodes.size(); }
+
+    // Queries append to results; objects are reported once and in no particular order
+    void QueryFrustum(const Frustum& frustum, std::vector<GameObject*>& results) const;
+    void QueryBox(const AABB& box, std::vector<GameObject*>& results) const;
+    void QuerySphere(const glm::vec3& center, float radius, std::vector<GameObject*>& results) const;
+
+    // Objects whose bounds the ray crosses, closest first
+    void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<OctreeRayHit>& results) const;
+
+private:
+    struct Node
+    {
+        glm::vec3 center;
+        float halfSize;                 // Half size of the tight cell
+        int parent = -1;
+        int children[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+        std::vector<unsigned int> entries;
+        unsigned int subtreeCount = 0;  // Objects in this node and below, lets queries skip empty branches
+
+        AABB GetLooseBounds() const;
+    };
+
+    struct Entry
+    {
+        GameObject* gameObject = nullptr;
+        AABB bounds;
+        int node = -1;
+        unsigned int slot = 0;          // Position inside the node's entry list
+    };
+
+    enum class Overlap { Outside, Partial, Inside };
+
+    void GrowToFit(const AABB& bounds);
+    int FindNode(const AABB& bounds);
+    int CreateChild(int node, int octant);
+    void Link(unsigned int entry, int node);
+    void Unlink(unsigned int entry);
+
+    // Walks the nodes accepted by nodeTest; branches that are fully inside are
+    // collected without testing every object
+    template<typename NodeTest, typename ObjectTest>
+    void Traverse(NodeTest nodeTest, ObjectTest objectTest, std::vector<GameObject*>& results) const;
+    void CollectSubtree(int node, std::vector<GameObject*>& results) const;
+
+    std::vector<Node> nodes;
+    int root = -1;
+
+    std::vector<Entry> entries;
+    std::vector<unsigned int> freeEntries;
+    std::unordered_map<GameObject*, unsigned int> entryLookup;
+};
@@ -0,0 +1,66 @@
+#include "RedrawScheduler.h"
+#include <SDL3/SDL.h>
+
+// Longest sleep without events, the loop then checks again that nothing is pending
+#define REDRAW_IDLE_TIMEOUT_MS 250
+
+RedrawScheduler& RedrawScheduler::GetInstance()
+{
+    static RedrawScheduler instance;
+    return instance;
+}
+
+void RedrawScheduler::RequestRedraw(RedrawReason reason, int frames)
+{
+    reasons.fetch_or(static_cast<uint32_t>(reason));
+
+    int pending = pendingFrames.load();
+    while (pending < frames && !pendingFrames.compare_exchange_weak(pending, frames))
+    {
+    }
+}
+
+void RedrawScheduler::Wake()
+{
+    // One wake event in the queue is enough
+    if (wakePending.exchange(true))
+        return;
+
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = SDL_EVENT_USER;
+    SDL_PushEvent(&event);
+}
+
+void RedrawScheduler::WaitForEvents()
+{
+    if (!enabled)
+        return;
+
+    SDL_WaitEventTimeout(nullptr, REDRAW_IDLE_TIMEOUT_MS);
+    wakePending = false;
+}
+
+bool RedrawScheduler::BeginFrame()
+{
+    if (!enabled)
+    {
+        framesDrawn++;
+        lastReasons = 0;
+        return true;
+    }
+
+    int pending = pendingFrames.load();
+    do
+    {
+        if (pending <= 0)
+        {
+            framesSkipped++;
+            return false;
+        }
+    } while (!pendingFrames.compare_exchange_weak(pending, pending - 1));
+
+    framesDrawn++;
+    lastReasons = reasons.exchange(0);
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// What asked for a redraw, kept as a mask for the editor stats
+enum class RedrawReason : uint32_t
+{
+    Input     = 1 << 0,
+    Transform = 1 << 1,
+    Camera    = 1 << 2,
+    Import    = 1 << 3,
+    UI        = 1 << 4,
+    Streaming = 1 << 5
+};
+
+// Decides whether a loop iteration draws. Every source of visible change requests a few
+// frames; when none is pending the loop blocks on the SDL event queue instead of spinning,
+// and the last presented frame simply stays on screen.
+class RedrawScheduler
+{
+public:
+    static RedrawScheduler& GetInstance();
+
+    // Thread safe. ImGui needs a frame after the change to show it, hence the default of two.
+    void RequestRedraw(RedrawReason reason, int frames = 2);
+    // Thread safe: wakes a main loop that is waiting for events
+    void Wake();
+
+    bool IsRedrawPending() const { return !enabled || pendingFrames.load() > 0; }
+    // Sleeps until an SDL event arrives or the idle timeout passes, does not consume the event
+    void WaitForEvents();
+
+    // Application, after the events of the iteration were pumped: true if this iteration draws
+    bool BeginFrame();
+
+    bool IsEnabled() const { return enabled; }
+    void SetEnabled(bool enable) { enabled = enable; }
+
+    uint64_t GetFramesDrawn() const { return framesDrawn; }
+    uint64_t GetFramesSkipped() const { return framesSkipped; }
+    // Reasons behind the last drawn frame
+    uint32_t GetLastReasons() const { return lastReasons; }
+
+private:
+    RedrawScheduler() = default;
+
+    RedrawScheduler(const RedrawScheduler&) = delete;
+    RedrawScheduler& operator=(const RedrawScheduler&) = delete;
+
+    std::atomic<int> pendingFrames{ 2 };
+    std::atomic<uint32_t> reasons{ 0 };
+    std::atomic<bool> wakePending{ false };
+    bool enabled = true;
+
+    uint64_t framesDrawn = 0;
+    uint64_t framesSkipped = 0;
+    uint32_t lastReasons = 0;
+};
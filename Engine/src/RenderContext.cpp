@@ -1,6 +1,7 @@
 #include "RenderContext.h"
 #include "RenderContext.h"
 #include "Application.h"
+#include "RenderThread.h"
 #include <SDL3/SDL.h>
 #include <glad/glad.h>
 #include <iostream>
@@ -48,7 +49,10 @@ bool RenderContext::Start()
 bool RenderContext::PreUpdate()
 {
     // Clear buffers
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    RenderThread::GetInstance().Enqueue([]()
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    });
 
     return true;
 }
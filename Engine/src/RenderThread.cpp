@@ -0,0 +1,189 @@
+#include "RenderThread.h"
+#include "Log.h"
+#include <future>
+#include <chrono>
+
+RenderThread& RenderThread::GetInstance()
+{
+    static RenderThread instance;
+    return instance;
+}
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+bool RenderThread::Start(SDL_Window* targetWindow, SDL_GLContext targetContext)
+{
+    if (running)
+        return true;
+
+    window = targetWindow;
+    context = targetContext;
+
+    // A context is current on one thread at a time
+    if (!SDL_GL_MakeCurrent(window, nullptr))
+    {
+        LOG_DEBUG("ERROR: Could not release the GL context - %s", SDL_GetError());
+        enabled = false;
+        return false;
+    }
+
+    stopping = false;
+    pending = false;
+
+    std::promise<bool> started;
+    std::future<bool> result = started.get_future();
+
+    thread = std::thread([this, &started]()
+    {
+        bool current = SDL_GL_MakeCurrent(window, context);
+        started.set_value(current);
+        if (current)
+            Loop();
+    });
+
+    if (!result.get())
+    {
+        thread.join();
+        SDL_GL_MakeCurrent(window, context);
+        LOG_DEBUG("ERROR: Render thread could not take the GL context - %s", SDL_GetError());
+        LOG_CONSOLE("Render thread unavailable, rendering on the main thread");
+        enabled = false;
+        return false;
+    }
+
+    threadId = thread.get_id();
+    running = true;
+
+    LOG_DEBUG("Render thread started, GL context moved off the main thread");
+    return true;
+}
+
+void RenderThread::Stop()
+{
+    if (!running)
+        return;
+
+    Submit();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    thread.join();
+
+    running = false;
+    SDL_GL_MakeCurrent(window, context);
+
+    LOG_DEBUG("Render thread stopped, GL context back on the main thread");
+}
+
+bool RenderThread::IsGLThread() const
+{
+    return !running || std::this_thread::get_id() == threadId;
+}
+
+void RenderThread::Enqueue(Command command)
+{
+    if (IsGLThread())
+    {
+        command();
+        return;
+    }
+
+    lists[recordIndex].push_back(std::move(command));
+}
+
+void RenderThread::RunSync(const Command& command)
+{
+    if (IsGLThread())
+    {
+        command();
+        return;
+    }
+
+    lists[recordIndex].push_back(command);
+    Submit();
+    WaitIdle();
+    syncCount++;
+}
+
+void RenderThread::EndFrame()
+{
+    if (running)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        Submit();
+        waitMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    else
+    {
+        waitMs = 0.0f;
+    }
+
+    lastSyncCount = syncCount;
+    syncCount = 0;
+
+    // Switched between frames, so a frame is never split across two threads
+    if (enabled && !running && window != nullptr)
+        Start(window, context);
+    else if (!enabled && running)
+        Stop();
+}
+
+void RenderThread::Submit()
+{
+    if (lists[recordIndex].empty())
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() { return !pending; });
+
+        submittedIndex = recordIndex;
+        recordIndex = 1 - recordIndex;
+        pending = true;
+    }
+    condition.notify_all();
+}
+
+void RenderThread::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this]() { return !pending; });
+}
+
+void RenderThread::Loop()
+{
+    while (true)
+    {
+        std::vector<Command>* list = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return pending || stopping; });
+
+            // Stop submits first, so nothing is left behind
+            if (!pending)
+                break;
+
+            list = &lists[submittedIndex];
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (Command& command : *list)
+            command();
+        list->clear();
+        submitMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = false;
+        }
+        condition.notify_all();
+    }
+
+    SDL_GL_MakeCurrent(window, nullptr);
+}
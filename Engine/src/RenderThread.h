@@ -0,0 +1,85 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+// Owns the GL context on a thread of its own. The main thread records the GL work of a frame
+// as a list of commands and hands it over at the end of the frame, then simulates the next one
+// while this one is submitted and presented. Two lists alternate: the main thread only writes
+// the recording one and the render thread only reads the other, so recording takes no lock and
+// the handoff is the single synchronization point of the frame.
+// Enqueued commands run while the main thread goes on, so what they log reaches the console a
+// frame later. RunSync commands block the main thread until they are done.
+class RenderThread
+{
+public:
+    typedef std::function<void()> Command;
+
+    static RenderThread& GetInstance();
+
+    // Moves the window's context to the render thread, it must be current on the calling thread
+    bool Start(SDL_Window* window, SDL_GLContext context);
+    // Runs what is still queued, joins and makes the context current on the calling thread again
+    void Stop();
+    bool IsRunning() const { return running.load(); }
+
+    // The calling thread may issue GL calls: the render thread, or any caller while it is stopped
+    bool IsGLThread() const;
+
+    // Records a command of the current frame. Runs it right away on the GL thread.
+    void Enqueue(Command command);
+    // Runs the command on the render thread after everything queued before it and waits for it.
+    // Meant for creating and deleting resources: once it returns, no frame in flight uses them.
+    void RunSync(const Command& command);
+
+    // End of the main thread's frame: waits for the previous frame to be done and hands this one over
+    void EndFrame();
+
+    // Taken into account at the next EndFrame
+    bool IsEnabled() const { return enabled; }
+    void SetEnabled(bool enable) { enabled = enable; }
+
+    // Main thread time spent waiting in the last EndFrame, render thread time of the last list
+    float GetWaitMs() const { return waitMs; }
+    float GetSubmitMs() const { return submitMs.load(); }
+    // RunSync calls made during the last frame, each one drains the pipeline
+    unsigned int GetSyncCount() const { return lastSyncCount; }
+
+private:
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Hands the recording list over, after the previous one is done
+    void Submit();
+    void WaitIdle();
+    void Loop();
+
+    SDL_Window* window = nullptr;
+    SDL_GLContext context = nullptr;
+
+    std::thread thread;
+    std::thread::id threadId;
+    std::atomic<bool> running{ false };
+    bool enabled = true;
+
+    std::vector<Command> lists[2];
+    int recordIndex = 0;        // Main thread only
+    int submittedIndex = 0;
+    bool pending = false;       // lists[submittedIndex] is handed over and not done yet
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    float waitMs = 0.0f;
+    std::atomic<float> submitMs{ 0.0f };
+    unsigned int syncCount = 0;
+    unsigned int lastSyncCount = 0;
+};
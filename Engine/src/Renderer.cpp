@@ -5,9 +5,20 @@
 #include "ComponentMesh.h"
 #include "ComponentMaterial.h"
 #include "ModuleEditor.h"
+#include "AABB.h"
+#include "Frustum.h"
+#include "ShaderManager.h"
+#include "TextureStreamer.h"
+#include "TextureUploader.h"
+#include "BindlessTextures.h"
+#include "RedrawScheduler.h"
+#include "RenderThread.h"
 
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 Renderer::Renderer()
 {
@@ -19,6 +30,15 @@ Renderer::~Renderer()
 {
 }
 
+// Smallest shader variant that can draw a material of the given alpha mode
+static unsigned int GetMaterialShaderFeatures(AlphaMode alphaMode)
+{
+    if (alphaMode == AlphaMode::Opaque)
+        return SHADER_FEATURE_TEXTURE;
+
+    return SHADER_FEATURE_TEXTURE | SHADER_FEATURE_ALPHA_TEST;
+}
+
 bool Renderer::Start()
 {
     LOG_DEBUG("=== Initializing Renderer Module ===");
@@ -32,49 +52,43 @@ bool Renderer::Start()
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Initialize default shader
-    defaultShader = make_unique<Shader>();
-
-    if (!defaultShader->Create())
+    // Submit every program before checking any of them, so the driver can build them in parallel.
+    // Programs linked on a previous run come straight from the binary cache.
+    ShaderManager& shaderManager = ShaderManager::GetInstance();
+    shaderManager.Init();
+    shaderManager.BeginBatch();
+
+    // Textured variant for opaque materials, alpha-tested one for cutout and blended materials,
+    // solid color for outlines, debug lines, the depth pre-pass and the overdraw view
+    defaultShader = shaderManager.GetVariant(GetMaterialShaderFeatures(AlphaMode::Opaque));
+    cutoutShader = shaderManager.GetVariant(GetMaterialShaderFeatures(AlphaMode::Cutout));
+    solidShader = shaderManager.GetVariant(SHADER_FEATURE_NONE);
+    arrayShader = shaderManager.GetVariant(GetMaterialShaderFeatures(AlphaMode::Opaque) | SHADER_FEATURE_TEXTURE_ARRAY);
+    arrayCutoutShader = shaderManager.GetVariant(GetMaterialShaderFeatures(AlphaMode::Cutout) | SHADER_FEATURE_TEXTURE_ARRAY);
+
+    if (!defaultShader || !cutoutShader || !solidShader || !arrayShader || !arrayCutoutShader || !shaderManager.EndBatch())
     {
-        LOG_DEBUG("ERROR: Failed to create default shader");
+        LOG_DEBUG("ERROR: Failed to build the renderer shaders");
         LOG_CONSOLE("ERROR: Failed to compile shaders");
         return false;
     }
-    else
-    {
-        LOG_DEBUG("Shader created successfully - Program ID: %d", defaultShader->GetProgramID());
-        LOG_CONSOLE("OpenGL shaders compiled successfully");
-    }
 
-    // Initialize line shader for debug visualization
-    lineShader = make_unique<Shader>();
+    // Bindless variants are optional: when the extension is missing or they do not build, materials are bound
+    BindlessTextures& bindless = BindlessTextures::GetInstance();
+    bindless.Init();
 
-    if (!lineShader->CreateSimpleColor())
-    {
-        LOG_DEBUG("ERROR: Failed to create line shader");
-        LOG_CONSOLE("ERROR: Failed to compile line shader");
-        return false;
-    }
-    else
+    if (bindless.IsSupported())
     {
-        LOG_DEBUG("Line shader created successfully - Program ID: %d", lineShader->GetProgramID());
-        LOG_CONSOLE("Line shader compiled successfully");
-    }
+        bindlessShader = shaderManager.GetVariant(GetMaterialShaderFeatures(AlphaMode::Opaque) | SHADER_FEATURE_BINDLESS);
+        bindlessCutoutShader = shaderManager.GetVariant(GetMaterialShaderFeatures(AlphaMode::Cutout) | SHADER_FEATURE_BINDLESS);
 
-    // Initialize outline shader for selection highlighting
-    outlineShader = make_unique<Shader>();
-
-    if (!outlineShader->CreateSingleColor())
-    {
-        LOG_DEBUG("ERROR: Failed to create outline shader");
-        LOG_CONSOLE("ERROR: Failed to compile outline shader");
-        return false;
-    }
-    else
-    {
-        LOG_DEBUG("Outline shader created successfully - Program ID: %d", outlineShader->GetProgramID());
-        LOG_CONSOLE("Outline shader compiled successfully");
+        if (!bindlessShader || !bindlessCutoutShader)
+        {
+            LOG_DEBUG("WARNING: Bindless shaders failed to build, using bound textures");
+            bindless.SetUnsupported();
+            bindlessShader = nullptr;
+            bindlessCutoutShader = nullptr;
+        }
     }
 
     // Generate default checkerboard texture for untextured objects
@@ -91,60 +105,299 @@ bool Renderer::Start()
     defaultUniforms.model = glGetUniformLocation(defaultShader->GetProgramID(), "model");
     defaultUniforms.texture1 = glGetUniformLocation(defaultShader->GetProgramID(), "texture1");
 
-    outlineUniforms.projection = glGetUniformLocation(outlineShader->GetProgramID(), "projection");
-    outlineUniforms.view = glGetUniformLocation(outlineShader->GetProgramID(), "view");
-    outlineUniforms.model = glGetUniformLocation(outlineShader->GetProgramID(), "model");
+    cutoutUniforms.projection = glGetUniformLocation(cutoutShader->GetProgramID(), "projection");
+    cutoutUniforms.view = glGetUniformLocation(cutoutShader->GetProgramID(), "view");
+    cutoutUniforms.model = glGetUniformLocation(cutoutShader->GetProgramID(), "model");
+    cutoutUniforms.texture1 = glGetUniformLocation(cutoutShader->GetProgramID(), "texture1");
+
+    arrayUniforms.projection = glGetUniformLocation(arrayShader->GetProgramID(), "projection");
+    arrayUniforms.view = glGetUniformLocation(arrayShader->GetProgramID(), "view");
+    arrayUniforms.model = glGetUniformLocation(arrayShader->GetProgramID(), "model");
+    arrayUniforms.texture1 = glGetUniformLocation(arrayShader->GetProgramID(), "texture1");
+    arrayUniforms.textureLayer = glGetUniformLocation(arrayShader->GetProgramID(), "textureLayer");
+
+    arrayCutoutUniforms.projection = glGetUniformLocation(arrayCutoutShader->GetProgramID(), "projection");
+    arrayCutoutUniforms.view = glGetUniformLocation(arrayCutoutShader->GetProgramID(), "view");
+    arrayCutoutUniforms.model = glGetUniformLocation(arrayCutoutShader->GetProgramID(), "model");
+    arrayCutoutUniforms.texture1 = glGetUniformLocation(arrayCutoutShader->GetProgramID(), "texture1");
+    arrayCutoutUniforms.textureLayer = glGetUniformLocation(arrayCutoutShader->GetProgramID(), "textureLayer");
+
+    if (bindless.IsSupported())
+    {
+        bindlessUniforms.projection = glGetUniformLocation(bindlessShader->GetProgramID(), "projection");
+        bindlessUniforms.view = glGetUniformLocation(bindlessShader->GetProgramID(), "view");
+        bindlessUniforms.model = glGetUniformLocation(bindlessShader->GetProgramID(), "model");
+        bindlessUniforms.materialIndex = glGetUniformLocation(bindlessShader->GetProgramID(), "materialIndex");
+
+        bindlessCutoutUniforms.projection = glGetUniformLocation(bindlessCutoutShader->GetProgramID(), "projection");
+        bindlessCutoutUniforms.view = glGetUniformLocation(bindlessCutoutShader->GetProgramID(), "view");
+        bindlessCutoutUniforms.model = glGetUniformLocation(bindlessCutoutShader->GetProgramID(), "model");
+        bindlessCutoutUniforms.materialIndex = glGetUniformLocation(bindlessCutoutShader->GetProgramID(), "materialIndex");
+    }
+
+    solidUniforms.projection = glGetUniformLocation(solidShader->GetProgramID(), "projection");
+    solidUniforms.view = glGetUniformLocation(solidShader->GetProgramID(), "view");
+    solidUniforms.model = glGetUniformLocation(solidShader->GetProgramID(), "model");
 
     return true;
 }
 
+// Occluder selection for the software occlusion pass
+#define OCCLUDER_MIN_SCREEN_SIZE 0.1f
+#define OCCLUDER_MAX_COUNT 16
+#define OCCLUDER_TRIANGLE_BUDGET 20000
+
+// Color added by every fragment in the overdraw view (about 10 layers to saturate red)
+#define OVERDRAW_COLOR glm::vec3(0.1f, 0.05f, 0.025f)
+
+// Float to IEEE half, round to nearest; only used for out of range texture coordinates
+static unsigned short FloatToHalf(float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    unsigned int sign = (bits >> 16) & 0x8000u;
+    int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+    unsigned int mantissa = bits & 0x7FFFFFu;
+
+    if (exponent <= 0) return static_cast<unsigned short>(sign);                  // Too small: signed zero
+    if (exponent >= 31) return static_cast<unsigned short>(sign | 0x7C00u);       // Too large: infinity
+
+    unsigned int half = sign | (exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000u) ++half;  // Carry may bump the exponent, which is still correct rounding
+    return static_cast<unsigned short>(half);
+}
+
+static short PackSnorm16(float value)
+{
+    value = std::max(-1.0f, std::min(1.0f, value));
+    return static_cast<short>(std::round(value * 32767.0f));
+}
+
+static unsigned short PackUnorm16(float value)
+{
+    value = std::max(0.0f, std::min(1.0f, value));
+    return static_cast<unsigned short>(std::round(value * 65535.0f));
+}
+
+// Octahedral mapping: project onto the octahedron |x|+|y|+|z| = 1 and fold the lower half over
+static void PackOctahedralNormal(const glm::vec3& normal, short out[2])
+{
+    float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (sum <= 0.0f)
+    {
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+
+    float x = normal.x / sum;
+    float y = normal.y / sum;
+
+    if (normal.z < 0.0f)
+    {
+        float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    out[0] = PackSnorm16(x);
+    out[1] = PackSnorm16(y);
+}
+
 void Renderer::LoadMesh(Mesh& mesh)
 {
+    // Buffers are created on the render thread, once the frames in flight are drawn
+    RenderThread& renderThread = RenderThread::GetInstance();
+    if (!renderThread.IsGLThread())
+    {
+        renderThread.RunSync([this, &mesh]() { LoadMesh(mesh); });
+        return;
+    }
+
+    if (mesh.vertices.empty() || mesh.indices.empty())
+    {
+        LOG_DEBUG("ERROR: Trying to load an empty mesh");
+        return;
+    }
+
+    // Pick the compact layout unless the bounds are unusable for quantization
+    AABB bounds = ComputeVertexBounds(mesh.vertices.data(), mesh.vertices.size());
+    glm::vec3 extents = bounds.GetExtents();
+    bool finiteBounds = std::isfinite(extents.x) && std::isfinite(extents.y) && std::isfinite(extents.z);
+
+    mesh.layout = finiteBounds ? VertexLayout::Packed : VertexLayout::Float;
+    mesh.indexType = mesh.vertices.size() <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
     // Create and configure VAO
     glGenVertexArrays(1, &mesh.VAO);
     glBindVertexArray(mesh.VAO);
 
-    // Upload vertex data to GPU
     glGenBuffers(1, &mesh.VBO);
     glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(Vertex), &mesh.vertices[0], GL_STATIC_DRAW);
 
-    // Configure vertex attributes
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    size_t vertexBytes = 0;
+
+    if (mesh.layout == VertexLayout::Packed)
+    {
+        mesh.quantizeCenter = bounds.GetCenter();
+        mesh.quantizeExtents = extents;
+
+        // Flat axes (planes) keep a zero extent, the dequantize scale then collapses them exactly
+        glm::vec3 inverseExtents(
+            extents.x > 0.0f ? 1.0f / extents.x : 0.0f,
+            extents.y > 0.0f ? 1.0f / extents.y : 0.0f,
+            extents.z > 0.0f ? 1.0f / extents.z : 0.0f);
+
+        // unorm16 only covers [0, 1]; tiled coordinates fall back to half floats
+        bool unitTexCoords = true;
+        for (const Vertex& vertex : mesh.vertices)
+        {
+            if (vertex.texCoords.x < 0.0f || vertex.texCoords.x > 1.0f ||
+                vertex.texCoords.y < 0.0f || vertex.texCoords.y > 1.0f)
+            {
+                unitTexCoords = false;
+                break;
+            }
+        }
+
+        std::vector<PackedVertex> packed(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            const Vertex& source = mesh.vertices[i];
+            PackedVertex& target = packed[i];
+
+            glm::vec3 local = (source.position - mesh.quantizeCenter) * inverseExtents;
+            target.position[0] = PackSnorm16(local.x);
+            target.position[1] = PackSnorm16(local.y);
+            target.position[2] = PackSnorm16(local.z);
+            target.position[3] = 0;
+
+            PackOctahedralNormal(source.normal, target.normal);
+
+            if (unitTexCoords)
+            {
+                target.texCoords[0] = PackUnorm16(source.texCoords.x);
+                target.texCoords[1] = PackUnorm16(source.texCoords.y);
+            }
+            else
+            {
+                target.texCoords[0] = FloatToHalf(source.texCoords.x);
+                target.texCoords[1] = FloatToHalf(source.texCoords.y);
+            }
+        }
+
+        vertexBytes = packed.size() * sizeof(PackedVertex);
+        glBufferData(GL_ARRAY_BUFFER, vertexBytes, packed.data(), GL_STATIC_DRAW);
+
+        // Normal is octahedral (2 components); shaders reading it must decode it
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+        glEnableVertexAttribArray(2);
+        if (unitTexCoords)
+            glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoords));
+        else
+            glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoords));
+    }
+    else
+    {
+        mesh.quantizeCenter = glm::vec3(0.0f);
+        mesh.quantizeExtents = glm::vec3(1.0f);
+
+        vertexBytes = mesh.vertices.size() * sizeof(Vertex);
+        glBufferData(GL_ARRAY_BUFFER, vertexBytes, &mesh.vertices[0], GL_STATIC_DRAW);
+
+        // Configure vertex attributes
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+    }
 
     // Upload index data
     glGenBuffers(1, &mesh.EBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), &mesh.indices[0], GL_STATIC_DRAW);
+
+    // LODs are appended after the full index list in the same buffer
+    std::vector<unsigned int> allIndices(mesh.indices.begin(), mesh.indices.end());
+    for (MeshLOD& lod : mesh.lods)
+    {
+        lod.indexOffset = static_cast<unsigned int>(allIndices.size());
+        allIndices.insert(allIndices.end(), lod.indices.begin(), lod.indices.end());
+    }
+
+    size_t indexBytes = 0;
+
+    if (mesh.indexType == GL_UNSIGNED_SHORT)
+    {
+        std::vector<unsigned short> shortIndices(allIndices.begin(), allIndices.end());
+        indexBytes = shortIndices.size() * sizeof(unsigned short);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, shortIndices.data(), GL_STATIC_DRAW);
+    }
+    else
+    {
+        indexBytes = allIndices.size() * sizeof(unsigned int);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, allIndices.data(), GL_STATIC_DRAW);
+    }
 
     glBindVertexArray(0);
 
-    LOG_DEBUG("Mesh loaded - VAO: %d, Vertices: %d, Indices: %d", mesh.VAO, mesh.vertices.size(), mesh.indices.size());
+    size_t floatBytes = mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int);
+    LOG_DEBUG("Mesh loaded - VAO: %d, Vertices: %d, Indices: %d, LODs: %d, %s layout, %zu bytes (%zu as float)",
+        mesh.VAO, mesh.vertices.size(), mesh.indices.size(), mesh.lods.size(),
+        mesh.layout == VertexLayout::Packed ? "packed" : "float",
+        vertexBytes + indexBytes, floatBytes);
 }
 
-void Renderer::DrawMesh(const Mesh& mesh)
+void Renderer::DrawMesh(const Mesh& mesh, const glm::mat4& modelMatrix, GLint modelLocation, unsigned int lod)
 {
+    // Runs on the render thread every frame: a mesh without VAO is skipped, not reported
     if (mesh.VAO == 0)
-    {
-        LOG_DEBUG("ERROR: Trying to draw mesh without VAO");
-        LOG_CONSOLE("Render error: Invalid mesh");
         return;
+
+    if (mesh.layout == VertexLayout::Packed)
+    {
+        // Dequantization is just another scale and translation in front of the model matrix
+        glm::mat4 dequantize = glm::translate(glm::mat4(1.0f), mesh.quantizeCenter);
+        dequantize = glm::scale(dequantize, mesh.quantizeExtents);
+
+        glm::mat4 meshMatrix = modelMatrix * dequantize;
+        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(meshMatrix));
     }
+    else
+    {
+        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+    }
+
+    lod = std::min(lod, mesh.GetLODCount() - 1);
+
+    size_t indexSize = mesh.indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+    size_t firstIndex = lod == 0 ? 0 : mesh.lods[lod - 1].indexOffset;
 
     glBindVertexArray(mesh.VAO);
-    glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.GetLODIndexCount(lod)), mesh.indexType, (void*)(firstIndex * indexSize));
     glBindVertexArray(0);
 }
 
 void Renderer::UnloadMesh(Mesh& mesh)
 {
+    // Waiting for the render thread also guarantees no queued frame still draws the mesh
+    RenderThread& renderThread = RenderThread::GetInstance();
+    if (!renderThread.IsGLThread())
+    {
+        renderThread.RunSync([this, &mesh]() { UnloadMesh(mesh); });
+        return;
+    }
+
     if (mesh.VAO != 0)
     {
         glDeleteVertexArrays(1, &mesh.VAO);
@@ -191,11 +444,13 @@ bool Renderer::PreUpdate()
 
 bool Renderer::Update()
 {
-    // Clear buffers
-    glClearColor(clearColorR, clearColorG, clearColorB, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    RenderThread& renderThread = RenderThread::GetInstance();
 
-    defaultShader->Use();
+    // Texture levels queued since the last frame, within the upload time budget
+    renderThread.Enqueue([]()
+    {
+        TextureUploader::GetInstance().Update();
+    });
 
     camera->Update();
 
@@ -206,25 +461,24 @@ bool Renderer::Update()
     float aspectRatio = (float)width / (float)height;
     camera->SetAspectRatio(aspectRatio);
 
-    GLuint shaderProgram = defaultShader->GetProgramID();
-
-    // Update camera matrices
-    glUniformMatrix4fv(defaultUniforms.projection, 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
-    glUniformMatrix4fv(defaultUniforms.view, 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
+    glm::mat4 viewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+    if (viewProjection != lastViewProjection)
+    {
+        lastViewProjection = viewProjection;
+        RedrawScheduler::GetInstance().RequestRedraw(RedrawReason::Camera);
+    }
 
-    // Bind default texture
-    glActiveTexture(GL_TEXTURE0);
-    glUniform1i(defaultUniforms.texture1, 0);
+    DrawScene();
 
-    GameObject* root = Application::GetInstance().scene->GetRoot();
+    // Acts on the texture sizes requested while building the render list
+    TextureStreamer::GetInstance().Update();
 
-    if (root != nullptr && root->GetChildren().size() > 0)
+    // Sharper levels arrive over the next frames
+    if (TextureUploader::GetInstance().GetPendingLevels() > 0 || TextureStreamer::GetInstance().GetLoadsInFlight() > 0)
     {
-        DrawScene();
+        RedrawScheduler::GetInstance().RequestRedraw(RedrawReason::Streaming);
     }
 
-    defaultTexture->Unbind();
-
     return true;
 }
 
@@ -237,20 +491,22 @@ bool Renderer::CleanUp()
     UnloadMesh(cylinder);
     UnloadMesh(pyramid);
 
-    if (defaultShader)
-    {
-        defaultShader->Delete();
-    }
+    // Pending loads are dropped before the textures go away with the scene
+    TextureStreamer::GetInstance().Clear();
+    TextureUploader::GetInstance().Release();
 
-    if (lineShader)
-    {
-        lineShader->Delete();
-    }
+    // The shader variants are owned by the ShaderManager
+    ShaderManager::GetInstance().ReleaseVariants();
+    defaultShader = nullptr;
+    cutoutShader = nullptr;
+    arrayShader = nullptr;
+    arrayCutoutShader = nullptr;
+    bindlessShader = nullptr;
+    bindlessCutoutShader = nullptr;
 
-    if (outlineShader)
-    {
-        outlineShader->Delete();
-    }
+    // Handles must not outlive their textures, which go away with the scene
+    BindlessTextures::GetInstance().Release();
+    solidShader = nullptr;
 
     if (normalLinesVAO != 0)
     {
@@ -264,17 +520,23 @@ bool Renderer::CleanUp()
     return true;
 }
 
-bool Renderer::HasTransparency(GameObject* gameObject)
+// Objects without an active material are drawn with the default (opaque) texture
+static AlphaMode GetMaterialAlphaMode(GameObject* gameObject)
 {
     ComponentMaterial* material = static_cast<ComponentMaterial*>(
         gameObject->GetComponent(ComponentType::MATERIAL));
 
     if (material && material->IsActive())
     {
-        return true;
+        return material->GetAlphaMode();
     }
 
-    return false;
+    return AlphaMode::Opaque;
+}
+
+bool Renderer::HasTransparency(GameObject* gameObject)
+{
+    return GetMaterialAlphaMode(gameObject) == AlphaMode::Blend;
 }
 
 void Renderer::CollectTransparentObjects(GameObject* gameObject,
@@ -302,82 +564,122 @@ void Renderer::CollectTransparentObjects(GameObject* gameObject,
 
 void Renderer::DrawScene()
 {
+    // The list of two frames ago, the render thread is done with it
+    RenderList& list = renderLists[renderListIndex];
+    renderListIndex = 1 - renderListIndex;
+
+    BuildRenderList(list);
+
+    RenderThread::GetInstance().Enqueue([this, &list]()
+    {
+        SubmitRenderList(list);
+    });
+}
+
+void Renderer::BuildRenderList(RenderList& list)
+{
+    list.projection = camera->GetProjectionMatrix();
+    list.view = camera->GetViewMatrix();
+    // Black in the overdraw view so only the fragment count shows
+    list.clearColor = overdrawViewEnabled ? glm::vec3(0.0f) : glm::vec3(clearColorR, clearColorG, clearColorB);
+    list.overdrawView = overdrawViewEnabled;
+    list.depthPrepass = depthPrepassEnabled;
+    list.bindless = bindlessEnabled && IsBindlessSupported();
+    list.sortByDepth = frontToBackSortingEnabled;
+
+    ModuleEditor* editor = Application::GetInstance().editor.get();
+    list.vertexNormals = editor != nullptr && editor->ShouldShowVertexNormals();
+    list.faceNormals = editor != nullptr && editor->ShouldShowFaceNormals();
+
+    list.opaqueDraws.clear();
+    list.outlines.clear();
+    list.transparentDraws.clear();
+
     GameObject* root = Application::GetInstance().scene->GetRoot();
-    if (root == nullptr)
+    list.drawScene = root != nullptr && root->GetChildren().size() > 0;
+    if (!list.drawScene)
         return;
 
     SelectionManager* selectionMgr = Application::GetInstance().selectionManager;
     const std::vector<GameObject*>& selectedObjects = selectionMgr->GetSelectedObjects();
 
-    // First pass: render all opaque objects
-    glStencilFunc(GL_ALWAYS, 0, 0xFF);
-    glStencilMask(0x00);
-    DrawGameObjectRecursive(root, false);
+    // Propagate selection to descendants once per selection change instead of per object
+    selectionMgr->RefreshHierarchySelection();
 
-    // Second pass: render selection outlines
-    outlineShader->Use();
-    glUniformMatrix4fv(outlineUniforms.projection, 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
-    glUniformMatrix4fv(outlineUniforms.view, 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
-    outlineShader->SetVec3("outlineColor", glm::vec3(1.0f, 0.41f, 0.71f));
+    lodStats = LODStats();
+    passStats = PassStats();
+    // Binds are counted while drawing, so this is the last frame the render thread finished
+    passStats.textureBinds = textureBinds.load();
+    UpdateVisibility();
 
-    float outlineScale = 1.02f;
+    // First pass: opaque and cutout meshes
+    CollectOpaqueDraws(root, list);
 
-    // Disable depth test and depth writing so outlines render on top of everything
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    int viewportWidth, viewportHeight;
+    Application::GetInstance().window->GetWindowSize(viewportWidth, viewportHeight);
 
-    for (GameObject* selectedObj : selectedObjects)
+    for (const OpaqueDraw& draw : list.opaqueDraws)
     {
-        Transform* transform = static_cast<Transform*>(selectedObj->GetComponent(ComponentType::TRANSFORM));
-        if (transform == nullptr) continue;
+        if (draw.cutout)
+            ++passStats.cutoutDraws;
+        else
+            ++passStats.opaqueDraws;
 
-        const std::vector<Component*>& meshComponents =
-            selectedObj->GetComponentsOfType(ComponentType::MESH);
+        RequestTextureLevel(draw.texture, draw.meshComp, draw.modelMatrix, static_cast<float>(viewportHeight));
+    }
+
+    // Second pass: selection outlines, they would only add noise to the overdraw view
+    float outlineScale = 1.02f;
 
-        for (Component* comp : meshComponents)
+    if (!overdrawViewEnabled)
+    {
+        for (GameObject* selectedObj : selectedObjects)
         {
-            ComponentMesh* meshComp = static_cast<ComponentMesh*>(comp);
+            Transform* transform = static_cast<Transform*>(selectedObj->GetComponent(ComponentType::TRANSFORM));
+            if (transform == nullptr) continue;
+
+            const std::vector<Component*>& meshComponents =
+                selectedObj->GetComponentsOfType(ComponentType::MESH);
 
-            if (meshComp->IsActive() && meshComp->HasMesh())
+            for (Component* comp : meshComponents)
             {
-                const Mesh& mesh = meshComp->GetMesh();
+                ComponentMesh* meshComp = static_cast<ComponentMesh*>(comp);
 
-                // Calculate mesh center in local space
-                glm::vec3 meshCenter(0.0f);
-                if (!mesh.vertices.empty())
+                if (meshComp->IsActive() && meshComp->HasMesh() && IsMeshVisible(meshComp))
                 {
-                    for (const auto& vertex : mesh.vertices)
+                    const Mesh& mesh = meshComp->GetMesh();
+
+                    // Calculate mesh center in local space
+                    glm::vec3 meshCenter(0.0f);
+                    if (!mesh.vertices.empty())
                     {
-                        meshCenter += vertex.position;
+                        for (const auto& vertex : mesh.vertices)
+                        {
+                            meshCenter += vertex.position;
+                        }
+                        meshCenter /= static_cast<float>(mesh.vertices.size());
                     }
-                    meshCenter /= static_cast<float>(mesh.vertices.size());
-                }
 
-                // Get global transformation
-                glm::mat4 globalMatrix = transform->GetGlobalMatrix();
+                    // Get global transformation
+                    glm::mat4 globalMatrix = transform->GetRenderMatrix();
 
-                // Transform mesh center to world space
-                glm::vec4 worldCenter = globalMatrix * glm::vec4(meshCenter, 1.0f);
+                    // Transform mesh center to world space
+                    glm::vec4 worldCenter = globalMatrix * glm::vec4(meshCenter, 1.0f);
 
-                // Scale from mesh center in world space
-                glm::mat4 toCenter = glm::translate(glm::mat4(1.0f), -glm::vec3(worldCenter));
-                glm::mat4 fromCenter = glm::translate(glm::mat4(1.0f), glm::vec3(worldCenter));
-                glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(outlineScale));
+                    // Scale from mesh center in world space
+                    glm::mat4 toCenter = glm::translate(glm::mat4(1.0f), -glm::vec3(worldCenter));
+                    glm::mat4 fromCenter = glm::translate(glm::mat4(1.0f), glm::vec3(worldCenter));
+                    glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(outlineScale));
 
-                glm::mat4 outlineModelMatrix = fromCenter * scale * toCenter * globalMatrix;
+                    glm::mat4 outlineModelMatrix = fromCenter * scale * toCenter * globalMatrix;
 
-                glUniformMatrix4fv(outlineUniforms.model, 1, GL_FALSE, glm::value_ptr(outlineModelMatrix));
-                DrawMesh(mesh);
+                    list.outlines.push_back({ &mesh, nullptr, outlineModelMatrix, meshComp->GetCurrentLOD(), false });
+                }
             }
         }
     }
 
-    // Restore state
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
-    defaultShader->Use();
-
-    // Third pass: render transparent objects back-to-front
+    // Third pass: transparent objects back-to-front
     std::vector<TransparentObject> transparentObjects;
     CollectTransparentObjects(root, transparentObjects);
 
@@ -386,10 +688,348 @@ void Renderer::DrawScene()
             return a.distanceToCamera > b.distanceToCamera;
         });
 
+    const bool normals = list.vertexNormals || list.faceNormals;
+
     for (const auto& transparentObj : transparentObjects)
     {
-        DrawGameObjectRecursive(transparentObj.gameObject, true);
+        GameObject* gameObject = transparentObj.gameObject;
+
+        ComponentMaterial* material = static_cast<ComponentMaterial*>(
+            gameObject->GetComponent(ComponentType::MATERIAL));
+        Transform* transform = static_cast<Transform*>(
+            gameObject->GetComponent(ComponentType::TRANSFORM));
+
+        const glm::mat4& modelMatrix = transform->GetRenderMatrix();
+        bool selected = normals && selectionMgr->IsInSelectedHierarchy(gameObject);
+
+        for (Component* comp : gameObject->GetComponentsOfType(ComponentType::MESH))
+        {
+            ComponentMesh* meshComp = static_cast<ComponentMesh*>(comp);
+            if (!meshComp->IsActive() || !meshComp->HasMesh() || !IsMeshVisible(meshComp))
+                continue;
+
+            const Mesh& mesh = meshComp->GetMesh();
+            unsigned int lod = meshLODEnabled ? meshComp->UpdateLOD(modelMatrix, *camera) : 0;
+
+            size_t fullTriangles = mesh.indices.size() / 3;
+            size_t drawnTriangles = mesh.GetLODIndexCount(lod) / 3;
+            lodStats.trianglesDrawn += static_cast<unsigned int>(drawnTriangles);
+            lodStats.trianglesSaved += static_cast<unsigned int>(fullTriangles - drawnTriangles);
+
+            list.transparentDraws.push_back({ &mesh, material->GetTexture(), modelMatrix, lod, selected });
+
+            RequestTextureLevel(material->GetTexture(), meshComp, transform->GetGlobalMatrix(), static_cast<float>(viewportHeight));
+        }
+    }
+
+    passStats.transparentObjects = static_cast<unsigned int>(transparentObjects.size());
+}
+
+void Renderer::SubmitRenderList(RenderList& list)
+{
+    glClearColor(list.clearColor.x, list.clearColor.y, list.clearColor.z, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    frameProjection = list.projection;
+    frameView = list.view;
+
+    defaultShader->Use();
+
+    // Update camera matrices
+    glUniformMatrix4fv(defaultUniforms.projection, 1, GL_FALSE, glm::value_ptr(list.projection));
+    glUniformMatrix4fv(defaultUniforms.view, 1, GL_FALSE, glm::value_ptr(list.view));
+
+    // Bind default texture
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(defaultUniforms.texture1, 0);
+
+    if (list.drawScene)
+    {
+        SubmitScene(list);
+    }
+
+    defaultTexture->Unbind();
+}
+
+void Renderer::SubmitScene(RenderList& list)
+{
+    // The default shader's matrices are set in SubmitRenderList, the other scene shaders get them here
+    cutoutShader->Use();
+    glUniformMatrix4fv(cutoutUniforms.projection, 1, GL_FALSE, glm::value_ptr(list.projection));
+    glUniformMatrix4fv(cutoutUniforms.view, 1, GL_FALSE, glm::value_ptr(list.view));
+    glUniform1i(cutoutUniforms.texture1, 0);
+
+    arrayShader->Use();
+    glUniformMatrix4fv(arrayUniforms.projection, 1, GL_FALSE, glm::value_ptr(list.projection));
+    glUniformMatrix4fv(arrayUniforms.view, 1, GL_FALSE, glm::value_ptr(list.view));
+    glUniform1i(arrayUniforms.texture1, 0);
+
+    arrayCutoutShader->Use();
+    glUniformMatrix4fv(arrayCutoutUniforms.projection, 1, GL_FALSE, glm::value_ptr(list.projection));
+    glUniformMatrix4fv(arrayCutoutUniforms.view, 1, GL_FALSE, glm::value_ptr(list.view));
+    glUniform1i(arrayCutoutUniforms.texture1, 0);
+
+    if (list.bindless)
+    {
+        bindlessShader->Use();
+        glUniformMatrix4fv(bindlessUniforms.projection, 1, GL_FALSE, glm::value_ptr(list.projection));
+        glUniformMatrix4fv(bindlessUniforms.view, 1, GL_FALSE, glm::value_ptr(list.view));
+
+        bindlessCutoutShader->Use();
+        glUniformMatrix4fv(bindlessCutoutUniforms.projection, 1, GL_FALSE, glm::value_ptr(list.projection));
+        glUniformMatrix4fv(bindlessCutoutUniforms.view, 1, GL_FALSE, glm::value_ptr(list.view));
+    }
+
+    solidShader->Use();
+    glUniformMatrix4fv(solidUniforms.projection, 1, GL_FALSE, glm::value_ptr(list.projection));
+    glUniformMatrix4fv(solidUniforms.view, 1, GL_FALSE, glm::value_ptr(list.view));
+
+    if (list.overdrawView)
+    {
+        glBlendFunc(GL_ONE, GL_ONE);
+    }
+
+    std::vector<OpaqueDraw>& opaqueDraws = list.opaqueDraws;
+
+    // One storage buffer slot per distinct texture drawn this frame. Handles are made resident here,
+    // and the textures' upload state is only stable on this thread.
+    if (list.bindless)
+    {
+        BindlessTextures& bindless = BindlessTextures::GetInstance();
+        bindless.BeginFrame();
+
+        for (OpaqueDraw& draw : opaqueDraws)
+            draw.bindlessIndex = bindless.GetIndex(draw.texture);
+
+        bindless.Upload();
+    }
+
+    // Group by shader (opaque before cutout; bindless, then standalone textures, then array layers), then front
+    // to back so hidden fragments fail the depth test early. Unsorted, draws are grouped by texture to save binds.
+    const bool sortByDepth = list.sortByDepth;
+    auto textureMode = [](const OpaqueDraw& draw)
+    {
+        if (draw.bindlessIndex != BindlessTextures::NO_INDEX)
+            return 0;
+        return draw.texture->IsInArray() ? 2 : 1;
+    };
+
+    std::stable_sort(opaqueDraws.begin(), opaqueDraws.end(), [sortByDepth, &textureMode](const OpaqueDraw& a, const OpaqueDraw& b)
+    {
+        if (a.cutout != b.cutout)
+            return !a.cutout;
+        if (textureMode(a) != textureMode(b))
+            return textureMode(a) < textureMode(b);
+        if (sortByDepth)
+            return a.viewDepth < b.viewDepth;
+
+        GLuint textureA = a.texture->IsInArray() ? a.texture->GetArrayID() : a.texture->GetID();
+        GLuint textureB = b.texture->IsInArray() ? b.texture->GetArrayID() : b.texture->GetID();
+        return textureA < textureB;
+    });
+
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilMask(0x00);
+    DrawOpaquePass(list);
+
+    // Selection outlines
+    solidShader->Use();
+    solidShader->SetVec3("tintColor", glm::vec3(1.0f, 0.41f, 0.71f));
+
+    // Disable depth test and depth writing so outlines render on top of everything
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+
+    for (const MeshDraw& outline : list.outlines)
+    {
+        DrawMesh(*outline.mesh, outline.modelMatrix, solidUniforms.model, outline.lod);
+    }
+
+    // Restore state
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+
+    // Transparent meshes, already sorted back-to-front
+    Shader* transparentShader = list.overdrawView ? solidShader : cutoutShader;
+    GLint modelLocation = list.overdrawView ? solidUniforms.model : cutoutUniforms.model;
+
+    transparentShader->Use();
+    if (list.overdrawView)
+    {
+        transparentShader->SetVec3("tintColor", OVERDRAW_COLOR);
+    }
+
+    for (const MeshDraw& draw : list.transparentDraws)
+    {
+        if (!list.overdrawView)
+        {
+            transparentShader->SetVec3("tintColor", glm::vec3(1.0f));
+        }
+
+        if (draw.texture != nullptr)
+        {
+            draw.texture->Bind();
+        }
+
+        DrawMesh(*draw.mesh, draw.modelMatrix, modelLocation, draw.lod);
+
+        if (draw.normals)
+        {
+            DrawSelectedNormals(list, *draw.mesh, draw.modelMatrix);
+            transparentShader->Use();
+        }
+
+        if (draw.texture != nullptr)
+        {
+            draw.texture->Unbind();
+        }
+    }
+
+    if (list.overdrawView)
+    {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    defaultShader->Use();
+}
+
+void Renderer::UpdateVisibility()
+{
+    ++frameIndex;
+    visibleObjects.clear();
+
+    if (!frustumCullingEnabled)
+    {
+        visibleObjectCount = 0;
+        return;
+    }
+
+    glm::mat4 viewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+
+    Frustum frustum(viewProjection);
+    Application::GetInstance().scene->GetOctree().QueryFrustum(frustum, visibleObjects);
+
+    // Disabled objects stay in the octree, they must neither occlude nor count as visible
+    visibleObjects.erase(std::remove_if(visibleObjects.begin(), visibleObjects.end(),
+        [](GameObject* gameObject) { return !gameObject->IsActiveInHierarchy(); }), visibleObjects.end());
+
+    if (occlusionCullingEnabled)
+    {
+        CullOccludedObjects(viewProjection);
+    }
+
+    for (GameObject* gameObject : visibleObjects)
+    {
+        for (Component* component : gameObject->GetComponentsOfType(ComponentType::MESH))
+        {
+            static_cast<ComponentMesh*>(component)->SetVisibleFrame(frameIndex);
+        }
+    }
+
+    visibleObjectCount = static_cast<unsigned int>(visibleObjects.size());
+}
+
+void Renderer::CullOccludedObjects(const glm::mat4& viewProjection)
+{
+    const Octree& octree = Application::GetInstance().scene->GetOctree();
+    occlusionCuller.BeginFrame(viewProjection);
+
+    // Occluders: the objects covering the most screen, biggest first
+    struct OccluderCandidate
+    {
+        GameObject* gameObject;
+        float screenSize;
+    };
+
+    std::vector<OccluderCandidate> candidates;
+    glm::vec3 cameraPosition = camera->GetPosition();
+    float viewScale = 1.0f / std::tan(glm::radians(camera->GetFov()) * 0.5f);
+
+    for (GameObject* gameObject : visibleObjects)
+    {
+        AABB bounds;
+        if (!octree.GetBounds(gameObject, bounds)) continue;
+
+        float distance = glm::length(bounds.GetCenter() - cameraPosition);
+        float radius = glm::length(bounds.GetExtents());
+
+        // Boxes around the camera cannot be occluders (they would cover the whole screen)
+        if (distance <= radius) continue;
+
+        // Only fully opaque materials hide what is behind them
+        if (GetMaterialAlphaMode(gameObject) != AlphaMode::Opaque) continue;
+
+        float screenSize = radius / distance * viewScale;
+        if (screenSize >= OCCLUDER_MIN_SCREEN_SIZE)
+            candidates.push_back({ gameObject, screenSize });
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const OccluderCandidate& a, const OccluderCandidate& b)
+    {
+        return a.screenSize > b.screenSize;
+    });
+
+    size_t triangleBudget = OCCLUDER_TRIANGLE_BUDGET;
+    int occluderCount = 0;
+
+    for (const OccluderCandidate& candidate : candidates)
+    {
+        if (occluderCount >= OCCLUDER_MAX_COUNT) break;
+
+        Transform* transform = static_cast<Transform*>(candidate.gameObject->GetComponent(ComponentType::TRANSFORM));
+        if (transform == nullptr) continue;
+
+        for (Component* component : candidate.gameObject->GetComponentsOfType(ComponentType::MESH))
+        {
+            ComponentMesh* meshComp = static_cast<ComponentMesh*>(component);
+            if (!meshComp->IsActive() || !meshComp->HasMesh()) continue;
+
+            const Mesh& mesh = meshComp->GetMesh();
+            size_t triangles = mesh.indices.size() / 3;
+            if (triangles > triangleBudget) continue;
+
+            occlusionCuller.AddOccluder(mesh.vertices, mesh.indices, transform->GetGlobalMatrix());
+            triangleBudget -= triangles;
+        }
+
+        ++occluderCount;
     }
+
+    occlusionCuller.EndOccluders();
+
+    // Drop everything hidden behind the occluders
+    visibleObjects.erase(std::remove_if(visibleObjects.begin(), visibleObjects.end(), [&](GameObject* gameObject)
+    {
+        AABB bounds;
+        return octree.GetBounds(gameObject, bounds) && occlusionCuller.IsOccluded(bounds);
+    }), visibleObjects.end());
+}
+
+bool Renderer::IsBindlessSupported() const
+{
+    return bindlessShader != nullptr && BindlessTextures::GetInstance().IsSupported();
+}
+
+bool Renderer::IsMeshVisible(const ComponentMesh* meshComp) const
+{
+    return !frustumCullingEnabled || meshComp->IsVisibleInFrame(frameIndex);
+}
+
+void Renderer::RequestTextureLevel(Texture* texture, const ComponentMesh* meshComp,
+    const glm::mat4& modelMatrix, float viewportHeight)
+{
+    if (texture == nullptr || !texture->IsStreamed())
+        return;
+
+    // Projected diameter of the bounding sphere, the whole viewport when the camera is inside it
+    AABB worldAABB = meshComp->GetLocalAABB().Transformed(modelMatrix);
+    float radius = glm::length(worldAABB.GetExtents());
+    float distance = glm::length(worldAABB.GetCenter() - camera->GetPosition());
+    float halfViewHeight = distance * std::tan(glm::radians(camera->GetFov()) * 0.5f);
+
+    float screenPixels = (distance > radius && halfViewHeight > 0.0f) ? radius / halfViewHeight * viewportHeight : viewportHeight;
+
+    TextureStreamer::GetInstance().RequestScreenSize(texture, screenPixels);
 }
 
 void Renderer::DrawGameObjectWithStencil(GameObject* gameObject)
@@ -400,8 +1040,7 @@ void Renderer::DrawGameObjectWithStencil(GameObject* gameObject)
     Transform* transform = static_cast<Transform*>(gameObject->GetComponent(ComponentType::TRANSFORM));
     if (transform == nullptr) return;
 
-    const glm::mat4& modelMatrix = transform->GetGlobalMatrix();
-    glUniformMatrix4fv(defaultUniforms.model, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+    const glm::mat4& modelMatrix = transform->GetRenderMatrix();
 
     defaultShader->SetVec3("tintColor", glm::vec3(1.0f));
 
@@ -429,7 +1068,7 @@ void Renderer::DrawGameObjectWithStencil(GameObject* gameObject)
         if (meshComp->IsActive() && meshComp->HasMesh())
         {
             const Mesh& mesh = meshComp->GetMesh();
-            DrawMesh(mesh);
+            DrawMesh(mesh, modelMatrix, defaultUniforms.model, meshComp->GetCurrentLOD());
         }
     }
 
@@ -439,7 +1078,7 @@ void Renderer::DrawGameObjectWithStencil(GameObject* gameObject)
         defaultTexture->Unbind();
 }
 
-void Renderer::DrawGameObjectRecursive(GameObject* gameObject, bool renderTransparentOnly)
+void Renderer::CollectOpaqueDraws(GameObject* gameObject, RenderList& list)
 {
     if (!gameObject->IsActive())
         return;
@@ -447,96 +1086,182 @@ void Renderer::DrawGameObjectRecursive(GameObject* gameObject, bool renderTransp
     Transform* transform = static_cast<Transform*>(gameObject->GetComponent(ComponentType::TRANSFORM));
     if (transform == nullptr) return;
 
-    bool isTransparent = HasTransparency(gameObject);
+    AlphaMode alphaMode = GetMaterialAlphaMode(gameObject);
 
-    // Skip this object if transparency doesn't match the current pass
-    if (renderTransparentOnly != isTransparent)
+    // Blended objects are drawn later, back to front
+    if (alphaMode != AlphaMode::Blend)
     {
-        for (GameObject* child : gameObject->GetChildren())
+        const glm::mat4& modelMatrix = transform->GetRenderMatrix();
+
+        ComponentMaterial* material = static_cast<ComponentMaterial*>(
+            gameObject->GetComponent(ComponentType::MATERIAL));
+        if (material && !material->IsActive())
+            material = nullptr;
+
+        Texture* texture = material && material->HasTexture() ? material->GetTexture() : defaultTexture.get();
+
+        // Normals are shown for selected objects and their descendants
+        bool normals = (list.vertexNormals || list.faceNormals) &&
+            Application::GetInstance().selectionManager->IsInSelectedHierarchy(gameObject);
+
+        for (Component* comp : gameObject->GetComponentsOfType(ComponentType::MESH))
         {
-            DrawGameObjectRecursive(child, renderTransparentOnly);
-        }
-        return;
-    }
+            ComponentMesh* meshComp = static_cast<ComponentMesh*>(comp);
 
-    const glm::mat4& modelMatrix = transform->GetGlobalMatrix();
-    glUniformMatrix4fv(defaultUniforms.model, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+            if (!meshComp->IsActive() || !meshComp->HasMesh() || !IsMeshVisible(meshComp))
+                continue;
 
-    defaultShader->SetVec3("tintColor", glm::vec3(1.0f));
+            const Mesh& mesh = meshComp->GetMesh();
+            unsigned int lod = meshLODEnabled ? meshComp->UpdateLOD(modelMatrix, *camera) : 0;
 
-    ComponentMaterial* material = static_cast<ComponentMaterial*>(
-        gameObject->GetComponent(ComponentType::MATERIAL));
+            size_t fullTriangles = mesh.indices.size() / 3;
+            size_t drawnTriangles = mesh.GetLODIndexCount(lod) / 3;
+            lodStats.trianglesDrawn += static_cast<unsigned int>(drawnTriangles);
+            lodStats.trianglesSaved += static_cast<unsigned int>(fullTriangles - drawnTriangles);
 
-    bool materialBound = false;
-    if (material && material->IsActive())
-    {
-        material->Use();
-        materialBound = true;
+            // View space depth of the bounds center (the camera looks down -Z)
+            glm::vec4 viewCenter = list.view * (modelMatrix * glm::vec4(meshComp->GetLocalAABB().GetCenter(), 1.0f));
+
+            list.opaqueDraws.push_back({ &mesh, meshComp, texture, BindlessTextures::NO_INDEX, modelMatrix, lod, -viewCenter.z, alphaMode == AlphaMode::Cutout, normals });
+        }
     }
-    else
+
+    for (GameObject* child : gameObject->GetChildren())
     {
-        defaultTexture->Bind();
+        CollectOpaqueDraws(child, list);
     }
+}
 
-    const std::vector<Component*>& meshComponents =
-        gameObject->GetComponentsOfType(ComponentType::MESH);
+void Renderer::DrawOpaquePass(const RenderList& list)
+{
+    const std::vector<OpaqueDraw>& opaqueDraws = list.opaqueDraws;
+    const bool depthPrepassEnabled = list.depthPrepass;
+    const bool overdrawViewEnabled = list.overdrawView;
 
-    ModuleEditor* editor = Application::GetInstance().editor.get();
-    SelectionManager* selectionMgr = Application::GetInstance().selectionManager;
+    // Draws are sorted opaque first, so the cutouts are the tail of the list
+    size_t opaqueCount = 0;
+    while (opaqueCount < opaqueDraws.size() && !opaqueDraws[opaqueCount].cutout)
+        ++opaqueCount;
 
-    // Check if normals should be displayed for this object
-    bool shouldDrawNormals = false;
-    if (editor && selectionMgr->IsSelected(gameObject))
-    {
-        shouldDrawNormals = true;
-    }
-    else if (editor)
+    // Depth only: no textures, no color writes
+    if (depthPrepassEnabled && opaqueCount > 0)
     {
-        // Check parent hierarchy for selection
-        GameObject* parent = gameObject->GetParent();
-        while (parent)
+        solidShader->Use();
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+        for (size_t i = 0; i < opaqueCount; ++i)
         {
-            if (selectionMgr->IsSelected(parent))
-            {
-                shouldDrawNormals = true;
-                break;
-            }
-            parent = parent->GetParent();
+            const OpaqueDraw& draw = opaqueDraws[i];
+            DrawMesh(*draw.mesh, draw.modelMatrix, solidUniforms.model, draw.lod);
         }
+
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+        // Depth is final, only the nearest fragment of every pixel gets shaded
+        glDepthFunc(GL_LEQUAL);
+        glDepthMask(GL_FALSE);
     }
 
-    const bool showVertex = editor && editor->ShouldShowVertexNormals();
-    const bool showFace = editor && editor->ShouldShowFaceNormals();
+    Shader* shader = nullptr;
+    GLint modelLocation = -1;
+    GLint layerLocation = -1;
+    GLint materialLocation = -1;
+    GLuint boundTexture = 0;
+    unsigned int binds = 0;
 
-    for (Component* comp : meshComponents)
+    for (size_t i = 0; i < opaqueDraws.size(); ++i)
     {
-        ComponentMesh* meshComp = static_cast<ComponentMesh*>(comp);
+        const OpaqueDraw& draw = opaqueDraws[i];
 
-        if (meshComp->IsActive() && meshComp->HasMesh())
+        if (i == opaqueCount && depthPrepassEnabled)
         {
-            const Mesh& mesh = meshComp->GetMesh();
-            DrawMesh(mesh);
+            // Cutouts were not in the pre-pass, they test and write depth normally
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
+        }
+
+        const bool bindless = draw.bindlessIndex != BindlessTextures::NO_INDEX;
+        const bool inArray = draw.texture->IsInArray();
 
-            if (shouldDrawNormals)
+        Shader* drawShader = solidShader;
+        const ShaderUniforms* uniforms = &solidUniforms;
+        if (!overdrawViewEnabled)
+        {
+            if (bindless)
             {
-                if (showVertex) DrawVertexNormals(mesh, modelMatrix);
-                if (showFace) DrawFaceNormals(mesh, modelMatrix);
+                drawShader = draw.cutout ? bindlessCutoutShader : bindlessShader;
+                uniforms = draw.cutout ? &bindlessCutoutUniforms : &bindlessUniforms;
             }
+            else if (inArray)
+            {
+                drawShader = draw.cutout ? arrayCutoutShader : arrayShader;
+                uniforms = draw.cutout ? &arrayCutoutUniforms : &arrayUniforms;
+            }
+            else
+            {
+                drawShader = draw.cutout ? cutoutShader : defaultShader;
+                uniforms = draw.cutout ? &cutoutUniforms : &defaultUniforms;
+            }
+        }
+
+        if (drawShader != shader)
+        {
+            shader = drawShader;
+            shader->Use();
+            shader->SetVec3("tintColor", overdrawViewEnabled ? OVERDRAW_COLOR : glm::vec3(1.0f));
+            modelLocation = uniforms->model;
+            layerLocation = uniforms->textureLayer;
+            materialLocation = uniforms->materialIndex;
+        }
+
+        // A material change is a uniform, the handles are already resident
+        if (bindless && !overdrawViewEnabled)
+        {
+            glUniform1ui(materialLocation, draw.bindlessIndex);
+            DrawMesh(*draw.mesh, draw.modelMatrix, modelLocation, draw.lod);
+            continue;
+        }
+
+        // Packed textures share their array's binding, only the layer changes between them
+        GLuint drawTexture = inArray ? draw.texture->GetArrayID() : draw.texture->GetID();
+        if (drawTexture != boundTexture)
+        {
+            glBindTexture(inArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, drawTexture);
+            boundTexture = drawTexture;
+            ++binds;
         }
+
+        if (inArray && layerLocation != -1)
+            glUniform1f(layerLocation, static_cast<float>(draw.texture->GetArrayLayer()));
+
+        DrawMesh(*draw.mesh, draw.modelMatrix, modelLocation, draw.lod);
     }
 
-    if (materialBound)
-        material->Unbind();
-    else
-        defaultTexture->Unbind();
+    textureBinds.store(binds);
 
-    // Recursively render children
-    for (GameObject* child : gameObject->GetChildren())
+    if (depthPrepassEnabled && opaqueCount == opaqueDraws.size())
+    {
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    defaultTexture->Unbind();
+
+    // Debug normals switch shaders, so they go after all opaque draws
+    for (const OpaqueDraw& draw : opaqueDraws)
     {
-        DrawGameObjectRecursive(child, renderTransparentOnly);
+        if (draw.normals)
+            DrawSelectedNormals(list, *draw.mesh, draw.modelMatrix);
     }
 }
 
+void Renderer::DrawSelectedNormals(const RenderList& list, const Mesh& mesh, const glm::mat4& modelMatrix)
+{
+    if (list.vertexNormals) DrawVertexNormals(mesh, modelMatrix);
+    if (list.faceNormals) DrawFaceNormals(mesh, modelMatrix);
+}
+
 void Renderer::DrawVertexNormals(const Mesh& mesh, const glm::mat4& modelMatrix)
 {
     if (!mesh.IsValid() || mesh.vertices.empty())
@@ -591,15 +1316,15 @@ void Renderer::DrawVertexNormals(const Mesh& mesh, const glm::mat4& modelMatrix)
     }
 
     // Render normals
-    lineShader->Use();
-    glUniformMatrix4fv(glGetUniformLocation(lineShader->GetProgramID(), "projection"),
-        1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
-    glUniformMatrix4fv(glGetUniformLocation(lineShader->GetProgramID(), "view"),
-        1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
-    glUniformMatrix4fv(glGetUniformLocation(lineShader->GetProgramID(), "model"),
+    solidShader->Use();
+    glUniformMatrix4fv(glGetUniformLocation(solidShader->GetProgramID(), "projection"),
+        1, GL_FALSE, glm::value_ptr(frameProjection));
+    glUniformMatrix4fv(glGetUniformLocation(solidShader->GetProgramID(), "view"),
+        1, GL_FALSE, glm::value_ptr(frameView));
+    glUniformMatrix4fv(glGetUniformLocation(solidShader->GetProgramID(), "model"),
         1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
 
-    lineShader->SetVec3("color", glm::vec3(0.0f, 0.5f, 1.0f));
+    solidShader->SetVec3("tintColor", glm::vec3(0.0f, 0.5f, 1.0f));
     glDrawArrays(GL_LINES, 0, lineVertices.size() / 3);
 
     glBindVertexArray(0);
@@ -654,14 +1379,14 @@ void Renderer::DrawFaceNormals(const Mesh& mesh, const glm::mat4& modelMatrix)
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
 
-    lineShader->Use();
-    GLuint shaderProgram = lineShader->GetProgramID();
+    solidShader->Use();
+    GLuint shaderProgram = solidShader->GetProgramID();
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(frameProjection));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(frameView));
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
 
-    lineShader->SetVec3("color", glm::vec3(0.0f, 1.0f, 0.5f));
+    solidShader->SetVec3("tintColor", glm::vec3(0.0f, 1.0f, 0.5f));
 
     glDrawArrays(GL_LINES, 0, lineVertices.size() / 3);
 
@@ -675,10 +1400,13 @@ void Renderer::DrawFaceNormals(const Mesh& mesh, const glm::mat4& modelMatrix)
 void Renderer::SetDepthTest(bool enabled)
 {
     depthTestEnabled = enabled;
-    if (enabled)
-        glEnable(GL_DEPTH_TEST);
-    else
-        glDisable(GL_DEPTH_TEST);
+    RenderThread::GetInstance().Enqueue([enabled]()
+    {
+        if (enabled)
+            glEnable(GL_DEPTH_TEST);
+        else
+            glDisable(GL_DEPTH_TEST);
+    });
 
     LOG_DEBUG("Depth test %s", enabled ? "enabled" : "disabled");
 }
@@ -686,10 +1414,13 @@ void Renderer::SetDepthTest(bool enabled)
 void Renderer::SetFaceCulling(bool enabled)
 {
     faceCullingEnabled = enabled;
-    if (enabled)
-        glEnable(GL_CULL_FACE);
-    else
-        glDisable(GL_CULL_FACE);
+    RenderThread::GetInstance().Enqueue([enabled]()
+    {
+        if (enabled)
+            glEnable(GL_CULL_FACE);
+        else
+            glDisable(GL_CULL_FACE);
+    });
 
     LOG_DEBUG("Face culling %s", enabled ? "enabled" : "disabled");
 }
@@ -697,10 +1428,10 @@ void Renderer::SetFaceCulling(bool enabled)
 void Renderer::SetWireframeMode(bool enabled)
 {
     wireframeMode = enabled;
-    if (enabled)
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    else
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    RenderThread::GetInstance().Enqueue([enabled]()
+    {
+        glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+    });
 
     LOG_DEBUG("Wireframe mode %s", enabled ? "enabled" : "disabled");
 }
@@ -717,13 +1448,16 @@ void Renderer::SetCullFaceMode(int mode)
 {
     cullFaceMode = mode;
 
-    switch (mode)
+    RenderThread::GetInstance().Enqueue([mode]()
     {
-    case 0: glCullFace(GL_BACK); break;
-    case 1: glCullFace(GL_FRONT); break;
-    case 2: glCullFace(GL_FRONT_AND_BACK); break;
-    default: glCullFace(GL_BACK); break;
-    }
+        switch (mode)
+        {
+        case 0: glCullFace(GL_BACK); break;
+        case 1: glCullFace(GL_FRONT); break;
+        case 2: glCullFace(GL_FRONT_AND_BACK); break;
+        default: glCullFace(GL_BACK); break;
+        }
+    });
 
     const char* modeStr[] = { "Back", "Front", "Front and Back" };
     LOG_DEBUG("Cull face mode set to: %s", modeStr[mode]);
@@ -4,10 +4,14 @@
 #include "Shaders.h"
 #include "Texture.h"
 #include <memory>
+#include <atomic>
 #include "Primitives.h"
 #include "Camera.h"
+#include "OcclusionCuller.h"
 
 class GameObject;
+class ComponentMesh;
+class ComponentMaterial;
 
 // Transparent objects must be sorted and rendered back-to-front
 struct TransparentObject
@@ -33,15 +37,16 @@ public:
 
     // Mesh management
     void LoadMesh(Mesh& mesh);
-    void DrawMesh(const Mesh& mesh);
+    // Uploads modelMatrix (with the mesh's dequantization folded in) to modelLocation and draws the given LOD
+    void DrawMesh(const Mesh& mesh, const glm::mat4& modelMatrix, GLint modelLocation, unsigned int lod = 0);
     void UnloadMesh(Mesh& mesh);
     void LoadTexture(const std::string& path);
 
-    // Scene rendering
+    // Scene rendering: builds the frame's render list and queues it on the render thread
     void DrawScene();
     void DrawGameObject(GameObject* gameObject);
 
-    // Transparency handling
+    // Transparency handling (only blended materials, cutouts are drawn with the opaque pass)
     bool HasTransparency(GameObject* gameObject);
     void CollectTransparentObjects(GameObject* gameObject,
         std::vector<TransparentObject>& transparentObjects);
@@ -51,8 +56,8 @@ public:
     void DrawFaceNormals(const Mesh& mesh, const glm::mat4& modelMatrix);
 
     // Shader access
-    Shader* GetDefaultShader() const { return defaultShader.get(); }
-    Shader* GetOutlineShader() const { return outlineShader.get(); }
+    Shader* GetDefaultShader() const { return defaultShader; }
+    Shader* GetSolidShader() const { return solidShader; }
     Camera* GetCamera() { return camera.get(); }
 
     // Render configuration
@@ -71,21 +76,88 @@ public:
     int GetCullFaceMode() const { return cullFaceMode; }
     void SetCullFaceMode(int mode); // 0=Back, 1=Front, 2=Both
 
+    // Mesh LODs
+    struct LODStats {
+        unsigned int trianglesDrawn = 0;
+        unsigned int trianglesSaved = 0;  // Compared to drawing every mesh at LOD 0
+    };
+
+    bool IsMeshLODEnabled() const { return meshLODEnabled; }
+    void SetMeshLOD(bool enabled) { meshLODEnabled = enabled; }
+    const LODStats& GetLODStats() const { return lodStats; }
+
+    // Frustum culling against the scene octree
+    bool IsFrustumCullingEnabled() const { return frustumCullingEnabled; }
+    void SetFrustumCulling(bool enabled) { frustumCullingEnabled = enabled; }
+    unsigned int GetVisibleObjectCount() const { return visibleObjectCount; }
+
+    // Software occlusion culling of the frustum query results (needs frustum culling on)
+    bool IsOcclusionCullingEnabled() const { return occlusionCullingEnabled; }
+    void SetOcclusionCulling(bool enabled) { occlusionCullingEnabled = enabled; }
+    const OcclusionCuller::Stats& GetOcclusionStats() const { return occlusionCuller.GetStats(); }
+
+    // Opaque pass ordering
+    struct PassStats {
+        unsigned int opaqueDraws = 0;
+        unsigned int cutoutDraws = 0;
+        unsigned int transparentObjects = 0;
+        unsigned int textureBinds = 0;  // Opaque pass, draws from the same array texture share one bind
+    };
+
+    bool IsFrontToBackSortingEnabled() const { return frontToBackSortingEnabled; }
+    void SetFrontToBackSorting(bool enabled) { frontToBackSortingEnabled = enabled; }
+
+    // Depth-only pass over the opaque draws, the color pass then shades each pixel once
+    bool IsDepthPrepassEnabled() const { return depthPrepassEnabled; }
+    void SetDepthPrepass(bool enabled) { depthPrepassEnabled = enabled; }
+
+    // Draws every shaded fragment additively, brighter means more overdraw
+    bool IsOverdrawViewEnabled() const { return overdrawViewEnabled; }
+    void SetOverdrawView(bool enabled) { overdrawViewEnabled = enabled; }
+
+    const PassStats& GetPassStats() const { return passStats; }
+
+    // Opaque draws read their texture handle from a storage buffer instead of binding it
+    // (ARB_bindless_texture). Without the extension the binding path is used.
+    bool IsBindlessSupported() const;
+    bool IsBindlessEnabled() const { return bindlessEnabled; }
+    void SetBindless(bool enabled) { bindlessEnabled = enabled; }
+
 private:
-    // Internal rendering methods
-    void DrawGameObjectRecursive(GameObject* gameObject, bool renderTransparentOnly = false);
+    struct RenderList;
+
+    // Internal rendering methods. Build* runs on the main thread, the rest of the list
+    // drawing on the render thread and only reads the list.
+    void BuildRenderList(RenderList& list);
+    void CollectOpaqueDraws(GameObject* gameObject, RenderList& list);
+    void SubmitRenderList(RenderList& list);
+    void SubmitScene(RenderList& list);
+    void DrawOpaquePass(const RenderList& list);
+    void DrawSelectedNormals(const RenderList& list, const Mesh& mesh, const glm::mat4& modelMatrix);
     void DrawGameObjectWithStencil(GameObject* gameObject);
+    // Reports the on-screen size of a textured mesh to the texture streamer
+    void RequestTextureLevel(Texture* texture, const ComponentMesh* meshComp,
+        const glm::mat4& modelMatrix, float viewportHeight);
     void ApplyRenderSettings();
+    void UpdateVisibility();
+    void CullOccludedObjects(const glm::mat4& viewProjection);
+    bool IsMeshVisible(const ComponentMesh* meshComp) const;
 
-    // Shaders
-    std::unique_ptr<Shader> defaultShader;
-    std::unique_ptr<Shader> lineShader;
-    std::unique_ptr<Shader> outlineShader;
+    // Shader variants (owned by the ShaderManager)
+    Shader* defaultShader = nullptr;
+    Shader* cutoutShader = nullptr;
+    Shader* arrayShader = nullptr;       // Opaque and cutout materials packed in TextureArrays
+    Shader* arrayCutoutShader = nullptr;
+    Shader* bindlessShader = nullptr;    // Only built when bindless textures are supported
+    Shader* bindlessCutoutShader = nullptr;
+    Shader* solidShader = nullptr;
 
     // Default assets
     std::unique_ptr<Texture> defaultTexture;
     Mesh sphere, cube, pyramid, cylinder, plane;
     unique_ptr<Camera> camera;
+    // Camera of the last drawn frame, a different one keeps the editor redrawing
+    glm::mat4 lastViewProjection = glm::mat4(0.0f);
 
     // OpenGL state
     bool depthTestEnabled = true;
@@ -95,6 +167,77 @@ private:
     float clearColorG = 0.25f;
     float clearColorB = 0.3f;
     int cullFaceMode = 0; // GL_BACK
+    bool meshLODEnabled = true;
+
+    // Last frame's LOD statistics
+    LODStats lodStats;
+
+    // Culling: mesh components found by the frustum query are stamped with frameIndex
+    bool frustumCullingEnabled = true;
+    unsigned int frameIndex = 0;
+    unsigned int visibleObjectCount = 0;
+    std::vector<GameObject*> visibleObjects;
+
+    bool occlusionCullingEnabled = true;
+    OcclusionCuller occlusionCuller;
+
+    // One entry per visible opaque or cutout mesh, rebuilt every frame
+    struct OpaqueDraw
+    {
+        const Mesh* mesh;
+        ComponentMesh* meshComp;     // Main thread only, for the texture streamer
+        Texture* texture;
+        unsigned int bindlessIndex;  // BindlessTextures::NO_INDEX when bound the usual way
+        glm::mat4 modelMatrix;
+        unsigned int lod;
+        float viewDepth;
+        bool cutout;
+        bool normals;                // Selected, draw its debug normals
+    };
+
+    struct MeshDraw
+    {
+        const Mesh* mesh;
+        Texture* texture;            // nullptr draws untextured
+        glm::mat4 modelMatrix;
+        unsigned int lod;
+        bool normals;
+    };
+
+    // Everything the render thread needs to draw a frame, copied out of the scene so it can be
+    // simulating the next one meanwhile. Meshes and textures are only deleted with the render
+    // thread idle, so the pointers stay valid until the list is drawn.
+    struct RenderList
+    {
+        glm::mat4 projection;
+        glm::mat4 view;
+        glm::vec3 clearColor;
+        bool drawScene = false;
+        bool overdrawView = false;
+        bool depthPrepass = false;
+        bool bindless = false;
+        bool sortByDepth = true;
+        bool vertexNormals = false;
+        bool faceNormals = false;
+        std::vector<OpaqueDraw> opaqueDraws;
+        std::vector<MeshDraw> outlines;
+        std::vector<MeshDraw> transparentDraws;  // Back to front
+    };
+
+    // Built into one while the render thread draws the other
+    RenderList renderLists[2];
+    int renderListIndex = 0;
+    // Matrices of the list being drawn, for the debug normals
+    glm::mat4 frameProjection = glm::mat4(1.0f);
+    glm::mat4 frameView = glm::mat4(1.0f);
+    // Counted by the render thread
+    std::atomic<unsigned int> textureBinds{ 0 };
+
+    bool frontToBackSortingEnabled = true;
+    bool depthPrepassEnabled = false;
+    bool overdrawViewEnabled = false;
+    bool bindlessEnabled = true;
+    PassStats passStats;
 
     // Normal visualization buffers (reused to avoid repeated allocations)
     GLuint normalLinesVAO = 0;
@@ -107,5 +250,8 @@ private:
         GLint view = -1;
         GLint model = -1;
         GLint texture1 = -1;
-    } defaultUniforms, lineUniforms, outlineUniforms;
+        GLint textureLayer = -1;
+        GLint materialIndex = -1;
+    } defaultUniforms, cutoutUniforms, solidUniforms, arrayUniforms, arrayCutoutUniforms,
+        bindlessUniforms, bindlessCutoutUniforms;
 };
\ No newline at end of file
@@ -0,0 +1,636 @@
+#include "SceneSerializer.h"
+#include "Application.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "ComponentMesh.h"
+#include "ComponentMaterial.h"
+#include "Texture.h"
+#include "TextureStreamer.h"
+#include "ThreadPool.h"
+#include "VirtualFileSystem.h"
+#include "Log.h"
+#include <windows.h>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+
+#define SCENE_MAGIC 0x4E435342 // "BSCN"
+#define SCENE_VERSION 2
+#define MESH_MAGIC 0x4853454D // "MESH"
+#define MESH_VERSION 1
+
+#define SCENES_FOLDER "Scenes"
+#define SCENE_DEFAULT_FILE "Scene.scene"
+#define LIBRARY_FOLDER "Library"
+#define LIBRARY_MESHES_FOLDER "Library\\Meshes"
+
+// SceneObjectRecord::flags
+#define SCENE_OBJECT_ACTIVE 0x1
+#define SCENE_OBJECT_MATERIAL 0x2
+
+struct SceneFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t objectCount;
+    uint32_t meshRefCount;
+    uint32_t meshCount;
+    uint32_t textureCount;
+    uint32_t stringBytes;
+};
+
+// Range of the string table
+struct SceneString
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SceneObjectRecord
+{
+    int32_t parent;         // Index of an earlier record, -1 for top level objects
+    SceneString name;
+    float position[3];
+    float rotation[4];      // x, y, z, w
+    float scale[3];
+    uint32_t firstMesh;     // Range of the mesh reference array
+    uint32_t meshCount;
+    int32_t texture;        // Texture path index, -1 for none
+    uint32_t flags;
+};
+
+// Mesh table entry, the model it was imported from lets hot reload find it again
+struct SceneMesh
+{
+    uint64_t id;            // Library file
+    SceneString source;     // Empty for meshes not imported from a file
+    uint32_t sourceIndex;
+    uint32_t reserved;
+};
+
+// Followed by the vertices, the indices and, per LOD, a MeshFileLOD and its indices
+struct MeshFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t lodCount;
+};
+
+struct MeshFileLOD
+{
+    uint32_t indexCount;
+    float error;
+};
+
+// FNV-1a over raw bytes, chained through hash
+static uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Reads a section of the file, advancing the cursor
+template <typename T>
+static void ReadArray(const unsigned char*& cursor, T* destination, size_t count)
+{
+    memcpy(destination, cursor, count * sizeof(T));
+    cursor += count * sizeof(T);
+}
+
+template <typename T>
+static void WriteArray(std::ofstream& file, const T* source, size_t count)
+{
+    file.write(reinterpret_cast<const char*>(source), count * sizeof(T));
+}
+
+SceneSerializer& SceneSerializer::GetInstance()
+{
+    static SceneSerializer instance;
+    return instance;
+}
+
+std::string SceneSerializer::GetDefaultScenePath()
+{
+    std::string execDir = VirtualFileSystem::GetExecutableDirectory();
+    CreateDirectoryA((execDir + "\\" + SCENES_FOLDER).c_str(), NULL);
+    return execDir + "\\" + SCENES_FOLDER + "\\" + SCENE_DEFAULT_FILE;
+}
+
+uint64_t SceneSerializer::HashMesh(const Mesh& mesh)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    // Counts first, so the sections cannot line up differently with the same bytes
+    uint32_t counts[3] = {
+        static_cast<uint32_t>(mesh.vertices.size()),
+        static_cast<uint32_t>(mesh.indices.size()),
+        static_cast<uint32_t>(mesh.lods.size())
+    };
+    hash = HashBytes(counts, sizeof(counts), hash);
+    hash = HashBytes(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex), hash);
+    hash = HashBytes(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int), hash);
+
+    for (const MeshLOD& lod : mesh.lods)
+    {
+        uint32_t count = static_cast<uint32_t>(lod.indices.size());
+        hash = HashBytes(&count, sizeof(count), hash);
+        hash = HashBytes(lod.indices.data(), lod.indices.size() * sizeof(unsigned int), hash);
+    }
+
+    return hash;
+}
+
+std::string SceneSerializer::GetMeshPath(uint64_t id)
+{
+    // Cached, this runs once per mesh on every save and load
+    static const std::string folder = []()
+    {
+        std::string execDir = VirtualFileSystem::GetExecutableDirectory();
+        CreateDirectoryA((execDir + "\\" + LIBRARY_FOLDER).c_str(), NULL);
+        CreateDirectoryA((execDir + "\\" + LIBRARY_MESHES_FOLDER).c_str(), NULL);
+        return execDir + "\\" + LIBRARY_MESHES_FOLDER;
+    }();
+
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%016llx.mesh", static_cast<unsigned long long>(id));
+    return folder + "\\" + fileName;
+}
+
+bool SceneSerializer::WriteMesh(const Mesh& mesh, const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    MeshFileHeader header;
+    header.magic = MESH_MAGIC;
+    header.version = MESH_VERSION;
+    header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+
+    WriteArray(file, &header, 1);
+    WriteArray(file, mesh.vertices.data(), mesh.vertices.size());
+    WriteArray(file, mesh.indices.data(), mesh.indices.size());
+
+    for (const MeshLOD& lod : mesh.lods)
+    {
+        MeshFileLOD lodHeader;
+        lodHeader.indexCount = static_cast<uint32_t>(lod.indices.size());
+        lodHeader.error = lod.error;
+
+        WriteArray(file, &lodHeader, 1);
+        WriteArray(file, lod.indices.data(), lod.indices.size());
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool SceneSerializer::ReadMesh(const std::string& path, Mesh& mesh)
+{
+    std::vector<unsigned char> bytes;
+    if (!VirtualFileSystem::GetInstance().ReadFile(path, bytes) || bytes.size() < sizeof(MeshFileHeader))
+        return false;
+
+    const unsigned char* cursor = bytes.data();
+    const unsigned char* end = bytes.data() + bytes.size();
+
+    MeshFileHeader header;
+    ReadArray(cursor, &header, 1);
+
+    if (header.magic != MESH_MAGIC || header.version != MESH_VERSION)
+        return false;
+
+    size_t meshBytes = header.vertexCount * sizeof(Vertex) + header.indexCount * sizeof(unsigned int);
+    if (static_cast<size_t>(end - cursor) < meshBytes)
+        return false;
+
+    mesh.vertices.resize(header.vertexCount);
+    mesh.indices.resize(header.indexCount);
+    ReadArray(cursor, mesh.vertices.data(), mesh.vertices.size());
+    ReadArray(cursor, mesh.indices.data(), mesh.indices.size());
+
+    mesh.lods.resize(header.lodCount);
+    for (MeshLOD& lod : mesh.lods)
+    {
+        if (static_cast<size_t>(end - cursor) < sizeof(MeshFileLOD))
+            return false;
+
+        MeshFileLOD lodHeader;
+        ReadArray(cursor, &lodHeader, 1);
+
+        if (static_cast<size_t>(end - cursor) < lodHeader.indexCount * sizeof(unsigned int))
+            return false;
+
+        lod.error = lodHeader.error;
+        lod.indices.resize(lodHeader.indexCount);
+        ReadArray(cursor, lod.indices.data(), lod.indices.size());
+    }
+
+    return true;
+}
+
+bool SceneSerializer::Save(GameObject* root, const std::string& path)
+{
+    if (root == nullptr)
+        return false;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<SceneObjectRecord> records;
+    std::vector<uint32_t> meshRefs;
+    std::vector<SceneMesh> meshTable;
+    std::vector<SceneString> texturePaths;
+    std::string strings;
+
+    std::unordered_map<const Mesh*, uint32_t> meshLookup;
+    std::unordered_map<std::string, uint32_t> textureLookup;
+    unsigned int meshesWritten = 0;
+
+    auto addString = [&strings](const std::string& text)
+    {
+        SceneString entry;
+        entry.offset = static_cast<uint32_t>(strings.size());
+        entry.length = static_cast<uint32_t>(text.size());
+        strings += text;
+        return entry;
+    };
+
+    // Depth-first, so every parent is written before its children
+    std::vector<std::pair<GameObject*, int32_t>> stack;
+    const std::vector<GameObject*>& topLevel = root->GetChildren();
+    for (auto it = topLevel.rbegin(); it != topLevel.rend(); ++it)
+        stack.emplace_back(*it, -1);
+
+    while (!stack.empty())
+    {
+        GameObject* gameObject = stack.back().first;
+        int32_t parentIndex = stack.back().second;
+        stack.pop_back();
+
+        if (gameObject->IsMarkedForDeletion())
+            continue;
+
+        SceneObjectRecord record;
+        memset(&record, 0, sizeof(record));
+        record.parent = parentIndex;
+        record.name = addString(gameObject->GetName());
+        record.texture = -1;
+        record.flags = gameObject->IsActive() ? SCENE_OBJECT_ACTIVE : 0;
+
+        Transform* transform = static_cast<Transform*>(gameObject->GetComponent(ComponentType::TRANSFORM));
+        glm::vec3 position = transform ? transform->GetPosition() : glm::vec3(0.0f);
+        glm::quat rotation = transform ? transform->GetRotationQuat() : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 scale = transform ? transform->GetScale() : glm::vec3(1.0f);
+
+        memcpy(record.position, &position[0], sizeof(record.position));
+        record.rotation[0] = rotation.x;
+        record.rotation[1] = rotation.y;
+        record.rotation[2] = rotation.z;
+        record.rotation[3] = rotation.w;
+        memcpy(record.scale, &scale[0], sizeof(record.scale));
+
+        // Each distinct mesh is hashed and written to the Library once
+        record.firstMesh = static_cast<uint32_t>(meshRefs.size());
+        for (Component* component : gameObject->GetComponentsOfType(ComponentType::MESH))
+        {
+            ComponentMesh* meshComp = static_cast<ComponentMesh*>(component);
+            if (!meshComp->HasMesh())
+                continue;
+
+            const std::shared_ptr<const Mesh>& mesh = meshComp->GetSharedMesh();
+            auto found = meshLookup.find(mesh.get());
+            if (found == meshLookup.end())
+            {
+                uint64_t id = HashMesh(*mesh);
+                std::string meshPath = GetMeshPath(id);
+
+                if (GetFileAttributesA(meshPath.c_str()) == INVALID_FILE_ATTRIBUTES)
+                {
+                    if (!WriteMesh(*mesh, meshPath))
+                    {
+                        LOG_DEBUG("SceneSerializer: could not write %s", meshPath.c_str());
+                        LOG_CONSOLE("ERROR: Failed to save scene, could not write mesh");
+                        return false;
+                    }
+                    ++meshesWritten;
+                }
+
+                CachedMesh& cached = meshes[id];
+                cached.mesh = mesh;
+                cached.bounds = meshComp->GetLocalAABB();
+
+                SceneMesh entry;
+                memset(&entry, 0, sizeof(entry));
+                entry.id = id;
+                entry.source = addString(meshComp->GetSourcePath());
+                entry.sourceIndex = meshComp->GetSourceIndex();
+
+                found = meshLookup.emplace(mesh.get(), static_cast<uint32_t>(meshTable.size())).first;
+                meshTable.push_back(entry);
+            }
+            meshRefs.push_back(found->second);
+        }
+        record.meshCount = static_cast<uint32_t>(meshRefs.size()) - record.firstMesh;
+
+        ComponentMaterial* material = static_cast<ComponentMaterial*>(gameObject->GetComponent(ComponentType::MATERIAL));
+        if (material != nullptr)
+        {
+            record.flags |= SCENE_OBJECT_MATERIAL;
+
+            if (!material->IsCheckerboard() && material->GetSharedTexture())
+            {
+                const std::string& texturePath = material->GetTexturePath();
+                auto inserted = textureLookup.emplace(texturePath, static_cast<uint32_t>(texturePaths.size()));
+                if (inserted.second)
+                {
+                    texturePaths.push_back(addString(texturePath));
+                    textures[texturePath] = material->GetSharedTexture();
+                }
+                record.texture = static_cast<int32_t>(inserted.first->second);
+            }
+        }
+
+        int32_t index = static_cast<int32_t>(records.size());
+        records.push_back(record);
+
+        const std::vector<GameObject*>& children = gameObject->GetChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+            stack.emplace_back(*it, index);
+    }
+
+    SceneFileHeader header;
+    header.magic = SCENE_MAGIC;
+    header.version = SCENE_VERSION;
+    header.objectCount = static_cast<uint32_t>(records.size());
+    header.meshRefCount = static_cast<uint32_t>(meshRefs.size());
+    header.meshCount = static_cast<uint32_t>(meshTable.size());
+    header.textureCount = static_cast<uint32_t>(texturePaths.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        LOG_DEBUG("SceneSerializer: could not open %s for writing", path.c_str());
+        LOG_CONSOLE("ERROR: Failed to save scene");
+        return false;
+    }
+
+    WriteArray(file, &header, 1);
+    WriteArray(file, records.data(), records.size());
+    WriteArray(file, meshRefs.data(), meshRefs.size());
+    WriteArray(file, meshTable.data(), meshTable.size());
+    WriteArray(file, texturePaths.data(), texturePaths.size());
+    WriteArray(file, strings.data(), strings.size());
+
+    if (!file)
+    {
+        LOG_CONSOLE("ERROR: Failed to save scene");
+        return false;
+    }
+
+    float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    LOG_DEBUG("Scene saved to %s", path.c_str());
+    LOG_CONSOLE("Scene saved: %u objects, %u meshes (%u new), %u textures in %.1f ms",
+        header.objectCount, header.meshCount, meshesWritten, header.textureCount, elapsedMs);
+
+    return true;
+}
+
+bool SceneSerializer::Load(const std::string& path, GameObject* parent)
+{
+    if (parent == nullptr)
+        return false;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // The whole file in one read, every section is parsed from memory
+    std::vector<unsigned char> bytes;
+    if (!VirtualFileSystem::GetInstance().ReadFile(path, bytes, IOPriority::Urgent) || bytes.size() < sizeof(SceneFileHeader))
+    {
+        LOG_DEBUG("SceneSerializer: could not read %s", path.c_str());
+        LOG_CONSOLE("ERROR: Failed to load scene - file not found");
+        return false;
+    }
+
+    const unsigned char* cursor = bytes.data();
+
+    SceneFileHeader header;
+    ReadArray(cursor, &header, 1);
+
+    size_t expectedSize = sizeof(SceneFileHeader) +
+        static_cast<size_t>(header.objectCount) * sizeof(SceneObjectRecord) +
+        static_cast<size_t>(header.meshRefCount) * sizeof(uint32_t) +
+        static_cast<size_t>(header.meshCount) * sizeof(SceneMesh) +
+        static_cast<size_t>(header.textureCount) * sizeof(SceneString) +
+        header.stringBytes;
+
+    if (header.magic != SCENE_MAGIC || header.version != SCENE_VERSION || bytes.size() != expectedSize)
+    {
+        LOG_DEBUG("SceneSerializer: %s is not a scene file of version %d", path.c_str(), SCENE_VERSION);
+        LOG_CONSOLE("ERROR: Failed to load scene - invalid file");
+        return false;
+    }
+
+    std::vector<SceneObjectRecord> records(header.objectCount);
+    std::vector<uint32_t> meshRefs(header.meshRefCount);
+    std::vector<SceneMesh> meshTable(header.meshCount);
+    std::vector<SceneString> texturePaths(header.textureCount);
+    ReadArray(cursor, records.data(), records.size());
+    ReadArray(cursor, meshRefs.data(), meshRefs.size());
+    ReadArray(cursor, meshTable.data(), meshTable.size());
+    ReadArray(cursor, texturePaths.data(), texturePaths.size());
+    const char* strings = reinterpret_cast<const char*>(cursor);
+
+    // Validated up front so a damaged file never leaves half a hierarchy behind
+    auto validString = [&header](const SceneString& entry)
+    {
+        return entry.offset <= header.stringBytes && entry.length <= header.stringBytes - entry.offset;
+    };
+
+    for (uint32_t i = 0; i < header.objectCount; ++i)
+    {
+        const SceneObjectRecord& record = records[i];
+        bool valid = record.parent < static_cast<int32_t>(i) && record.parent >= -1 &&
+            validString(record.name) &&
+            record.firstMesh <= header.meshRefCount && record.meshCount <= header.meshRefCount - record.firstMesh &&
+            record.texture < static_cast<int32_t>(header.textureCount);
+
+        if (!valid)
+        {
+            LOG_CONSOLE("ERROR: Failed to load scene - invalid object record");
+            return false;
+        }
+    }
+    for (uint32_t ref : meshRefs)
+    {
+        if (ref >= header.meshCount)
+        {
+            LOG_CONSOLE("ERROR: Failed to load scene - invalid mesh reference");
+            return false;
+        }
+    }
+    for (const SceneMesh& entry : meshTable)
+    {
+        if (!validString(entry.source))
+        {
+            LOG_CONSOLE("ERROR: Failed to load scene - invalid mesh source");
+            return false;
+        }
+    }
+    for (const SceneString& entry : texturePaths)
+    {
+        if (!validString(entry))
+        {
+            LOG_CONSOLE("ERROR: Failed to load scene - invalid texture path");
+            return false;
+        }
+    }
+
+    // Meshes still alive are shared, the rest are read from the Library on the workers
+    std::vector<std::shared_ptr<const Mesh>> sceneMeshes(header.meshCount);
+    std::vector<AABB> sceneBounds(header.meshCount);
+    std::vector<uint32_t> missingMeshes;
+
+    for (uint32_t i = 0; i < header.meshCount; ++i)
+    {
+        auto it = meshes.find(meshTable[i].id);
+        if (it != meshes.end())
+        {
+            sceneMeshes[i] = it->second.mesh.lock();
+            sceneBounds[i] = it->second.bounds;
+        }
+        if (!sceneMeshes[i])
+            missingMeshes.push_back(i);
+    }
+
+    std::vector<std::string> meshPaths(missingMeshes.size());
+    for (size_t i = 0; i < missingMeshes.size(); ++i)
+        meshPaths[i] = GetMeshPath(meshTable[missingMeshes[i]].id);
+
+    std::vector<Mesh> loadedMeshes(missingMeshes.size());
+    std::vector<char> meshLoaded(missingMeshes.size(), 0);
+    ThreadPool::GetInstance().ParallelFor(missingMeshes.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            meshLoaded[i] = ReadMesh(meshPaths[i], loadedMeshes[i]);
+            if (meshLoaded[i])
+                sceneBounds[missingMeshes[i]] = ComputeVertexBounds(loadedMeshes[i].vertices.data(), loadedMeshes[i].vertices.size());
+        }
+    }, 1);
+
+    for (size_t i = 0; i < missingMeshes.size(); ++i)
+    {
+        uint32_t meshIndex = missingMeshes[i];
+        if (!meshLoaded[i])
+        {
+            LOG_DEBUG("SceneSerializer: mesh %s is missing from the Library", meshPaths[i].c_str());
+            continue;
+        }
+
+        sceneMeshes[meshIndex] = ComponentMesh::CreateShared(std::move(loadedMeshes[i]));
+
+        CachedMesh& cached = meshes[meshTable[meshIndex].id];
+        cached.mesh = sceneMeshes[meshIndex];
+        cached.bounds = sceneBounds[meshIndex];
+    }
+
+    // Same for textures, keyed by path, decoding runs on the workers
+    std::vector<std::string> textureNames(header.textureCount);
+    std::vector<std::shared_ptr<Texture>> sceneTextures(header.textureCount);
+    std::vector<uint32_t> missingTextures;
+
+    for (uint32_t i = 0; i < header.textureCount; ++i)
+    {
+        textureNames[i].assign(strings + texturePaths[i].offset, texturePaths[i].length);
+
+        auto it = textures.find(textureNames[i]);
+        if (it != textures.end())
+            sceneTextures[i] = it->second.lock();
+        if (!sceneTextures[i])
+            missingTextures.push_back(i);
+    }
+
+    bool streaming = TextureStreamer::GetInstance().IsEnabled();
+    std::vector<TextureData> prepared(missingTextures.size());
+    ThreadPool::GetInstance().ParallelFor(missingTextures.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            Texture::Prepare(textureNames[missingTextures[i]], streaming, prepared[i]);
+    }, 1);
+
+    for (size_t i = 0; i < missingTextures.size(); ++i)
+    {
+        uint32_t textureIndex = missingTextures[i];
+        if (!prepared[i].error.empty())
+        {
+            LOG_DEBUG("SceneSerializer: texture %s could not be loaded", textureNames[textureIndex].c_str());
+            continue;
+        }
+
+        auto texture = std::make_shared<Texture>();
+        if (texture->Upload(prepared[i]))
+        {
+            sceneTextures[textureIndex] = texture;
+            textures[textureNames[textureIndex]] = texture;
+        }
+    }
+
+    // Records are in depth-first order, so a parent always exists before its children
+    std::vector<GameObject*> objects(header.objectCount, nullptr);
+
+    for (uint32_t i = 0; i < header.objectCount; ++i)
+    {
+        const SceneObjectRecord& record = records[i];
+
+        GameObject* gameObject = new GameObject(std::string(strings + record.name.offset, record.name.length));
+        gameObject->SetActive((record.flags & SCENE_OBJECT_ACTIVE) != 0);
+
+        // Set before the object has children, so the dirty flags do not cascade
+        Transform* transform = static_cast<Transform*>(gameObject->GetComponent(ComponentType::TRANSFORM));
+        transform->SetPosition(glm::vec3(record.position[0], record.position[1], record.position[2]));
+        transform->SetRotationQuat(glm::quat(record.rotation[3], record.rotation[0], record.rotation[1], record.rotation[2]));
+        transform->SetScale(glm::vec3(record.scale[0], record.scale[1], record.scale[2]));
+
+        for (uint32_t m = record.firstMesh; m < record.firstMesh + record.meshCount; ++m)
+        {
+            uint32_t meshIndex = meshRefs[m];
+            if (!sceneMeshes[meshIndex])
+                continue;
+
+            ComponentMesh* meshComp = static_cast<ComponentMesh*>(gameObject->CreateComponent(ComponentType::MESH));
+            meshComp->SetSharedMesh(sceneMeshes[meshIndex], sceneBounds[meshIndex]);
+
+            const SceneMesh& entry = meshTable[meshIndex];
+            meshComp->SetSource(std::string(strings + entry.source.offset, entry.source.length), entry.sourceIndex);
+        }
+
+        if (record.flags & SCENE_OBJECT_MATERIAL)
+        {
+            ComponentMaterial* material = static_cast<ComponentMaterial*>(gameObject->CreateComponent(ComponentType::MATERIAL));
+            if (record.texture >= 0 && sceneTextures[record.texture])
+                material->SetTexture(sceneTextures[record.texture], textureNames[record.texture]);
+        }
+
+        GameObject* owner = record.parent >= 0 ? objects[record.parent] : parent;
+        owner->AddChild(gameObject);
+        objects[i] = gameObject;
+    }
+
+    float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    LOG_DEBUG("Scene loaded from %s", path.c_str());
+    LOG_CONSOLE("Scene loaded: %u objects, %u meshes (%zu read), %u textures (%zu read) in %.1f ms",
+        header.objectCount, header.meshCount, missingMeshes.size(), header.textureCount, missingTextures.size(), elapsedMs);
+
+    return true;
+}
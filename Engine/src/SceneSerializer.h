@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include "AABB.h"
+
+class GameObject;
+class Texture;
+struct Mesh;
+
+// Binary scene files. The hierarchy is written as flat arrays in depth-first order:
+// one fixed-size record per object (parent index, TRS, mesh and texture references),
+// followed by the mesh table (ids and source models), texture paths and a string table. Meshes live in
+// Library/Meshes keyed by a hash of their contents, so a scene only references them.
+// Loading is a single read of the file; meshes and textures already in memory are reused.
+class SceneSerializer
+{
+public:
+    static SceneSerializer& GetInstance();
+
+    // Writes the children of root (not root itself)
+    bool Save(GameObject* root, const std::string& path);
+    // Adds the saved objects as children of parent
+    bool Load(const std::string& path, GameObject* parent);
+
+    // Scenes folder next to the executable
+    static std::string GetDefaultScenePath();
+
+    // Library mesh files, keyed by content so scenes and cooked models share them
+    static uint64_t HashMesh(const Mesh& mesh);
+    static std::string GetMeshPath(uint64_t id);
+    static bool WriteMesh(const Mesh& mesh, const std::string& path);
+    // Thread safe, no GL
+    static bool ReadMesh(const std::string& path, Mesh& mesh);
+
+private:
+    SceneSerializer() = default;
+
+    SceneSerializer(const SceneSerializer&) = delete;
+    SceneSerializer& operator=(const SceneSerializer&) = delete;
+
+    struct CachedMesh
+    {
+        std::weak_ptr<const Mesh> mesh;
+        AABB bounds;
+    };
+
+    // Weak references, the components own the resources
+    std::unordered_map<uint64_t, CachedMesh> meshes;
+    std::unordered_map<std::string, std::weak_ptr<Texture>> textures;
+};
@@ -4,11 +4,18 @@
 
 void SelectionManager::SetSelectedObject(GameObject* obj)
 {
+	for (GameObject* selected : selectedObjects)
+	{
+		if (selected != nullptr) selected->selected = false;
+	}
 	selectedObjects.clear();
+	selectedIndices.clear();
+	holes = 0;
+	hierarchyDirty = true;
 
 	if (obj != nullptr)
 	{
-		selectedObjects.push_back(obj);
+		PushSelected(obj);
 		LOG_DEBUG("Selected object: %s", obj->GetName().c_str());
 	}
 }
@@ -17,23 +24,30 @@ void SelectionManager::AddToSelection(GameObject* obj)
 {
 	if (obj == nullptr) return;
 
-	if (!IsSelected(obj))
+	if (!obj->selected)
 	{
-		selectedObjects.push_back(obj);
-		LOG_DEBUG("Added to selection: %s (total: %d)", obj->GetName().c_str(), static_cast<int>(selectedObjects.size()));
+		PushSelected(obj);
+		hierarchyDirty = true;
+		LOG_DEBUG("Added to selection: %s (total: %d)", obj->GetName().c_str(), GetSelectionCount());
 	}
 }
 
 void SelectionManager::RemoveFromSelection(GameObject* obj)
 {
-	if (obj == nullptr) return;
+	if (obj == nullptr || !obj->selected) return;
 
-	auto it = std::find(selectedObjects.begin(), selectedObjects.end(), obj);
-	if (it != selectedObjects.end())
+	auto it = selectedIndices.find(obj);
+	if (it != selectedIndices.end())
 	{
-		selectedObjects.erase(it);
-		LOG_DEBUG("Removed from selection: %s (total: %d)", obj->GetName().c_str(), static_cast<int>(selectedObjects.size()));
+		selectedObjects[it->second] = nullptr;
+		selectedIndices.erase(it);
+		++holes;
+
+		LOG_DEBUG("Removed from selection: %s (total: %d)", obj->GetName().c_str(), GetSelectionCount());
 	}
+
+	obj->selected = false;
+	hierarchyDirty = true;
 }
 
 void SelectionManager::ToggleSelection(GameObject* obj)
@@ -50,21 +64,117 @@ void SelectionManager::ToggleSelection(GameObject* obj)
 	}
 }
 
+void SelectionManager::AddHierarchyToSelection(GameObject* obj)
+{
+	if (obj == nullptr) return;
+
+	size_t previousCount = selectedObjects.size();
+	AddHierarchyRecursive(obj);
+
+	if (selectedObjects.size() != previousCount)
+	{
+		hierarchyDirty = true;
+		LOG_DEBUG("Added hierarchy of %s to selection (total: %d)", obj->GetName().c_str(), GetSelectionCount());
+	}
+}
+
+void SelectionManager::AddHierarchyRecursive(GameObject* obj)
+{
+	if (!obj->selected)
+	{
+		PushSelected(obj);
+	}
+
+	for (GameObject* child : obj->GetChildren())
+	{
+		AddHierarchyRecursive(child);
+	}
+}
+
 void SelectionManager::ClearSelection()
 {
 	if (!selectedObjects.empty())
 	{
 		LOG_DEBUG("Selection cleared");
+
+		for (GameObject* selected : selectedObjects)
+		{
+			if (selected != nullptr) selected->selected = false;
+		}
 		selectedObjects.clear();
+		selectedIndices.clear();
+		holes = 0;
+		hierarchyDirty = true;
 	}
 }
 
+void SelectionManager::PushSelected(GameObject* obj)
+{
+	obj->selected = true;
+	selectedIndices[obj] = selectedObjects.size();
+	selectedObjects.push_back(obj);
+}
+
+void SelectionManager::Compact() const
+{
+	if (holes == 0) return;
+
+	selectedObjects.erase(std::remove(selectedObjects.begin(), selectedObjects.end(), nullptr), selectedObjects.end());
+	for (size_t i = 0; i < selectedObjects.size(); ++i)
+	{
+		selectedIndices[selectedObjects[i]] = i;
+	}
+	holes = 0;
+}
+
+const std::vector<GameObject*>& SelectionManager::GetSelectedObjects() const
+{
+	Compact();
+	return selectedObjects;
+}
+
 GameObject* SelectionManager::GetSelectedObject() const
 {
+	Compact();
 	return selectedObjects.empty() ? nullptr : selectedObjects[0];
 }
 
 bool SelectionManager::IsSelected(GameObject* obj) const
 {
-	return std::find(selectedObjects.begin(), selectedObjects.end(), obj) != selectedObjects.end();
-}
\ No newline at end of file
+	return obj != nullptr && obj->selected;
+}
+
+bool SelectionManager::IsInSelectedHierarchy(GameObject* obj) const
+{
+	return obj != nullptr && hierarchyStamp != 0 && obj->hierarchySelectionStamp == hierarchyStamp;
+}
+
+void SelectionManager::RefreshHierarchySelection()
+{
+	if (!hierarchyDirty) return;
+
+	// Bumping the stamp invalidates every previous mark without touching the objects
+	hierarchyStamp++;
+	if (hierarchyStamp == 0) hierarchyStamp = 1;
+
+	Compact();
+	for (GameObject* selected : selectedObjects)
+	{
+		MarkHierarchyRecursive(selected);
+	}
+
+	hierarchyDirty = false;
+}
+
+void SelectionManager::MarkHierarchyRecursive(GameObject* obj)
+{
+	// Already reached through another selected ancestor
+	if (obj->hierarchySelectionStamp == hierarchyStamp) return;
+
+	obj->hierarchySelectionStamp = hierarchyStamp;
+
+	for (GameObject* child : obj->GetChildren())
+	{
+		MarkHierarchyRecursive(child);
+	}
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <unordered_map>
 #include <algorithm>
 
 class GameObject;
@@ -18,16 +19,44 @@ public:
 	void RemoveFromSelection(GameObject* obj);
 	void ToggleSelection(GameObject* obj);
 
+	// Adds an object and all of its descendants in one pass
+	void AddHierarchyToSelection(GameObject* obj);
+
 	// Clear all selections
 	void ClearSelection();
 
 	// Query methods
 	GameObject* GetSelectedObject() const;
-	const std::vector<GameObject*>& GetSelectedObjects() const { return selectedObjects; }
+	// Selection order, the first one is the primary selection
+	const std::vector<GameObject*>& GetSelectedObjects() const;
 	bool IsSelected(GameObject* obj) const;
-	bool HasSelection() const { return !selectedObjects.empty(); }
-	int GetSelectionCount() const { return static_cast<int>(selectedObjects.size()); }
+	bool HasSelection() const { return selectedObjects.size() > holes; }
+	int GetSelectionCount() const { return static_cast<int>(selectedObjects.size() - holes); }
+
+	// True if the object or any of its ancestors is selected (valid after RefreshHierarchySelection)
+	bool IsInSelectedHierarchy(GameObject* obj) const;
+
+	// Propagates the selection down to descendants, only does work after a selection change
+	void RefreshHierarchySelection();
+
+	// Reparenting moves objects in or out of a selected hierarchy
+	void MarkHierarchyDirty() { hierarchyDirty = true; }
 
 private:
-	std::vector<GameObject*> selectedObjects;
-};
\ No newline at end of file
+	void AddHierarchyRecursive(GameObject* obj);
+	void MarkHierarchyRecursive(GameObject* obj);
+
+	void PushSelected(GameObject* obj);
+	void Compact() const;
+
+	// Selection order, membership lives in the GameObject flag. Removal leaves a null hole in
+	// the slot found through selectedIndices, the holes are squeezed out on the next read, so
+	// deselecting many objects in a row (deleting a hierarchy) stays linear and keeps the order.
+	mutable std::vector<GameObject*> selectedObjects;
+	mutable std::unordered_map<GameObject*, size_t> selectedIndices;
+	mutable size_t holes = 0;
+
+	// Generation counter for the "ancestor is selected" flag
+	unsigned int hierarchyStamp = 0;
+	bool hierarchyDirty = false;
+};
@@ -0,0 +1,389 @@
+#include "ShaderManager.h"
+#include "Shaders.h"
+#include "Log.h"
+#include "VirtualFileSystem.h"
+#include <SDL3/SDL.h>
+#include <windows.h>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#define SHADER_CACHE_FOLDER "ShaderCache"
+#define SHADER_CACHE_MAGIC 0x43485353 // "SSHC"
+#define SHADER_CACHE_VERSION 1
+
+// glMaxShaderCompilerThreads from GL_KHR/ARB_parallel_shader_compile (not in the core profile glad was generated for)
+typedef void (APIENTRYP PFN_MaxShaderCompilerThreads)(GLuint count);
+
+// Stored in front of every cached binary
+struct ShaderCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t driverHash;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+
+// FNV-1a, chained through hash so several strings can be combined
+static uint64_t HashString(const std::string& text, uint64_t hash = 14695981039346656037ull)
+{
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+
+    // Separator, so "ab"+"c" and "a"+"bc" differ
+    hash ^= 0xFF;
+    hash *= 1099511628211ull;
+
+    return hash;
+}
+
+// The defines must come right after #version, which has to be the first line
+static std::string InsertDefines(const std::string& source, const std::string& defines)
+{
+    if (defines.empty())
+        return source;
+
+    std::string block = defines;
+    if (block.back() != '\n')
+        block += '\n';
+
+    if (source.compare(0, 8, "#version") == 0)
+    {
+        size_t lineEnd = source.find('\n');
+        if (lineEnd != std::string::npos)
+            return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
+    }
+
+    return block + source;
+}
+
+static float ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static GLuint CompileShader(GLenum type, const std::string& source)
+{
+    GLuint shader = glCreateShader(type);
+    const char* text = source.c_str();
+    glShaderSource(shader, 1, &text, NULL);
+    glCompileShader(shader);
+    return shader;
+}
+
+// Logs the compile error of a shader, true when it compiled
+static bool CheckShader(GLuint shader, const char* stage, const std::string& name)
+{
+    GLint success = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (success)
+        return true;
+
+    char infoLog[512];
+    glGetShaderInfoLog(shader, 512, NULL, infoLog);
+    LOG_DEBUG("ERROR: %s shader of '%s' failed to compile: %s", stage, name.c_str(), infoLog);
+    LOG_CONSOLE("ERROR: Shader '%s' failed to compile", name.c_str());
+    return false;
+}
+
+ShaderManager& ShaderManager::GetInstance()
+{
+    static ShaderManager instance;
+    return instance;
+}
+
+ShaderManager::ShaderManager()
+{
+}
+
+ShaderManager::~ShaderManager()
+{
+}
+
+void ShaderManager::Init()
+{
+    if (initialized)
+        return;
+
+    initialized = true;
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    binaryCacheSupported = formatCount > 0;
+
+    const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+    const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    driverHash = HashString(vendor ? vendor : "");
+    driverHash = HashString(renderer ? renderer : "", driverHash);
+    driverHash = HashString(version ? version : "", driverHash);
+
+    // Cache folder next to the executable
+    cacheDirectory = VirtualFileSystem::GetExecutableDirectory() + "\\" + SHADER_CACHE_FOLDER;
+    CreateDirectoryA(cacheDirectory.c_str(), NULL); // Fails harmlessly when it already exists
+
+    // Parallel compile: compile and link calls return immediately and the driver builds on its own threads
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+    const char* functionName = nullptr;
+    for (GLint i = 0; i < extensionCount && functionName == nullptr; ++i)
+    {
+        std::string extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension == "GL_KHR_parallel_shader_compile")
+            functionName = "glMaxShaderCompilerThreadsKHR";
+        else if (extension == "GL_ARB_parallel_shader_compile")
+            functionName = "glMaxShaderCompilerThreadsARB";
+    }
+
+    if (functionName != nullptr)
+    {
+        PFN_MaxShaderCompilerThreads maxCompilerThreads =
+            reinterpret_cast<PFN_MaxShaderCompilerThreads>(SDL_GL_GetProcAddress(functionName));
+
+        if (maxCompilerThreads != nullptr)
+        {
+            // 0xFFFFFFFF lets the driver choose the thread count
+            maxCompilerThreads(0xFFFFFFFFu);
+            parallelCompileSupported = true;
+        }
+    }
+
+    LOG_DEBUG("ShaderManager: binary cache %s, parallel compile %s",
+        binaryCacheSupported ? "supported" : "not supported",
+        parallelCompileSupported ? "supported" : "not supported");
+    LOG_DEBUG("ShaderManager: cache folder %s", cacheDirectory.c_str());
+}
+
+Shader* ShaderManager::GetVariant(unsigned int features)
+{
+    auto it = variants.find(features);
+    if (it != variants.end())
+        return it->second.get();
+
+    std::unique_ptr<Shader> variant = std::make_unique<Shader>();
+    if (!variant->CreateVariant(features))
+    {
+        LOG_DEBUG("ERROR: Shader variant '%s' failed to build", Shader::GetVariantName(features).c_str());
+        return nullptr;
+    }
+
+    Shader* result = variant.get();
+    variants[features] = std::move(variant);
+    return result;
+}
+
+void ShaderManager::ReleaseVariants()
+{
+    variants.clear();
+}
+
+void ShaderManager::BeginBatch()
+{
+    batchOpen = true;
+}
+
+bool ShaderManager::EndBatch()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    bool allLinked = true;
+    for (PendingProgram& program : pending)
+    {
+        if (!FinishProgram(program))
+            allLinked = false;
+    }
+
+    pending.clear();
+    batchOpen = false;
+
+    stats.buildMs += ElapsedMs(start);
+
+    LOG_CONSOLE("Shaders ready: %u from cache, %u compiled, %u failed (%.1f ms)", stats.cacheHits, stats.compiled,
+        stats.failed, stats.buildMs);
+
+    return allLinked;
+}
+
+GLuint ShaderManager::CreateProgram(const std::string& name, const std::string& vertexSource,
+    const std::string& fragmentSource, const std::string& defines)
+{
+    Init();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::string vertex = InsertDefines(vertexSource, defines);
+    std::string fragment = InsertDefines(fragmentSource, defines);
+    uint64_t hash = HashString(fragment, HashString(vertex));
+
+    GLuint program = glCreateProgram();
+
+    if (binaryCacheSupported)
+    {
+        if (LoadBinary(program, hash))
+        {
+            ++stats.cacheHits;
+            stats.buildMs += ElapsedMs(start);
+            LOG_DEBUG("ShaderManager: '%s' loaded from binary cache", name.c_str());
+            return program;
+        }
+
+        // Start from a clean program object after a rejected binary
+        glDeleteProgram(program);
+        program = glCreateProgram();
+    }
+
+    PendingProgram build;
+    build.name = name;
+    build.program = program;
+    build.hash = hash;
+
+    // No status queries here: with parallel compile these calls do not block
+    build.vertexShader = CompileShader(GL_VERTEX_SHADER, vertex);
+    build.fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragment);
+
+    glAttachShader(program, build.vertexShader);
+    glAttachShader(program, build.fragmentShader);
+
+    if (binaryCacheSupported)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+    glLinkProgram(program);
+
+    if (batchOpen)
+    {
+        pending.push_back(build);
+        stats.buildMs += ElapsedMs(start);
+        return program;
+    }
+
+    bool linked = FinishProgram(build);
+    stats.buildMs += ElapsedMs(start);
+
+    return linked ? program : 0;
+}
+
+bool ShaderManager::FinishProgram(PendingProgram& build)
+{
+    // Each query waits for its own compile/link only
+    bool compiled = CheckShader(build.vertexShader, "Vertex", build.name);
+    compiled = CheckShader(build.fragmentShader, "Fragment", build.name) && compiled;
+
+    GLint linked = 0;
+    if (compiled)
+    {
+        glGetProgramiv(build.program, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            char infoLog[512];
+            glGetProgramInfoLog(build.program, 512, NULL, infoLog);
+            LOG_DEBUG("ERROR: Shader '%s' failed to link: %s", build.name.c_str(), infoLog);
+            LOG_CONSOLE("ERROR: Shader '%s' failed to link", build.name.c_str());
+        }
+    }
+
+    // Shader objects are no longer needed once the program is linked
+    glDetachShader(build.program, build.vertexShader);
+    glDetachShader(build.program, build.fragmentShader);
+    glDeleteShader(build.vertexShader);
+    glDeleteShader(build.fragmentShader);
+
+    // Counted here, inside a batch the link status is only known in EndBatch
+    if (!linked)
+    {
+        ++stats.failed;
+        glDeleteProgram(build.program);
+        build.program = 0;
+        return false;
+    }
+
+    ++stats.compiled;
+
+    if (binaryCacheSupported)
+        SaveBinary(build.program, build.hash);
+
+    LOG_DEBUG("ShaderManager: '%s' compiled from source", build.name.c_str());
+    return true;
+}
+
+bool ShaderManager::LoadBinary(GLuint program, uint64_t hash)
+{
+    std::vector<unsigned char> bytes;
+    if (!VirtualFileSystem::GetInstance().ReadFile(GetCachePath(hash), bytes, IOPriority::Urgent))
+        return false;
+
+    ShaderCacheHeader header;
+    if (bytes.size() < sizeof(header))
+    {
+        ++stats.rejected;
+        return false;
+    }
+    memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION ||
+        header.sourceHash != hash || header.driverHash != driverHash || header.binaryLength == 0 ||
+        bytes.size() - sizeof(header) < header.binaryLength)
+    {
+        ++stats.rejected;
+        return false;
+    }
+
+    glProgramBinary(program, header.binaryFormat, bytes.data() + sizeof(header), static_cast<GLsizei>(header.binaryLength));
+
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+        ++stats.rejected;
+        LOG_DEBUG("ShaderManager: cached binary rejected by the driver, rebuilding from source");
+        return false;
+    }
+
+    return true;
+}
+
+void ShaderManager::SaveBinary(GLuint program, uint64_t hash)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+
+    ShaderCacheHeader header;
+    header.magic = SHADER_CACHE_MAGIC;
+    header.version = SHADER_CACHE_VERSION;
+    header.sourceHash = hash;
+    header.driverHash = driverHash;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<uint32_t>(written);
+
+    std::ofstream file(GetCachePath(hash), std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        LOG_DEBUG("ShaderManager: could not write the binary cache");
+        return;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+}
+
+std::string ShaderManager::GetCachePath(uint64_t hash) const
+{
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(hash));
+    return cacheDirectory + "\\" + fileName;
+}
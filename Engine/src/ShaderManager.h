@@ -0,0 +1,92 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+class Shader;
+
+// Builds linked GL programs from source strings. Linked programs are stored on
+// disk with glGetProgramBinary, keyed by a hash of their sources and defines,
+// and reloaded with glProgramBinary on the next run. A binary the driver does
+// not accept (driver update, different GPU) is rebuilt from source.
+// Also owns the variants of the shared shader template, one per feature combination.
+class ShaderManager
+{
+public:
+    struct Stats {
+        unsigned int cacheHits = 0;
+        unsigned int compiled = 0;       // Built and linked from source (no binary, or the binary was rejected)
+        unsigned int failed = 0;         // Built from source but failed to compile or link
+        unsigned int rejected = 0;       // Binaries found on disk but not accepted by the driver
+        float buildMs = 0.0f;            // Total time spent creating programs
+    };
+
+    static ShaderManager& GetInstance();
+
+    // Needs a current GL context: queries binary formats and the parallel compile extension
+    void Init();
+
+    // Programs created between BeginBatch and EndBatch are compiled and linked without
+    // waiting for each other, so drivers with parallel compile build them concurrently
+    void BeginBatch();
+    // Waits for the batch and caches the new binaries. False when any program failed.
+    bool EndBatch();
+
+    // Returns the program object (0 on failure). The defines are inserted after the #version line.
+    // Inside a batch the program is only usable (and its errors only known) after EndBatch.
+    GLuint CreateProgram(const std::string& name, const std::string& vertexSource,
+        const std::string& fragmentSource, const std::string& defines = "");
+
+    // Variant specialized for the given ShaderFeature flags, built on first request.
+    // Returns nullptr when it fails to build.
+    Shader* GetVariant(unsigned int features);
+    unsigned int GetVariantCount() const { return static_cast<unsigned int>(variants.size()); }
+
+    // Deletes every variant program, call while the GL context is still alive
+    void ReleaseVariants();
+
+    bool IsBinaryCacheSupported() const { return binaryCacheSupported; }
+    bool IsParallelCompileSupported() const { return parallelCompileSupported; }
+    const Stats& GetStats() const { return stats; }
+
+private:
+    ShaderManager();
+    ~ShaderManager();
+
+    ShaderManager(const ShaderManager&) = delete;
+    ShaderManager& operator=(const ShaderManager&) = delete;
+
+    // A program whose compile and link were issued but not checked yet
+    struct PendingProgram
+    {
+        std::string name;
+        GLuint program = 0;
+        GLuint vertexShader = 0;
+        GLuint fragmentShader = 0;
+        uint64_t hash = 0;
+    };
+
+    bool FinishProgram(PendingProgram& pending);
+    bool LoadBinary(GLuint program, uint64_t hash);
+    void SaveBinary(GLuint program, uint64_t hash);
+    std::string GetCachePath(uint64_t hash) const;
+
+    bool initialized = false;
+    bool binaryCacheSupported = false;
+    bool parallelCompileSupported = false;
+
+    // Identifies the driver, a binary built by another one is not even offered to glProgramBinary
+    uint64_t driverHash = 0;
+    std::string cacheDirectory;
+
+    bool batchOpen = false;
+    std::vector<PendingProgram> pending;
+
+    std::unordered_map<unsigned int, std::unique_ptr<Shader>> variants;
+
+    Stats stats;
+};
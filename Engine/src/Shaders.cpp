@@ -1,9 +1,106 @@
 #include "Shaders.h"
 #include <glad/glad.h>
-#include <iostream>
 #include <glm/gtc/type_ptr.hpp>
+#include "ShaderManager.h"
 #include "Log.h"
 
+// Source template shared by every variant. The #ifdef blocks are selected by the
+// defines built from the ShaderFeature flags, the #version line by GetVersionHeader.
+static const char* vertexShaderTemplate =
+    "layout (location = 0) in vec3 aPos;\n"
+    "\n"
+    "#ifdef TEXTURE\n"
+    "layout (location = 2) in vec2 aTexCoord;\n"
+    "out vec2 TexCoord;\n"
+    "#endif\n"
+    "\n"
+    "#ifdef VERTEX_COLOR\n"
+    "layout (location = 3) in vec4 aColor;\n"
+    "out vec4 VertexColor;\n"
+    "#endif\n"
+    "\n"
+    "#ifdef INSTANCING\n"
+    "layout (location = 4) in mat4 aInstanceModel;\n"
+    "#else\n"
+    "uniform mat4 model;\n"
+    "#endif\n"
+    "uniform mat4 view;\n"
+    "uniform mat4 projection;\n"
+    "\n"
+    "invariant gl_Position;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "#ifdef INSTANCING\n"
+    "   mat4 modelMatrix = aInstanceModel;\n"
+    "#else\n"
+    "   mat4 modelMatrix = model;\n"
+    "#endif\n"
+    "   gl_Position = projection * view * modelMatrix * vec4(aPos, 1.0);\n"
+    "#ifdef TEXTURE\n"
+    "   TexCoord = aTexCoord;\n"
+    "#endif\n"
+    "#ifdef VERTEX_COLOR\n"
+    "   VertexColor = aColor;\n"
+    "#endif\n"
+    "}\0";
+
+static const char* fragmentShaderTemplate =
+    "out vec4 FragColor;\n"
+    "uniform vec3 tintColor;\n"
+    "\n"
+    "#ifdef TEXTURE\n"
+    "in vec2 TexCoord;\n"
+    "#if defined(BINDLESS)\n"
+    "layout (std430, binding = 0) readonly buffer MaterialTextures { uvec2 textureHandles[]; };\n"
+    "uniform uint materialIndex;\n"
+    "#elif defined(TEXTURE_ARRAY)\n"
+    "uniform sampler2DArray texture1;\n"
+    "uniform float textureLayer;\n"
+    "#else\n"
+    "uniform sampler2D texture1;\n"
+    "#endif\n"
+    "#endif\n"
+    "\n"
+    "#ifdef VERTEX_COLOR\n"
+    "in vec4 VertexColor;\n"
+    "#endif\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "   vec4 color = vec4(tintColor, 1.0);\n"
+    "#if defined(BINDLESS)\n"
+    "   color *= texture(sampler2D(textureHandles[materialIndex]), TexCoord);\n"
+    "#elif defined(TEXTURE_ARRAY)\n"
+    "   color *= texture(texture1, vec3(TexCoord, textureLayer));\n"
+    "#elif defined(TEXTURE)\n"
+    "   color *= texture(texture1, TexCoord);\n"
+    "#endif\n"
+    "#ifdef VERTEX_COLOR\n"
+    "   color *= VertexColor;\n"
+    "#endif\n"
+    "#ifdef ALPHA_TEST\n"
+    "   // Discard fully transparent pixels (grass, leaves, etc.)\n"
+    "   if(color.a < 0.1)\n"
+    "       discard;\n"
+    "#endif\n"
+    "   FragColor = color;\n"
+    "}\0";
+
+// Define and display name of every feature, in ShaderFeature bit order
+static const char* featureDefines[SHADER_FEATURE_COUNT] = { "TEXTURE", "ALPHA_TEST", "VERTEX_COLOR", "INSTANCING", "TEXTURE_ARRAY", "BINDLESS" };
+static const char* featureNames[SHADER_FEATURE_COUNT] = { "Texture", "AlphaTest", "VertexColor", "Instancing", "TextureArray", "Bindless" };
+
+// Only the bindless variants need GLSL 4.60 (std430 buffer of handles) and the extension,
+// the others stay on 3.30 so they still build on drivers without either
+static std::string GetVersionHeader(unsigned int features, bool fragment)
+{
+    if (!(features & SHADER_FEATURE_BINDLESS))
+        return "#version 330 core\n";
+
+    return fragment ? "#version 460 core\n#extension GL_ARB_bindless_texture : require\n" : "#version 460 core\n";
+}
+
 Shader::Shader() : shaderProgram(0)
 {
 }
@@ -13,95 +110,41 @@ Shader::~Shader()
     Delete();
 }
 
-bool Shader::Create()
+bool Shader::CreateVariant(unsigned int variantFeatures)
 {
-    // Standard vertex shader with MVP transformation
-    const char* vertexShaderSource = "#version 330 core\n"
-        "layout (location = 0) in vec3 aPos;\n"
-        "layout (location = 1) in vec3 aNormal;\n"
-        "layout (location = 2) in vec2 aTexCoord;\n"
-        "\n"
-        "out vec2 TexCoord;\n"
-        "\n"
-        "uniform mat4 model;\n"
-        "uniform mat4 view;\n"
-        "uniform mat4 projection;\n"
-        "\n"
-        "void main()\n"
-        "{\n"
-        "   gl_Position = projection * view * model * vec4(aPos, 1.0);\n"
-        "   TexCoord = aTexCoord;\n"
-        "}\0";
-
-    unsigned int vertexShader;
-    vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
+    features = variantFeatures;
 
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    std::string defines;
+    for (unsigned int i = 0; i < SHADER_FEATURE_COUNT; ++i)
     {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Vertex Shader Compilation Failed\n" << infoLog << std::endl;
-        return false;
+        if (features & (1u << i))
+        {
+            defines += "#define ";
+            defines += featureDefines[i];
+            defines += "\n";
+        }
     }
 
-    // Fragment shader with alpha discard for vegetation/cutout textures
-    const char* fragmentShaderSource = "#version 330 core\n"
-        "out vec4 FragColor;\n"
-        "in vec2 TexCoord;\n"
-        "uniform sampler2D texture1;\n"
-        "uniform vec3 tintColor;\n"
-        "void main()\n"
-        "{\n"
-        "   vec4 texColor = texture(texture1, TexCoord);\n"
-        "   \n"
-        "   // Discard fully transparent pixels (grass, leaves, etc.)\n"
-        "   if(texColor.a < 0.1)\n"
-        "       discard;\n"
-        "   \n"
-        "   FragColor = vec4(texColor.rgb * tintColor, texColor.a);\n"
-        "}\0";
-
-    unsigned int fragmentShader;
-    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Fragment Shader Compilation Failed\n" << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        return false;
-    }
+    shaderProgram = ShaderManager::GetInstance().CreateProgram(GetVariantName(features),
+        GetVersionHeader(features, false) + vertexShaderTemplate, GetVersionHeader(features, true) + fragmentShaderTemplate, defines);
 
-    // Link shaders into program
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+    return shaderProgram != 0;
+}
 
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
+std::string Shader::GetVariantName(unsigned int variantFeatures)
+{
+    std::string name;
+    for (unsigned int i = 0; i < SHADER_FEATURE_COUNT; ++i)
     {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cerr << "ERROR: Shader Program Linking Failed\n" << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
+        if (variantFeatures & (1u << i))
+        {
+            if (!name.empty())
+                name += "+";
+            name += featureNames[i];
+        }
     }
 
-    // Clean up shader objects (no longer needed after linking)
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    LOG_CONSOLE("Shader created successfully!");
-
-    return true;
+    return name.empty() ? "Solid" : name;
 }
 
 void Shader::Use() const
@@ -131,250 +174,4 @@ void Shader::SetFloat(const std::string& name, float value) const
 void Shader::SetMat4(const std::string& name, const glm::mat4& mat) const
 {
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-}
-
-bool Shader::CreateSimpleColor()
-{
-    const char* vertexShaderSource = "#version 330 core\n"
-        "layout (location = 0) in vec3 aPos;\n"
-        "layout (location = 1) in vec2 aTexCoords;\n"
-        "\n"
-        "out vec2 TexCoords;\n"
-        "\n"
-        "uniform mat4 model;\n"
-        "uniform mat4 view;\n"
-        "uniform mat4 projection;\n"
-        "\n"
-        "void main()\n"
-        "{\n"
-        "   gl_Position = projection * view * model * vec4(aPos, 1.0);\n"
-        "   TexCoords = aTexCoords;\n"
-        "}\0";
-
-    unsigned int vertexShader;
-    vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Simple Vertex Shader Compilation Failed\n" << infoLog << std::endl;
-        return false;
-    }
-
-    // Fragment shader for semi-transparent surfaces (windows, glass, etc.)
-    const char* fragmentShaderSource = "#version 330 core\n"
-        "out vec4 FragColor;\n"
-        "in vec2 TexCoords;\n"
-        "\n"
-        "uniform sampler2D texture1;\n"
-        "uniform vec3 tintColor;\n"
-        "\n"
-        "void main()\n"
-        "{\n"
-        "   vec4 texColor = texture(texture1, TexCoords);\n"
-        "   \n"
-        "   FragColor = vec4(texColor.rgb * tintColor, texColor.a);\n"
-        "}\0";
-
-    unsigned int fragmentShader;
-    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Simple Fragment Shader Compilation Failed\n" << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        return false;
-    }
-
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    LOG_CONSOLE("Simple color shader created successfully!");
-
-    return true;
-}
-
-bool Shader::CreateWithDiscard()
-{
-    const char* vertexShaderSource = "#version 330 core\n"
-        "layout (location = 0) in vec3 aPos;\n"
-        "layout (location = 1) in vec3 aNormal;\n"
-        "layout (location = 2) in vec2 aTexCoord;\n"
-        "\n"
-        "out vec2 TexCoord;\n"
-        "\n"
-        "uniform mat4 model;\n"
-        "uniform mat4 view;\n"
-        "uniform mat4 projection;\n"
-        "\n"
-        "void main()\n"
-        "{\n"
-        "   gl_Position = projection * view * model * vec4(aPos, 1.0);\n"
-        "   TexCoord = aTexCoord;\n"
-        "}\0";
-
-    unsigned int vertexShader;
-    vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Discard Vertex Shader Compilation Failed\n" << infoLog << std::endl;
-        return false;
-    }
-
-    const char* fragmentShaderSource = "#version 330 core\n"
-        "out vec4 FragColor;\n"
-        "in vec2 TexCoord;\n"
-        "uniform sampler2D texture1;\n"
-        "uniform vec3 tintColor;\n"
-        "void main()\n"
-        "{\n"
-        "   vec4 texColor = texture(texture1, TexCoord);\n"
-        "   \n"
-        "   if(texColor.a < 0.1)\n"
-        "       discard;\n"
-        "   \n"
-        "   FragColor = vec4(texColor.rgb * tintColor, texColor.a);\n"
-        "}\0";
-
-    unsigned int fragmentShader;
-    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Discard Fragment Shader Compilation Failed\n" << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        return false;
-    }
-
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    LOG_CONSOLE("Discard shader created successfully!");
-
-    return true;
-}
-
-bool Shader::CreateSingleColor()
-{
-    // Minimal vertex shader for outline rendering
-    const char* vertexShaderSource = "#version 330 core\n"
-        "layout (location = 0) in vec3 aPos;\n"
-        "\n"
-        "uniform mat4 model;\n"
-        "uniform mat4 view;\n"
-        "uniform mat4 projection;\n"
-        "\n"
-        "void main()\n"
-        "{\n"
-        "   gl_Position = projection * view * model * vec4(aPos, 1.0);\n"
-        "}\0";
-
-    unsigned int vertexShader;
-    vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Outline Vertex Shader Compilation Failed\n" << infoLog << std::endl;
-        return false;
-    }
-
-    // Solid color fragment shader for selection outlines
-    const char* fragmentShaderSource = "#version 330 core\n"
-        "out vec4 FragColor;\n"
-        "\n"
-        "uniform vec3 outlineColor;\n"
-        "\n"
-        "void main()\n"
-        "{\n"
-        "   FragColor = vec4(outlineColor, 1.0);\n"
-        "}\0";
-
-    unsigned int fragmentShader;
-    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Outline Fragment Shader Compilation Failed\n" << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        return false;
-    }
-
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    LOG_CONSOLE("Outline shader created successfully!");
-
-    return true;
 }
\ No newline at end of file
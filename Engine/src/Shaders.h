@@ -3,28 +3,46 @@
 #include <string>
 #include <glm/glm.hpp>
 
+// Features a shader variant is compiled with. Each set flag becomes a #define in
+// the shared source template, so a variant contains only the code it uses.
+enum ShaderFeature : unsigned int
+{
+    SHADER_FEATURE_NONE = 0,            // Solid tintColor (outlines, debug lines, grid, depth pre-pass)
+    SHADER_FEATURE_TEXTURE = 1 << 0,    // Multiplies by texture1
+    SHADER_FEATURE_ALPHA_TEST = 1 << 1, // Discards fragments with alpha below 0.1 (cutout materials)
+    SHADER_FEATURE_VERTEX_COLOR = 1 << 2, // Multiplies by a per-vertex color (attribute 3)
+    SHADER_FEATURE_INSTANCING = 1 << 3, // Model matrix from per-instance attributes 4-7 instead of the uniform
+    SHADER_FEATURE_TEXTURE_ARRAY = 1 << 4, // With TEXTURE: texture1 is an array texture, sampled at layer textureLayer
+    SHADER_FEATURE_BINDLESS = 1 << 5,   // With TEXTURE: the texture handle is read from the storage buffer at materialIndex
+    SHADER_FEATURE_COUNT = 6
+};
+
 class Shader
 {
 public:
     Shader();
     ~Shader();
 
-    // Shader creation methods for different use cases
-    bool Create(); // Standard textured shader
-    bool CreateSimpleColor(); // Color shader for transparent objects
-    bool CreateWithDiscard(); // Shader with alpha discard for cutout textures
-    bool CreateSingleColor(); // Solid color shader for outlines
+    // Builds the template specialized for a ShaderFeature combination.
+    // Every variant declares gl_Position invariant, so a depth pre-pass drawn with
+    // one variant matches the depth of any other exactly.
+    bool CreateVariant(unsigned int features);
 
     void Use() const;
     void Delete();
 
     unsigned int GetProgramID() const { return shaderProgram; }
+    unsigned int GetFeatures() const { return features; }
 
     // Uniform setters
     void SetVec3(const std::string& name, const glm::vec3& value) const;
     void SetFloat(const std::string& name, float value) const;
     void SetMat4(const std::string& name, const glm::mat4& mat) const;
 
+    // "Texture+AlphaTest" style name of a feature combination
+    static std::string GetVariantName(unsigned int features);
+
 private:
     unsigned int shaderProgram;
-};
\ No newline at end of file
+    unsigned int features = SHADER_FEATURE_NONE;
+};
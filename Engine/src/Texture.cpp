@@ -1,26 +1,81 @@
 #include "Texture.h"
 #include <iostream>
 #include <windows.h>
-#include <IL/il.h>
-#include <IL/ilu.h>
 #include <fstream>
+#include <chrono>
 #include "Log.h"
+#include "TextureStreamer.h"
+#include "ImageDecoder.h"
+#include "VirtualFileSystem.h"
+#include "TextureUploader.h"
+#include "BindlessTextures.h"
+#include "RenderThread.h"
 
 #define CHECKERS_WIDTH 64
 #define CHECKERS_HEIGHT 64
 
+// Alpha values at or beyond these count as fully transparent / fully opaque
+#define ALPHA_TRANSPARENT_MAX 5
+#define ALPHA_OPAQUE_MIN 250
+// Cutout textures may have this fraction of partially transparent (antialiased edge) pixels
+#define ALPHA_CUTOUT_MAX_PARTIAL 0.1f
+
+// Levels up to this size are uploaded immediately, bigger ones go through the TextureUploader
+#define TEXTURE_DIRECT_UPLOAD_MAX (64 * 1024)
+
+// S3TC formats come from GL_EXT_texture_compression_s3tc, not the core profile glad was generated for
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 Texture::Texture() : textureID(0), width(0), height(0), nrChannels(0)
 {
 }
 
 Texture::~Texture()
+{
+    if (streamed)
+        TextureStreamer::GetInstance().Unregister(this);
+
+    if (textureID == 0 && arraySlot.array == 0)
+        return;
+
+    // Deleted once the frames still queued on the render thread are done with it
+    RenderThread::GetInstance().RunSync([this]()
+    {
+        TextureUploader::GetInstance().Cancel(this);
+        ReleaseStorage();
+    });
+}
+
+void Texture::ReleaseStorage()
 {
     if (textureID != 0)
+    {
+        BindlessTextures::GetInstance().ReleaseTexture(textureID);
         glDeleteTextures(1, &textureID);
+        textureID = 0;
+    }
+
+    if (arraySlot.array != 0)
+    {
+        TextureArrays::GetInstance().Release(arraySlot);
+        arraySlot = TextureArrays::Slot();
+    }
 }
 
 void Texture::CreateCheckerboard()
 {
+    RenderThread& renderThread = RenderThread::GetInstance();
+    if (!renderThread.IsGLThread())
+    {
+        renderThread.RunSync([this]() { CreateCheckerboard(); });
+        return;
+    }
+
     LOG_DEBUG("Creating checkerboard pattern texture");
     // patron checkerboard
     static GLubyte checkerImage[CHECKERS_HEIGHT][CHECKERS_WIDTH][4];
@@ -53,31 +108,15 @@ void Texture::CreateCheckerboard()
     width = CHECKERS_WIDTH;
     height = CHECKERS_HEIGHT;
     nrChannels = 4;
+    alphaMode = AlphaMode::Opaque;
+    format = TextureFormat::RGBA8;
+    mipCount = 1;
+    memorySize = CHECKERS_WIDTH * CHECKERS_HEIGHT * 4;
 
     LOG_DEBUG("Checkerboard texture created - Size: %dx%d, ID: %d", width, height, textureID);
     LOG_CONSOLE("Default checkerboard texture ready");
 }
 
-void Texture::InitDevIL()
-{
-    static bool initialized = false;
-    if (!initialized)
-    {
-        LOG_DEBUG("Initializing DevIL library");
-
-        ilInit();
-        iluInit();
-        initialized = true;
-
-        ILint devilVersion = ilGetInteger(IL_VERSION_NUM);
-        int devilMajor = devilVersion / 100;
-        int devilMinor = (devilVersion / 10) % 10;
-        int devilPatch = devilVersion % 10;
-        LOG_DEBUG("DevIL initialized successfully - Version: %d.%d.%d", devilMajor, devilMinor, devilPatch);
-        LOG_CONSOLE("DevIL library initialized - Version: %d.%d.%d", devilMajor, devilMinor, devilPatch);
-    }
-}
-
 // Helper function to normalize path separators
 std::string NormalizePath(const std::string& path)
 {
@@ -106,36 +145,23 @@ bool IsAbsolutePath(const std::string& path)
     return false;
 }
 
-// Helper function to check if file exists
-bool FileExists(const std::string& path)
+// Relative paths are relative to the repository root, two levels above the executable
+static std::string ResolveTexturePath(const std::string& path)
 {
-    std::ifstream file(path);
-    return file.good();
-}
-
-bool Texture::LoadFromFile(const std::string& path, bool flipVertically)
-{
- 
-    InitDevIL();
-
     std::string fullPath;
 
-    // If the path is absolute (dropped file), use it directly
-    if (IsAbsolutePath(path))
+    // Absolute paths (dropped files) and virtual paths of mounted files are used directly
+    if (IsAbsolutePath(path) || VirtualFileSystem::GetInstance().Exists(path))
     {
         fullPath = path;
     }
     else
     {
         // If relative, build path from executable
-        char buffer[MAX_PATH];
-        GetModuleFileNameA(NULL, buffer, MAX_PATH);
-        std::string execPath(buffer);
-        size_t pos = execPath.find_last_of("\\/");
-        std::string execDir = execPath.substr(0, pos);
+        std::string execDir = VirtualFileSystem::GetExecutableDirectory();
 
         // Go up two levels: from build/ to Engine/, then to root
-        pos = execDir.find_last_of("\\/");
+        size_t pos = execDir.find_last_of("\\/");
         std::string parentDir = execDir.substr(0, pos);
         pos = parentDir.find_last_of("\\/");
         std::string rootDir = parentDir.substr(0, pos);
@@ -145,99 +171,457 @@ bool Texture::LoadFromFile(const std::string& path, bool flipVertically)
     }
 
     // Normalize the path (convert backslashes to forward slashes)
-    fullPath = NormalizePath(fullPath);
+    return NormalizePath(fullPath);
+}
 
-    LOG_DEBUG("=== DevIL Texture Loading ===");
-    LOG_DEBUG("Path: %s", fullPath.c_str());
+bool Texture::LoadFromFile(const std::string& path, bool flipVertically)
+{
+    TextureData data;
+    Prepare(path, TextureStreamer::GetInstance().IsEnabled(), data);
+    return Upload(data);
+}
+
+bool Texture::Prepare(const std::string& path, bool streaming, TextureData& data)
+{
+    auto start = std::chrono::high_resolution_clock::now();
 
-    // Verify that the file exists before attempting to load it
-    if (!FileExists(fullPath))
+    data = TextureData();
+    data.requestedPath = path;
+    data.path = ResolveTexturePath(path);
+
+    // The stamp doubles as the existence check, no extra open of the file
+    data.sourceStamp = TextureCooker::GetSourceStamp(data.path);
+    if (data.sourceStamp == 0)
     {
-        LOG_DEBUG("ERROR: Texture file does not exist");
-        LOG_CONSOLE("ERROR: Texture file not found");
+        data.error = "file not found";
         return false;
     }
 
-    // Generate an image ID in DevIL
-    ILuint imageID;
-    ilGenImages(1, &imageID);
-    ilBindImage(imageID);
+    data.cookedPath = TextureCooker::GetCookedPath(data.path);
+    data.cooked = std::make_shared<CookedTexture>();
+    CookedTexture& cooked = *data.cooked;
+
+    // A cooked copy skips the decode, the mip generation and the driver side compression.
+    // With streaming only the small levels are read now, the rest follows once the texture is seen.
+    if (TextureCooker::ReadDDSInfo(data.cookedPath, cooked, data.sourceStamp))
+    {
+        // Small textures are packed into arrays instead, streaming them would save next to nothing
+        bool stream = streaming && !TextureArrays::IsSmallTexture(cooked.width, cooked.height);
+        int firstLevel = stream ? TextureStreamer::GetInitialLevel(cooked.width, cooked.height, cooked.levelCount) : 0;
+
+        if (TextureCooker::LoadDDS(data.cookedPath, cooked, data.sourceStamp, firstLevel))
+        {
+            data.fromLibrary = true;
+            data.streamed = stream;
+            data.loadMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            return true;
+        }
+    }
 
-    // Load the image
-    if (!ilLoadImage(fullPath.c_str()))
+    // First import: read the file once, decode it from memory and cook it for the next load.
+    // A raw entry of a mounted pack is decoded straight from the mapping.
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+    MappedFile mapped;
+    std::vector<unsigned char> bytes;
+    if (!vfs.MapFile(data.path, mapped))
     {
-        ILenum error = ilGetError();
-        LOG_DEBUG("ERROR: DevIL failed to load image");
-        LOG_DEBUG("DevIL Error: %s", iluErrorString(error));
-        LOG_CONSOLE("ERROR: DevIL failed to load texture");
-        ilDeleteImages(1, &imageID);
+        if (!vfs.ReadFile(data.path, bytes))
+        {
+            data.error = "could not read the file";
+            return false;
+        }
+        mapped.data = bytes.data();
+        mapped.size = bytes.size();
+    }
+
+    DecodedImage image;
+    std::string decodeError;
+    if (!ImageDecoder::Decode(mapped.data, mapped.size, image, decodeError))
+    {
+        data.error = "decode failed: " + decodeError;
         return false;
     }
 
-    // Convert the image to RGBA (standard format)
-    if (!ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE))
+    AlphaMode alphaMode = DetectAlphaMode(image.pixels.data(), image.width * image.height);
+    TextureFormat cookedFormat = TextureCooker::ChooseFormat(alphaMode);
+
+    if (!TextureCooker::Cook(image.pixels.data(), image.width, image.height, alphaMode, cookedFormat, cooked))
     {
-        LOG_DEBUG("ERROR: Failed to convert image to RGBA format");
-        LOG_CONSOLE("ERROR: Failed to convert texture format");
-        ilDeleteImages(1, &imageID);
+        data.error = "cooking failed";
         return false;
     }
 
-    // Get image information
-    width = ilGetInteger(IL_IMAGE_WIDTH);
-    height = ilGetInteger(IL_IMAGE_HEIGHT);
-    nrChannels = ilGetInteger(IL_IMAGE_CHANNELS);
-    ILubyte* data = ilGetData();
+    // Streaming reads the finer levels back from the file, so it needs the save to succeed
+    data.saved = TextureCooker::SaveDDS(data.cookedPath, cooked, data.sourceStamp);
+    data.streamed = streaming && data.saved && !TextureArrays::IsSmallTexture(cooked.width, cooked.height);
 
-    LOG_DEBUG("Image properties:");
-    LOG_DEBUG("  Width: %d pixels", width);
-    LOG_DEBUG("  Height: %d pixels", height);
-    LOG_DEBUG("  Channels: %d", nrChannels);
-    LOG_DEBUG("  Size: %.2f KB", (width * height * 4) / 1024.0f);
-    LOG_CONSOLE("DevIL: Texture loaded - %dx%d, %d channels, %.2f KB", width, height, nrChannels, (width * height * 4) / 1024.0f);
+    if (data.streamed)
+    {
+        int firstLevel = TextureStreamer::GetInitialLevel(cooked.width, cooked.height, cooked.levelCount);
+        cooked.mips.erase(cooked.mips.begin(), cooked.mips.begin() + firstLevel);
+        cooked.baseLevel = firstLevel;
+    }
 
-    if (!data)
+    data.loadMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    return true;
+}
+
+bool Texture::Upload(const TextureData& data)
+{
+    // The GL objects are created on the render thread, the caller waits for them
+    RenderThread& renderThread = RenderThread::GetInstance();
+    if (!renderThread.IsGLThread())
     {
-        LOG_DEBUG("ERROR: Failed to get image data from DevIL");
-        LOG_CONSOLE("ERROR: Could not extract texture data");
-        ilDeleteImages(1, &imageID);
+        bool uploaded = false;
+        renderThread.RunSync([&]() { uploaded = Upload(data); });
+        return uploaded;
+    }
+
+    LOG_DEBUG("=== Texture Loading ===");
+    LOG_DEBUG("Path: %s", data.path.c_str());
+
+    if (!data.error.empty())
+    {
+        LOG_DEBUG("ERROR: Texture %s: %s", data.path.c_str(), data.error.c_str());
+        LOG_CONSOLE("ERROR: Failed to load texture");
+        return false;
+    }
+
+    path = data.path;
+    cookedPath = data.cookedPath;
+    sourceStamp = data.sourceStamp;
+
+    if (!UploadCooked(data.cooked, data.cooked->baseLevel))
         return false;
+
+    if (data.streamed)
+    {
+        streamed = true;
+        TextureStreamer::GetInstance().Register(this);
     }
 
-    LOG_DEBUG("Creating OpenGL texture object");
+    LOG_DEBUG("  Size: %dx%d, alpha mode: %s", width, height,
+        alphaMode == AlphaMode::Opaque ? "Opaque" : alphaMode == AlphaMode::Cutout ? "Cutout" : "Blend");
 
-    // Generate and configure the texture in OpenGL
+    if (data.fromLibrary)
+    {
+        LOG_DEBUG("Loaded cooked texture %s", cookedPath.c_str());
+        LOG_CONSOLE("Texture loaded from Library - %dx%d, %s, %d of %d mips, %.2f KB (%.1f ms)",
+            width, height, TextureCooker::GetFormatName(format), mipCount, levelCount, memorySize / 1024.0f, data.loadMs);
+    }
+    else
+    {
+        if (!data.saved)
+            LOG_DEBUG("WARNING: Could not write cooked texture %s", cookedPath.c_str());
+
+        LOG_CONSOLE("stb_image: Texture decoded and cooked - %dx%d, %s, %d of %d mips, %.2f KB (%.1f ms)",
+            width, height, TextureCooker::GetFormatName(format), mipCount, levelCount, memorySize / 1024.0f, data.loadMs);
+    }
+
+    return true;
+}
+
+bool Texture::IsFormatSupported(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1:
+    case TextureFormat::BC3:
+    {
+        static int s3tcSupported = -1;
+        if (s3tcSupported < 0)
+        {
+            s3tcSupported = 0;
+
+            GLint extensionCount = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+            for (GLint i = 0; i < extensionCount; ++i)
+            {
+                std::string extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+                if (extension == "GL_EXT_texture_compression_s3tc")
+                {
+                    s3tcSupported = 1;
+                    break;
+                }
+            }
+
+            LOG_DEBUG("S3TC texture compression %s", s3tcSupported ? "supported" : "not supported, cooked textures are decompressed on load");
+        }
+        return s3tcSupported == 1;
+    }
+    case TextureFormat::BC7:
+        return true; // Core since GL 4.2
+    default:
+        return false;
+    }
+}
+
+bool Texture::UploadCooked(std::shared_ptr<const CookedTexture> cooked, int firstLevel)
+{
+    if (cooked == nullptr || cooked->mips.empty())
+        return false;
+
+    // Nothing is carried over from a previous load
+    TextureUploader::GetInstance().Cancel(this);
+    ReleaseStorage();
+
+    // GPUs without a hardware decoder for the format get the levels expanded on the CPU
+    format = IsFormatSupported(cooked->format) ? cooked->format : TextureFormat::RGBA8;
+    alphaMode = cooked->alphaMode;
+    width = cooked->width;
+    height = cooked->height;
+    nrChannels = 4;
+    levelCount = cooked->levelCount;
+
+    if (firstLevel == 0 && TextureArrays::GetInstance().IsEnabled() && TextureArrays::IsSmallTexture(width, height))
+        return UploadToArray(*cooked);
+
+    return SetResidentLevels(firstLevel, cooked);
+}
+
+bool Texture::UploadToArray(const CookedTexture& cooked)
+{
+    if (static_cast<int>(cooked.mips.size()) < levelCount)
+        return false;
+
+    GLenum internalFormat = GetInternalFormat(format);
+    arraySlot = TextureArrays::GetInstance().Allocate(format, internalFormat, width, height, levelCount);
+
+    // Small enough to go straight in, no uploader involved
+    glBindTexture(GL_TEXTURE_2D_ARRAY, arraySlot.array);
+
+    size_t memory = 0;
+    for (int level = 0; level < levelCount; ++level)
+    {
+        const TextureMip& mip = cooked.mips[level];
+
+        if (format == cooked.format && format != TextureFormat::RGBA8)
+        {
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, arraySlot.layer, mip.width, mip.height, 1,
+                internalFormat, static_cast<GLsizei>(mip.data.size()), mip.data.data());
+        }
+        else
+        {
+            std::vector<unsigned char> rgba;
+            const unsigned char* pixels = mip.data.data();
+            if (format != cooked.format)
+            {
+                rgba = TextureCooker::Decompress(mip.data.data(), mip.width, mip.height, cooked.format);
+                pixels = rgba.data();
+            }
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, arraySlot.layer, mip.width, mip.height, 1,
+                GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+
+        memory += TextureCooker::GetImageSize(format, mip.width, mip.height);
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // 2D view of the layer, shares its storage
     glGenTextures(1, &textureID);
+    glTextureView(textureID, GL_TEXTURE_2D, arraySlot.array, internalFormat, 0, levelCount, arraySlot.layer, 1);
+
     glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
 
-    // Configure wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    residentLevel = 0;
+    uploadedLevel = 0;
+    mipCount = levelCount;
+    memorySize = memory;
+
+    return true;
+}
+
+GLenum Texture::GetInternalFormat(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case TextureFormat::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TextureFormat::BC7:
+        return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    default:
+        return GL_RGBA8;
+    }
+}
+
+size_t Texture::GetMemorySizeFrom(int firstLevel) const
+{
+    size_t size = 0;
+    for (int level = firstLevel; level < levelCount; ++level)
+    {
+        int levelWidth = width >> level > 0 ? width >> level : 1;
+        int levelHeight = height >> level > 0 ? height >> level : 1;
+        size += TextureCooker::GetImageSize(format, levelWidth, levelHeight);
+    }
+    return size;
+}
+
+bool Texture::SetResidentLevels(int firstLevel, std::shared_ptr<const CookedTexture> levels)
+{
+    RenderThread& renderThread = RenderThread::GetInstance();
+    if (!renderThread.IsGLThread())
+    {
+        bool applied = false;
+        renderThread.RunSync([&]() { applied = SetResidentLevels(firstLevel, levels); });
+        return applied;
+    }
+
+    // Array layers always hold the whole chain
+    if (firstLevel < 0 || firstLevel >= levelCount || IsInArray())
+        return false;
+
+    // Every level comes either from the new data or from the current texture object
+    for (int level = firstLevel; level < levelCount; ++level)
+    {
+        bool provided = levels != nullptr && level >= levels->baseLevel &&
+            level < levels->baseLevel + static_cast<int>(levels->mips.size());
+        bool resident = textureID != 0 && level >= uploadedLevel;
+
+        if (!provided && !resident)
+            return false;
+    }
+
+    // Rows still queued for the old texture object are not needed anymore
+    TextureUploader& uploader = TextureUploader::GetInstance();
+    uploader.Cancel(this);
+
+    GLenum internalFormat = GetInternalFormat(format);
+
+    int baseWidth = width >> firstLevel > 0 ? width >> firstLevel : 1;
+    int baseHeight = height >> firstLevel > 0 ? height >> firstLevel : 1;
 
+    // Immutable storage: every level is allocated once here, then only filled
+    GLuint newID = 0;
+    glGenTextures(1, &newID);
+    glBindTexture(GL_TEXTURE_2D, newID);
+    glTexStorage2D(GL_TEXTURE_2D, levelCount - firstLevel, internalFormat, baseWidth, baseHeight);
+
+    // RGBA images are clamped, as they always were
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1 - firstLevel);
 
-    // Load image in OpenGL 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // Check if texture has alpha channel and adjust wrapping
-    if (nrChannels == 4)  // RGBA = tiene canal alpha
+    // Level firstLevel of the chain becomes level 0 of the new texture object. Coarsest first,
+    // so the queued levels finish in order and the base level only ever moves down.
+    size_t memory = 0;
+    int validLevel = levelCount;
+    for (int level = levelCount - 1; level >= firstLevel; --level)
     {
-        LOG_DEBUG("Texture has alpha channel - Setting wrapping to CLAMP_TO_EDGE");
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GLint mipLevel = level - firstLevel;
+        int levelWidth = width >> level > 0 ? width >> level : 1;
+        int levelHeight = height >> level > 0 ? height >> level : 1;
+        memory += TextureCooker::GetImageSize(format, levelWidth, levelHeight);
+
+        if (textureID != 0 && level >= uploadedLevel)
+        {
+            // Already on the GPU, nothing goes through the CPU
+            glCopyImageSubData(textureID, GL_TEXTURE_2D, level - residentLevel, 0, 0, 0,
+                newID, GL_TEXTURE_2D, mipLevel, 0, 0, 0, levelWidth, levelHeight, 1);
+            validLevel = level;
+            continue;
+        }
+
+        const TextureMip& mip = levels->mips[level - levels->baseLevel];
+
+        std::shared_ptr<const void> owner = levels;
+        const unsigned char* data = mip.data.data();
+        size_t size = mip.data.size();
+
+        // GPUs without a decoder for the format get it expanded here
+        if (format != levels->format)
+        {
+            std::shared_ptr<std::vector<unsigned char>> rgba = std::make_shared<std::vector<unsigned char>>(
+                TextureCooker::Decompress(mip.data.data(), mip.width, mip.height, levels->format));
+            data = rgba->data();
+            size = rgba->size();
+            owner = rgba;
+        }
+
+        // Small levels are cheaper to upload right away than to queue
+        if (size <= TEXTURE_DIRECT_UPLOAD_MAX && validLevel == level + 1)
+        {
+            if (format == TextureFormat::RGBA8)
+            {
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+                glTexSubImage2D(GL_TEXTURE_2D, mipLevel, 0, 0, levelWidth, levelHeight, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            }
+            else
+            {
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, mipLevel, 0, 0, levelWidth, levelHeight, internalFormat,
+                    static_cast<GLsizei>(size), data);
+            }
+            validLevel = level;
+        }
+        else
+        {
+            uploader.Queue(this, newID, mipLevel, level, levelWidth, levelHeight, format, internalFormat, owner, data, size);
+        }
     }
 
+    // Levels still queued are not sampled until they arrive
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, validLevel - firstLevel);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    LOG_DEBUG("OpenGL texture created - ID: %d", textureID);
+    if (textureID != 0)
+    {
+        BindlessTextures::GetInstance().ReleaseTexture(textureID);
+        glDeleteTextures(1, &textureID);
+    }
 
-    ilDeleteImages(1, &imageID);
+    textureID = newID;
+    residentLevel = firstLevel;
+    uploadedLevel = validLevel;
+    mipCount = levelCount - firstLevel;
+    memorySize = memory;
 
     return true;
 }
 
+void Texture::OnLevelUploaded(int level)
+{
+    uploadedLevel = level;
+
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level - residentLevel);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+AlphaMode Texture::DetectAlphaMode(const unsigned char* rgba, int pixelCount)
+{
+    int transparent = 0;
+    int partial = 0;
+
+    for (int i = 0; i < pixelCount; ++i)
+    {
+        unsigned char alpha = rgba[i * 4 + 3];
+
+        if (alpha <= ALPHA_TRANSPARENT_MAX)
+            ++transparent;
+        else if (alpha < ALPHA_OPAQUE_MIN)
+            ++partial;
+    }
+
+    if (transparent == 0 && partial == 0)
+        return AlphaMode::Opaque;
+
+    if (partial <= pixelCount * ALPHA_CUTOUT_MAX_PARTIAL)
+        return AlphaMode::Cutout;
+
+    return AlphaMode::Blend;
+}
+
 void Texture::Bind()
 {
     glBindTexture(GL_TEXTURE_2D, textureID);
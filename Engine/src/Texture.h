@@ -2,6 +2,34 @@
 
 #include <glad/glad.h>
 #include <string>
+#include <memory>
+#include <atomic>
+#include "TextureCooker.h"
+#include "TextureArrays.h"
+
+// How a texture's alpha channel has to be rendered
+enum class AlphaMode
+{
+    Opaque, // Alpha is always 1, no discard or blending needed
+    Cutout, // Alpha is (nearly) only 0 or 1, alpha test with discard
+    Blend   // Real translucency, sorted and blended after the opaque pass
+};
+
+// CPU side of a texture load, everything before the GL upload. Texture::Prepare fills it
+// without touching OpenGL or the log, so it can run on a worker thread.
+struct TextureData
+{
+    std::string requestedPath;
+    std::string path;          // Resolved full path of the source file
+    std::string cookedPath;
+    uint64_t sourceStamp = 0;
+    std::shared_ptr<CookedTexture> cooked; // Levels cooked->baseLevel and coarser are uploaded
+    bool fromLibrary = false;  // Read from the cooked file instead of decoded
+    bool saved = false;        // Freshly cooked and written to the Library
+    bool streamed = false;     // Finer levels are left to the TextureStreamer
+    float loadMs = 0.0f;
+    std::string error;         // Empty on success
+};
 
 class Texture
 {
@@ -9,14 +37,18 @@ public:
     Texture();
     ~Texture();
 
-    // Initialize DevIL (called automatically)
-    static void InitDevIL();
-
     void CreateCheckerboard();
 
-    // Load texture from file
+    // Load texture from file: Prepare and Upload on the calling thread
     bool LoadFromFile(const std::string& path, bool flipVertically = true);
 
+    // Uses the cooked copy in Library/Textures when it is up to date, otherwise reads the file
+    // once, decodes it and cooks it for the next load. Thread safe, several can run at once.
+    // With streaming only the small levels are kept.
+    static bool Prepare(const std::string& path, bool streaming, TextureData& data);
+    // Creates the GL texture, on the render thread when it runs (the same data can be uploaded to several textures)
+    bool Upload(const TextureData& data);
+
     // Bind/Unbind
     void Bind();
     void Unbind();
@@ -27,10 +59,64 @@ public:
     int GetWidth() const { return width; }
     int GetHeight() const { return height; }
     int GetChannels() const { return nrChannels; }
+    AlphaMode GetAlphaMode() const { return alphaMode; }
+    TextureFormat GetFormat() const { return format; }
+    int GetMipCount() const { return mipCount; }        // Levels on the GPU
+    size_t GetMemorySize() const { return memorySize; } // Bytes of GPU memory, all resident levels
+    const std::string& GetPath() const { return path; }
+
+    // Streaming: chain levels residentLevel..levelCount-1 are on the GPU (see TextureStreamer)
+    bool IsStreamed() const { return streamed; }
+    int GetResidentLevel() const { return residentLevel; }
+    int GetLevelCount() const { return levelCount; }
+    const std::string& GetCookedPath() const { return cookedPath; }
+    uint64_t GetSourceStamp() const { return sourceStamp; }
+
+    // GPU bytes with firstLevel as the finest resident level
+    size_t GetMemorySizeFrom(int firstLevel) const;
+
+    // Rebuilds the GL texture with levels firstLevel..levelCount-1. Levels found in 'levels' are
+    // uploaded from it, the others must already be resident and are copied on the GPU.
+    // Large levels are queued on the TextureUploader, sampling starts at the finest one uploaded.
+    bool SetResidentLevels(int firstLevel, std::shared_ptr<const CookedTexture> levels);
+
+    // Packed as a layer of a shared array texture (see TextureArrays), GetID is then a 2D view of the layer
+    bool IsInArray() const { return arraySlot.array != 0; }
+    GLuint GetArrayID() const { return arraySlot.array; }
+    int GetArrayLayer() const { return arraySlot.layer; }
+
+    // Levels still queued on the TextureUploader
+    bool IsUploading() const { return uploadedLevel > residentLevel; }
+    // Called by the TextureUploader when chain level 'level' is submitted
+    void OnLevelUploaded(int level);
 
 private:
     GLuint textureID;
     int width;
     int height;
     int nrChannels;
+    AlphaMode alphaMode = AlphaMode::Opaque;
+    TextureFormat format = TextureFormat::RGBA8;
+    int mipCount = 1;
+    size_t memorySize = 0;
+
+    std::string path;
+    std::string cookedPath;
+    uint64_t sourceStamp = 0;
+    int levelCount = 1;
+    int residentLevel = 0;
+    std::atomic<int> uploadedLevel{ 0 }; // Finest chain level with its data on the GPU, written by the render thread
+    bool streamed = false;
+    TextureArrays::Slot arraySlot;
+
+    // Creates the GL texture from precomputed mips, compressed when the GPU supports the format
+    bool UploadCooked(std::shared_ptr<const CookedTexture> cooked, int firstLevel);
+    // Small textures go into a layer of a TextureArrays array instead of their own storage
+    bool UploadToArray(const CookedTexture& cooked);
+    void ReleaseStorage();
+    static bool IsFormatSupported(TextureFormat format);
+    static GLenum GetInternalFormat(TextureFormat format);
+
+    // Classifies RGBA8 pixel data by the values found in its alpha channel
+    static AlphaMode DetectAlphaMode(const unsigned char* rgba, int pixelCount);
 };
\ No newline at end of file
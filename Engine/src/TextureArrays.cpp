@@ -0,0 +1,123 @@
+#include "TextureArrays.h"
+#include "Log.h"
+#include <algorithm>
+
+// Largest side of a packed texture, bigger ones are drawn often enough to be worth their own object
+#define TEXTURE_ARRAY_MAX_SIZE 256
+// Layers of the first array of a size and format. The storage is immutable, so once an array
+// is full the next one gets twice the layers, up to the maximum: a texture used once costs a
+// few layers instead of a full array, while common sizes still end up in a few large arrays.
+#define TEXTURE_ARRAY_MIN_LAYERS 4
+#define TEXTURE_ARRAY_MAX_LAYERS 32
+
+TextureArrays& TextureArrays::GetInstance()
+{
+    static TextureArrays instance;
+    return instance;
+}
+
+bool TextureArrays::IsSmallTexture(int width, int height)
+{
+    return width <= TEXTURE_ARRAY_MAX_SIZE && height <= TEXTURE_ARRAY_MAX_SIZE;
+}
+
+TextureArrays::Slot TextureArrays::Allocate(TextureFormat format, GLenum internalFormat, int width, int height, int levelCount)
+{
+    int layerCount = TEXTURE_ARRAY_MIN_LAYERS;
+
+    for (TextureArray& array : arrays)
+    {
+        if (array.format != format || array.width != width || array.height != height || array.levelCount != levelCount)
+            continue;
+
+        if (array.usedCount == array.layerCount)
+        {
+            layerCount = std::max(layerCount, std::min(array.layerCount * 2, TEXTURE_ARRAY_MAX_LAYERS));
+            continue;
+        }
+
+        int layer = static_cast<int>(std::find(array.used.begin(), array.used.end(), false) - array.used.begin());
+        array.used[layer] = true;
+        ++array.usedCount;
+
+        Slot slot;
+        slot.array = array.id;
+        slot.layer = layer;
+        return slot;
+    }
+
+    TextureArray array;
+    array.format = format;
+    array.width = width;
+    array.height = height;
+    array.levelCount = levelCount;
+    array.layerCount = layerCount;
+    array.used.assign(layerCount, false);
+
+    for (int level = 0; level < levelCount; ++level)
+    {
+        int levelWidth = width >> level > 0 ? width >> level : 1;
+        int levelHeight = height >> level > 0 ? height >> level : 1;
+        array.layerSize += TextureCooker::GetImageSize(format, levelWidth, levelHeight);
+    }
+
+    glGenTextures(1, &array.id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, array.id);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, levelCount, internalFormat, width, height, layerCount);
+
+    // Same sampling as standalone cooked textures
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    LOG_DEBUG("Texture array created: %dx%d %s, %d layers", width, height, TextureCooker::GetFormatName(format), layerCount);
+
+    array.used[0] = true;
+    array.usedCount = 1;
+    arrays.push_back(array);
+
+    Slot slot;
+    slot.array = array.id;
+    slot.layer = 0;
+    return slot;
+}
+
+void TextureArrays::Release(const Slot& slot)
+{
+    for (auto it = arrays.begin(); it != arrays.end(); ++it)
+    {
+        if (it->id != slot.array)
+            continue;
+
+        if (slot.layer >= 0 && slot.layer < it->layerCount && it->used[slot.layer])
+        {
+            it->used[slot.layer] = false;
+            --it->usedCount;
+        }
+
+        if (it->usedCount == 0)
+        {
+            glDeleteTextures(1, &it->id);
+            arrays.erase(it);
+        }
+        return;
+    }
+}
+
+unsigned int TextureArrays::GetUsedLayers() const
+{
+    unsigned int layers = 0;
+    for (const TextureArray& array : arrays)
+        layers += array.usedCount;
+    return layers;
+}
+
+size_t TextureArrays::GetMemorySize() const
+{
+    size_t size = 0;
+    for (const TextureArray& array : arrays)
+        size += array.layerSize * array.layerCount;
+    return size;
+}
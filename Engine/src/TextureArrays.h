@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <cstddef>
+#include "TextureCooker.h"
+
+// Packs small textures of the same size and format as layers of shared 2D array
+// textures. Each packed Texture keeps a 2D view of its own layer for the code that
+// binds it alone, while the renderer binds the whole array once and picks the layer
+// per draw, so many differently textured props need a single texture bind.
+class TextureArrays
+{
+public:
+    // One layer of an array texture
+    struct Slot
+    {
+        GLuint array = 0;
+        int layer = -1;
+    };
+
+    static TextureArrays& GetInstance();
+
+    // Only affects textures loaded afterwards
+    bool IsEnabled() const { return enabled; }
+    void SetEnabled(bool value) { enabled = value; }
+
+    // Size limit for packing. Thread safe, also used to keep these textures out of streaming.
+    static bool IsSmallTexture(int width, int height);
+
+    // Reserves a layer in an array of matching textures, creating a new array when all are full.
+    // The array has immutable storage with every level of the chain, new arrays get more layers
+    // the more matching textures there already are.
+    Slot Allocate(TextureFormat format, GLenum internalFormat, int width, int height, int levelCount);
+    // Frees the layer, the array is deleted with its last layer
+    void Release(const Slot& slot);
+
+    unsigned int GetArrayCount() const { return static_cast<unsigned int>(arrays.size()); }
+    unsigned int GetUsedLayers() const;
+    size_t GetMemorySize() const;
+
+private:
+    TextureArrays() = default;
+
+    TextureArrays(const TextureArrays&) = delete;
+    TextureArrays& operator=(const TextureArrays&) = delete;
+
+    struct TextureArray
+    {
+        GLuint id = 0;
+        TextureFormat format = TextureFormat::RGBA8;
+        int width = 0;
+        int height = 0;
+        int levelCount = 0;
+        int layerCount = 0;
+        size_t layerSize = 0;     // Bytes of one layer with all of its levels
+        std::vector<bool> used;
+        int usedCount = 0;
+    };
+
+    bool enabled = true;
+    std::vector<TextureArray> arrays;
+};
@@ -0,0 +1,1250 @@
+#include "TextureCooker.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include "VirtualFileSystem.h"
+#include "AssetDatabase.h"
+#include <windows.h>
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+
+// Bump when the cooked output changes, old Library files are then recooked
+#define COOKER_VERSION 1
+#define COOKED_MAGIC 0x4B4F4F43 // "COOK", stored in the DDS reserved fields
+
+#define LIBRARY_FOLDER "Library"
+#define LIBRARY_TEXTURES_FOLDER "Library\\Textures"
+
+// Must match the discard threshold of the ALPHA_TEST shader variant
+#define ALPHA_TEST_THRESHOLD 0.1f
+
+// Below this many block rows an image is compressed on the calling thread only
+#define COMPRESS_MIN_BLOCK_ROWS 4
+
+// DDS header flags and formats
+#define DDSD_CAPS 0x1
+#define DDSD_HEIGHT 0x2
+#define DDSD_WIDTH 0x4
+#define DDSD_PITCH 0x8
+#define DDSD_PIXELFORMAT 0x1000
+#define DDSD_MIPMAPCOUNT 0x20000
+#define DDSD_LINEARSIZE 0x80000
+#define DDPF_ALPHAPIXELS 0x1
+#define DDPF_FOURCC 0x4
+#define DDPF_RGB 0x40
+#define DDSCAPS_COMPLEX 0x8
+#define DDSCAPS_TEXTURE 0x1000
+#define DDSCAPS_MIPMAP 0x400000
+#define DXGI_FORMAT_BC7_UNORM 98
+#define D3D10_RESOURCE_DIMENSION_TEXTURE2D 3
+
+#define FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+// DWORD offsets inside the 124 byte DDS_HEADER
+enum DDSHeaderField
+{
+    DDS_SIZE = 0, DDS_FLAGS = 1, DDS_HEIGHT = 2, DDS_WIDTH = 3, DDS_PITCH_OR_LINEAR_SIZE = 4,
+    DDS_MIPMAP_COUNT = 6,
+    DDS_COOKED_MAGIC = 7, DDS_COOKED_VERSION = 8, DDS_COOKED_ALPHA_MODE = 9, DDS_COOKED_STAMP_LO = 10, DDS_COOKED_STAMP_HI = 11,
+    DDS_PF_SIZE = 18, DDS_PF_FLAGS = 19, DDS_PF_FOURCC = 20, DDS_PF_BIT_COUNT = 21,
+    DDS_PF_RMASK = 22, DDS_PF_GMASK = 23, DDS_PF_BMASK = 24, DDS_PF_AMASK = 25,
+    DDS_CAPS1 = 26,
+    DDS_HEADER_DWORDS = 31
+};
+
+// BC7 4-bit index interpolation weights (out of 64)
+static const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static int ClampInt(int value, int low, int high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+static float ClampFloat(float value, float low, float high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+// ---------------------------------------------------------------------------
+// Mip generation
+// ---------------------------------------------------------------------------
+
+struct SrgbToLinearTable
+{
+    float values[256];
+
+    SrgbToLinearTable()
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            float c = i / 255.0f;
+            values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+    }
+};
+
+static const float* GetSrgbToLinearTable()
+{
+    // Built once, thread safe since cooking may run on the workers
+    static const SrgbToLinearTable table;
+    return table.values;
+}
+
+static unsigned char LinearToSrgb(float linear)
+{
+    linear = ClampFloat(linear, 0.0f, 1.0f);
+    float c = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+    return static_cast<unsigned char>(ClampInt(static_cast<int>(c * 255.0f + 0.5f), 0, 255));
+}
+
+static float AlphaCoverage(const TextureMip& mip, float scale)
+{
+    const float threshold = ALPHA_TEST_THRESHOLD * 255.0f;
+    size_t pixels = static_cast<size_t>(mip.width) * mip.height;
+    size_t covered = 0;
+
+    for (size_t i = 0; i < pixels; ++i)
+    {
+        if (mip.data[i * 4 + 3] * scale >= threshold)
+            ++covered;
+    }
+
+    return pixels > 0 ? static_cast<float>(covered) / pixels : 0.0f;
+}
+
+// Averaging makes thin alpha-tested detail (leaves, fences) fade away in the smaller
+// mips. Scaling the alpha of a level brings its coverage back to the base level's.
+static void ScaleAlphaToCoverage(TextureMip& mip, float targetCoverage)
+{
+    if (targetCoverage <= 0.0f || targetCoverage >= 1.0f)
+        return;
+
+    float low = 0.0f;
+    float high = 4.0f;
+    for (int i = 0; i < 12; ++i)
+    {
+        float middle = (low + high) * 0.5f;
+        if (AlphaCoverage(mip, middle) < targetCoverage)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    size_t pixels = static_cast<size_t>(mip.width) * mip.height;
+    for (size_t i = 0; i < pixels; ++i)
+    {
+        unsigned char& alpha = mip.data[i * 4 + 3];
+        alpha = static_cast<unsigned char>(ClampInt(static_cast<int>(alpha * high + 0.5f), 0, 255));
+    }
+}
+
+void TextureCooker::GenerateMips(const unsigned char* rgba, int width, int height, bool preserveCoverage, std::vector<TextureMip>& mips)
+{
+    const float* toLinear = GetSrgbToLinearTable();
+
+    mips.clear();
+
+    TextureMip base;
+    base.width = width;
+    base.height = height;
+    base.data.assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+    mips.push_back(std::move(base));
+
+    float baseCoverage = preserveCoverage ? AlphaCoverage(mips[0], 1.0f) : 0.0f;
+
+    while (mips.back().width > 1 || mips.back().height > 1)
+    {
+        const TextureMip& source = mips.back();
+
+        TextureMip level;
+        level.width = source.width > 1 ? source.width / 2 : 1;
+        level.height = source.height > 1 ? source.height / 2 : 1;
+        level.data.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+        for (int y = 0; y < level.height; ++y)
+        {
+            for (int x = 0; x < level.width; ++x)
+            {
+                // 2x2 box, clamped at the edges of odd sized levels
+                int sx[2] = { x * 2, ClampInt(x * 2 + 1, 0, source.width - 1) };
+                int sy[2] = { y * 2, ClampInt(y * 2 + 1, 0, source.height - 1) };
+
+                float weighted[3] = { 0.0f, 0.0f, 0.0f };
+                float plain[3] = { 0.0f, 0.0f, 0.0f };
+                float alphaSum = 0.0f;
+
+                for (int j = 0; j < 2; ++j)
+                {
+                    for (int i = 0; i < 2; ++i)
+                    {
+                        const unsigned char* texel = &source.data[(static_cast<size_t>(sy[j]) * source.width + sx[i]) * 4];
+                        float alpha = texel[3] / 255.0f;
+
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            float linear = toLinear[texel[c]];
+                            weighted[c] += linear * alpha;
+                            plain[c] += linear;
+                        }
+                        alphaSum += alpha;
+                    }
+                }
+
+                // Alpha weighting keeps the color of invisible texels from bleeding into visible ones
+                unsigned char* out = &level.data[(static_cast<size_t>(y) * level.width + x) * 4];
+                for (int c = 0; c < 3; ++c)
+                {
+                    out[c] = LinearToSrgb(alphaSum > 0.0f ? weighted[c] / alphaSum : plain[c] * 0.25f);
+                }
+                out[3] = static_cast<unsigned char>(ClampInt(static_cast<int>(alphaSum * 0.25f * 255.0f + 0.5f), 0, 255));
+            }
+        }
+
+        if (preserveCoverage)
+            ScaleAlphaToCoverage(level, baseCoverage);
+
+        mips.push_back(std::move(level));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Endpoint fitting shared by the BC1 and BC7 encoders
+// ---------------------------------------------------------------------------
+
+// Endpoints along the principal axis of the block, pulled in by insetFraction of their
+// distance at both ends (the extremes are rarely the best endpoints once quantized)
+static void FitEndpoints(const float pixels[16][4], int channels, float insetFraction, float e0[4], float e1[4])
+{
+    float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < channels; ++c)
+            mean[c] += pixels[i][c] / 16.0f;
+    }
+
+    float covariance[4][4] = {};
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int a = 0; a < channels; ++a)
+        {
+            for (int b = 0; b < channels; ++b)
+            {
+                covariance[a][b] += (pixels[i][a] - mean[a]) * (pixels[i][b] - mean[b]);
+            }
+        }
+    }
+
+    // Power iteration, starting from the covariance row of the channel that varies most
+    // (a bounding box diagonal can be orthogonal to the axis when channels are anti-correlated)
+    int widest = 0;
+    for (int c = 1; c < channels; ++c)
+    {
+        if (covariance[c][c] > covariance[widest][widest])
+            widest = c;
+    }
+
+    float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float length = 0.0f;
+    for (int c = 0; c < channels; ++c)
+    {
+        axis[c] = covariance[widest][c];
+        length += axis[c] * axis[c];
+    }
+
+    if (length < 1e-12f)
+    {
+        // Flat block
+        for (int c = 0; c < channels; ++c)
+        {
+            e0[c] = mean[c];
+            e1[c] = mean[c];
+        }
+        return;
+    }
+
+    length = std::sqrt(length);
+    for (int c = 0; c < channels; ++c)
+        axis[c] /= length;
+
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float nextLength = 0.0f;
+
+        for (int a = 0; a < channels; ++a)
+        {
+            for (int b = 0; b < channels; ++b)
+                next[a] += covariance[a][b] * axis[b];
+            nextLength += next[a] * next[a];
+        }
+
+        if (nextLength < 1e-12f)
+            break;
+
+        // Normalized every step, the covariance magnitudes would overflow otherwise
+        nextLength = std::sqrt(nextLength);
+        for (int c = 0; c < channels; ++c)
+            axis[c] = next[c] / nextLength;
+    }
+
+    float minT = 1e30f;
+    float maxT = -1e30f;
+    for (int i = 0; i < 16; ++i)
+    {
+        float t = 0.0f;
+        for (int c = 0; c < channels; ++c)
+            t += (pixels[i][c] - mean[c]) * axis[c];
+
+        minT = t < minT ? t : minT;
+        maxT = t > maxT ? t : maxT;
+    }
+
+    float inset = (maxT - minT) * insetFraction;
+    minT += inset;
+    maxT -= inset;
+
+    for (int c = 0; c < channels; ++c)
+    {
+        e0[c] = ClampFloat(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+        e1[c] = ClampFloat(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+    }
+}
+
+// Least squares endpoints for fixed interpolation factors (0 = e0, 1 = e1)
+static bool SolveEndpoints(const float pixels[16][4], int channels, const float factors[16], float e0[4], float e1[4])
+{
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float bx[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    for (int i = 0; i < 16; ++i)
+    {
+        float a = 1.0f - factors[i];
+        float b = factors[i];
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+
+        for (int c = 0; c < channels; ++c)
+        {
+            ax[c] += a * pixels[i][c];
+            bx[c] += b * pixels[i][c];
+        }
+    }
+
+    float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f)
+        return false;
+
+    for (int c = 0; c < channels; ++c)
+    {
+        e0[c] = ClampFloat((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+        e1[c] = ClampFloat((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+    }
+
+    return true;
+}
+
+static void LoadBlock(const unsigned char* block, float pixels[16][4])
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+            pixels[i][c] = block[i * 4 + c];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// BC1 / BC3
+// ---------------------------------------------------------------------------
+
+static uint16_t PackRGB565(const float color[3])
+{
+    int r = ClampInt(static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+    int g = ClampInt(static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+    int b = ClampInt(static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(uint16_t packed, int color[3])
+{
+    int r = (packed >> 11) & 31;
+    int g = (packed >> 5) & 63;
+    int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+// Four color palette (c0 > c1), as every decoder interpolates it
+static void BuildBC1Palette(uint16_t c0, uint16_t c1, int palette[4][3])
+{
+    UnpackRGB565(c0, palette[0]);
+    UnpackRGB565(c1, palette[1]);
+
+    for (int c = 0; c < 3; ++c)
+    {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+}
+
+// Quantizes the endpoints, picks the nearest palette entry per pixel and returns the squared error
+static float FitBC1(const float pixels[16][4], const float e0[3], const float e1[3], uint16_t& c0, uint16_t& c1, uint32_t& indices)
+{
+    c0 = PackRGB565(e0);
+    c1 = PackRGB565(e1);
+
+    // Four color mode needs c0 > c1
+    if (c0 < c1)
+    {
+        uint16_t swap = c0;
+        c0 = c1;
+        c1 = swap;
+    }
+
+    int palette[4][3];
+    BuildBC1Palette(c0, c1, palette);
+
+    // Equal endpoints decode in three color mode, where only index 0 is still c0
+    int paletteSize = c0 == c1 ? 1 : 4;
+
+    indices = 0;
+    float error = 0.0f;
+    for (int i = 0; i < 16; ++i)
+    {
+        int bestIndex = 0;
+        float bestDistance = 1e30f;
+
+        for (int p = 0; p < paletteSize; ++p)
+        {
+            float distance = 0.0f;
+            for (int c = 0; c < 3; ++c)
+            {
+                float d = pixels[i][c] - palette[p][c];
+                distance += d * d;
+            }
+
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                bestIndex = p;
+            }
+        }
+
+        indices |= static_cast<uint32_t>(bestIndex) << (i * 2);
+        error += bestDistance;
+    }
+
+    return error;
+}
+
+static void EncodeBC1Color(const float pixels[16][4], unsigned char* out)
+{
+    float e0[4], e1[4];
+    FitEndpoints(pixels, 3, 1.0f / 16.0f, e0, e1);
+
+    uint16_t c0, c1;
+    uint32_t indices;
+    float error = FitBC1(pixels, e0, e1, c0, c1, indices);
+
+    // One least squares pass on the chosen indices
+    static const float indexFactors[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    float factors[16];
+    for (int i = 0; i < 16; ++i)
+        factors[i] = indexFactors[(indices >> (i * 2)) & 3];
+
+    if (c0 != c1 && SolveEndpoints(pixels, 3, factors, e0, e1))
+    {
+        uint16_t refined0, refined1;
+        uint32_t refinedIndices;
+        float refinedError = FitBC1(pixels, e0, e1, refined0, refined1, refinedIndices);
+
+        if (refinedError < error)
+        {
+            c0 = refined0;
+            c1 = refined1;
+            indices = refinedIndices;
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(c0 & 0xFF);
+    out[1] = static_cast<unsigned char>(c0 >> 8);
+    out[2] = static_cast<unsigned char>(c1 & 0xFF);
+    out[3] = static_cast<unsigned char>(c1 >> 8);
+    for (int i = 0; i < 4; ++i)
+        out[4 + i] = static_cast<unsigned char>((indices >> (i * 8)) & 0xFF);
+}
+
+static void DecodeBC1Color(const unsigned char* in, bool forceFourColors, unsigned char* block)
+{
+    uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<uint32_t>(in[7]) << 24);
+
+    int palette[4][3];
+    BuildBC1Palette(c0, c1, palette);
+    int alpha[4] = { 255, 255, 255, 255 };
+
+    if (c0 <= c1 && !forceFourColors)
+    {
+        // Three colors plus transparent black
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        alpha[3] = 0;
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        int index = (indices >> (i * 2)) & 3;
+        block[i * 4 + 0] = static_cast<unsigned char>(palette[index][0]);
+        block[i * 4 + 1] = static_cast<unsigned char>(palette[index][1]);
+        block[i * 4 + 2] = static_cast<unsigned char>(palette[index][2]);
+        block[i * 4 + 3] = static_cast<unsigned char>(alpha[index]);
+    }
+}
+
+static void BuildAlphaPalette(int a0, int a1, int palette[8])
+{
+    palette[0] = a0;
+    palette[1] = a1;
+
+    if (a0 > a1)
+    {
+        for (int i = 2; i < 8; ++i)
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+    }
+    else
+    {
+        for (int i = 2; i < 6; ++i)
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+static void EncodeBC3Alpha(const unsigned char* block, unsigned char* out)
+{
+    int low = 255;
+    int high = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int alpha = block[i * 4 + 3];
+        low = alpha < low ? alpha : low;
+        high = alpha > high ? alpha : high;
+    }
+
+    // Eight interpolated levels between the extremes
+    int palette[8];
+    BuildAlphaPalette(high, low, palette);
+
+    uint64_t indices = 0;
+    if (high != low)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            int alpha = block[i * 4 + 3];
+            int bestIndex = 0;
+            int bestDistance = 256;
+
+            for (int p = 0; p < 8; ++p)
+            {
+                int distance = std::abs(alpha - palette[p]);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    bestIndex = p;
+                }
+            }
+
+            indices |= static_cast<uint64_t>(bestIndex) << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(high);
+    out[1] = static_cast<unsigned char>(low);
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = static_cast<unsigned char>((indices >> (i * 8)) & 0xFF);
+}
+
+static void DecodeBC3Alpha(const unsigned char* in, unsigned char* block)
+{
+    int palette[8];
+    BuildAlphaPalette(in[0], in[1], palette);
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+
+    for (int i = 0; i < 16; ++i)
+        block[i * 4 + 3] = static_cast<unsigned char>(palette[(indices >> (i * 3)) & 7]);
+}
+
+void TextureCooker::EncodeBC1Block(const unsigned char* block, unsigned char* out)
+{
+    float pixels[16][4];
+    LoadBlock(block, pixels);
+    EncodeBC1Color(pixels, out);
+}
+
+void TextureCooker::EncodeBC3Block(const unsigned char* block, unsigned char* out)
+{
+    float pixels[16][4];
+    LoadBlock(block, pixels);
+
+    EncodeBC3Alpha(block, out);
+    EncodeBC1Color(pixels, out + 8);
+}
+
+// ---------------------------------------------------------------------------
+// BC7 (mode 6: one subset, RGBA 7.7.7.7 endpoints with a p-bit each, 4-bit indices)
+// ---------------------------------------------------------------------------
+
+struct BC7Mode6Block
+{
+    int endpoints[2][4]; // 7-bit values
+    int pBits[2];
+    unsigned char indices[16];
+};
+
+static float FitBC7Mode6(const float pixels[16][4], const float e0[4], const float e1[4], int p0, int p1, BC7Mode6Block& result)
+{
+    result.pBits[0] = p0;
+    result.pBits[1] = p1;
+
+    int values[2][4];
+    for (int c = 0; c < 4; ++c)
+    {
+        result.endpoints[0][c] = ClampInt(static_cast<int>((e0[c] - p0) * 0.5f + 0.5f), 0, 127);
+        result.endpoints[1][c] = ClampInt(static_cast<int>((e1[c] - p1) * 0.5f + 0.5f), 0, 127);
+        values[0][c] = (result.endpoints[0][c] << 1) | p0;
+        values[1][c] = (result.endpoints[1][c] << 1) | p1;
+    }
+
+    int palette[16][4];
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+            palette[i][c] = ((64 - bc7Weights[i]) * values[0][c] + bc7Weights[i] * values[1][c] + 32) >> 6;
+    }
+
+    float error = 0.0f;
+    for (int i = 0; i < 16; ++i)
+    {
+        int bestIndex = 0;
+        float bestDistance = 1e30f;
+
+        for (int p = 0; p < 16; ++p)
+        {
+            float distance = 0.0f;
+            for (int c = 0; c < 4; ++c)
+            {
+                float d = pixels[i][c] - palette[p][c];
+                distance += d * d;
+            }
+
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                bestIndex = p;
+            }
+        }
+
+        result.indices[i] = static_cast<unsigned char>(bestIndex);
+        error += bestDistance;
+    }
+
+    return error;
+}
+
+// Tries the four p-bit combinations
+static float FitBC7Mode6BestPBits(const float pixels[16][4], const float e0[4], const float e1[4], BC7Mode6Block& result)
+{
+    float bestError = 1e30f;
+
+    for (int p = 0; p < 4; ++p)
+    {
+        BC7Mode6Block candidate;
+        float error = FitBC7Mode6(pixels, e0, e1, p & 1, p >> 1, candidate);
+
+        if (error < bestError)
+        {
+            bestError = error;
+            result = candidate;
+        }
+    }
+
+    return bestError;
+}
+
+// Little endian bit stream over a 16 byte block
+struct BlockBits
+{
+    unsigned char* bytes;
+    int position = 0;
+
+    void Write(uint32_t value, int count)
+    {
+        for (int i = 0; i < count; ++i, ++position)
+        {
+            if (value & (1u << i))
+                bytes[position >> 3] |= static_cast<unsigned char>(1u << (position & 7));
+        }
+    }
+
+    uint32_t Read(int count)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < count; ++i, ++position)
+        {
+            if (bytes[position >> 3] & (1u << (position & 7)))
+                value |= 1u << i;
+        }
+        return value;
+    }
+};
+
+void TextureCooker::EncodeBC7Block(const unsigned char* block, unsigned char* out)
+{
+    float pixels[16][4];
+    LoadBlock(block, pixels);
+
+    float e0[4], e1[4];
+    FitEndpoints(pixels, 4, 1.0f / 32.0f, e0, e1);
+
+    BC7Mode6Block best;
+    float bestError = FitBC7Mode6BestPBits(pixels, e0, e1, best);
+
+    // Least squares pass on the chosen indices
+    float factors[16];
+    for (int i = 0; i < 16; ++i)
+        factors[i] = bc7Weights[best.indices[i]] / 64.0f;
+
+    if (SolveEndpoints(pixels, 4, factors, e0, e1))
+    {
+        BC7Mode6Block refined;
+        if (FitBC7Mode6BestPBits(pixels, e0, e1, refined) < bestError)
+            best = refined;
+    }
+
+    // The anchor (first) index is stored without its top bit, so it must be below 8
+    if (best.indices[0] >= 8)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            int swap = best.endpoints[0][c];
+            best.endpoints[0][c] = best.endpoints[1][c];
+            best.endpoints[1][c] = swap;
+        }
+
+        int swap = best.pBits[0];
+        best.pBits[0] = best.pBits[1];
+        best.pBits[1] = swap;
+
+        for (int i = 0; i < 16; ++i)
+            best.indices[i] = static_cast<unsigned char>(15 - best.indices[i]);
+    }
+
+    memset(out, 0, 16);
+    BlockBits bits;
+    bits.bytes = out;
+
+    bits.Write(1u << 6, 7); // Mode 6
+    for (int c = 0; c < 4; ++c)
+    {
+        bits.Write(best.endpoints[0][c], 7);
+        bits.Write(best.endpoints[1][c], 7);
+    }
+    bits.Write(best.pBits[0], 1);
+    bits.Write(best.pBits[1], 1);
+
+    bits.Write(best.indices[0], 3);
+    for (int i = 1; i < 16; ++i)
+        bits.Write(best.indices[i], 4);
+}
+
+static void DecodeBC7(const unsigned char* in, unsigned char* block)
+{
+    // Only mode 6 is ever written by the cooker, other modes decode as opaque black
+    if ((in[0] & 0x7F) != 0x40)
+    {
+        memset(block, 0, 64);
+        for (int i = 0; i < 16; ++i)
+            block[i * 4 + 3] = 255;
+        return;
+    }
+
+    BlockBits bits;
+    bits.bytes = const_cast<unsigned char*>(in);
+    bits.position = 7;
+
+    int endpoints[2][4];
+    for (int c = 0; c < 4; ++c)
+    {
+        endpoints[0][c] = bits.Read(7);
+        endpoints[1][c] = bits.Read(7);
+    }
+
+    int p0 = bits.Read(1);
+    int p1 = bits.Read(1);
+    for (int c = 0; c < 4; ++c)
+    {
+        endpoints[0][c] = (endpoints[0][c] << 1) | p0;
+        endpoints[1][c] = (endpoints[1][c] << 1) | p1;
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        int index = bits.Read(i == 0 ? 3 : 4);
+        for (int c = 0; c < 4; ++c)
+        {
+            block[i * 4 + c] = static_cast<unsigned char>(
+                ((64 - bc7Weights[index]) * endpoints[0][c] + bc7Weights[index] * endpoints[1][c] + 32) >> 6);
+        }
+    }
+}
+
+void TextureCooker::DecodeBlock(TextureFormat format, const unsigned char* in, unsigned char* block)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1:
+        DecodeBC1Color(in, false, block);
+        break;
+    case TextureFormat::BC3:
+        DecodeBC1Color(in + 8, true, block);
+        DecodeBC3Alpha(in, block);
+        break;
+    case TextureFormat::BC7:
+        DecodeBC7(in, block);
+        break;
+    default:
+        memcpy(block, in, 64);
+        break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Images
+// ---------------------------------------------------------------------------
+
+TextureFormat TextureCooker::ChooseFormat(AlphaMode alphaMode)
+{
+    switch (alphaMode)
+    {
+    case AlphaMode::Opaque: return TextureFormat::BC1;
+    case AlphaMode::Cutout: return TextureFormat::BC3;
+    default: return TextureFormat::BC7;
+    }
+}
+
+size_t TextureCooker::GetBlockSize(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1: return 8;
+    case TextureFormat::BC3:
+    case TextureFormat::BC7: return 16;
+    default: return 0;
+    }
+}
+
+size_t TextureCooker::GetImageSize(TextureFormat format, int width, int height)
+{
+    size_t blockSize = GetBlockSize(format);
+    if (blockSize == 0)
+        return static_cast<size_t>(width) * height * 4;
+
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+}
+
+const char* TextureCooker::GetFormatName(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1: return "BC1";
+    case TextureFormat::BC3: return "BC3";
+    case TextureFormat::BC7: return "BC7";
+    default: return "RGBA8";
+    }
+}
+
+std::vector<unsigned char> TextureCooker::Compress(const TextureMip& mip, TextureFormat format)
+{
+    size_t blockSize = GetBlockSize(format);
+    if (blockSize == 0)
+        return mip.data;
+
+    int blocksX = (mip.width + 3) / 4;
+    int blocksY = (mip.height + 3) / 4;
+    std::vector<unsigned char> output(static_cast<size_t>(blocksX) * blocksY * blockSize);
+
+    auto encodeRows = [&](size_t begin, size_t end)
+    {
+        unsigned char block[64];
+
+        for (size_t by = begin; by < end; ++by)
+        {
+            for (int bx = 0; bx < blocksX; ++bx)
+            {
+                for (int y = 0; y < 4; ++y)
+                {
+                    int sourceY = ClampInt(static_cast<int>(by) * 4 + y, 0, mip.height - 1);
+                    for (int x = 0; x < 4; ++x)
+                    {
+                        int sourceX = ClampInt(bx * 4 + x, 0, mip.width - 1);
+                        memcpy(&block[(y * 4 + x) * 4], &mip.data[(static_cast<size_t>(sourceY) * mip.width + sourceX) * 4], 4);
+                    }
+                }
+
+                unsigned char* out = &output[(by * blocksX + bx) * blockSize];
+                if (format == TextureFormat::BC1)
+                    EncodeBC1Block(block, out);
+                else if (format == TextureFormat::BC3)
+                    EncodeBC3Block(block, out);
+                else
+                    EncodeBC7Block(block, out);
+            }
+        }
+    };
+
+    if (blocksY >= COMPRESS_MIN_BLOCK_ROWS * 2)
+        ThreadPool::GetInstance().ParallelFor(blocksY, encodeRows, COMPRESS_MIN_BLOCK_ROWS);
+    else
+        encodeRows(0, blocksY);
+
+    return output;
+}
+
+std::vector<unsigned char> TextureCooker::Decompress(const unsigned char* data, int width, int height, TextureFormat format)
+{
+    size_t blockSize = GetBlockSize(format);
+    if (blockSize == 0)
+        return std::vector<unsigned char>(data, data + static_cast<size_t>(width) * height * 4);
+
+    std::vector<unsigned char> output(static_cast<size_t>(width) * height * 4);
+    int blocksX = (width + 3) / 4;
+    int blocksY = (height + 3) / 4;
+    unsigned char block[64];
+
+    for (int by = 0; by < blocksY; ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            DecodeBlock(format, data + (static_cast<size_t>(by) * blocksX + bx) * blockSize, block);
+
+            for (int y = 0; y < 4 && by * 4 + y < height; ++y)
+            {
+                for (int x = 0; x < 4 && bx * 4 + x < width; ++x)
+                {
+                    memcpy(&output[(static_cast<size_t>(by * 4 + y) * width + bx * 4 + x) * 4], &block[(y * 4 + x) * 4], 4);
+                }
+            }
+        }
+    }
+
+    return output;
+}
+
+bool TextureCooker::Cook(const unsigned char* rgba, int width, int height, AlphaMode alphaMode, TextureFormat format, CookedTexture& out)
+{
+    if (rgba == nullptr || width <= 0 || height <= 0)
+        return false;
+
+    std::vector<TextureMip> levels;
+    GenerateMips(rgba, width, height, alphaMode == AlphaMode::Cutout, levels);
+
+    out.format = format;
+    out.alphaMode = alphaMode;
+    out.width = width;
+    out.height = height;
+    out.levelCount = static_cast<int>(levels.size());
+    out.baseLevel = 0;
+    out.mips.clear();
+    out.mips.reserve(levels.size());
+
+    for (const TextureMip& level : levels)
+    {
+        TextureMip compressed;
+        compressed.width = level.width;
+        compressed.height = level.height;
+        compressed.data = Compress(level, format);
+        out.mips.push_back(std::move(compressed));
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// DDS files
+// ---------------------------------------------------------------------------
+
+bool TextureCooker::SaveDDS(const std::string& path, const CookedTexture& texture, uint64_t sourceStamp)
+{
+    // Only complete chains
+    if (texture.mips.empty() || texture.baseLevel != 0)
+        return false;
+
+    const TextureMip& base = texture.mips[0];
+
+    uint32_t header[DDS_HEADER_DWORDS] = {};
+    header[DDS_SIZE] = DDS_HEADER_DWORDS * 4;
+    header[DDS_FLAGS] = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+    header[DDS_HEIGHT] = base.height;
+    header[DDS_WIDTH] = base.width;
+    header[DDS_MIPMAP_COUNT] = static_cast<uint32_t>(texture.mips.size());
+
+    header[DDS_COOKED_MAGIC] = COOKED_MAGIC;
+    header[DDS_COOKED_VERSION] = COOKER_VERSION;
+    header[DDS_COOKED_ALPHA_MODE] = static_cast<uint32_t>(texture.alphaMode);
+    header[DDS_COOKED_STAMP_LO] = static_cast<uint32_t>(sourceStamp & 0xFFFFFFFFu);
+    header[DDS_COOKED_STAMP_HI] = static_cast<uint32_t>(sourceStamp >> 32);
+
+    header[DDS_PF_SIZE] = 32;
+    header[DDS_CAPS1] = DDSCAPS_TEXTURE | (texture.mips.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    switch (texture.format)
+    {
+    case TextureFormat::BC1:
+        header[DDS_PF_FLAGS] = DDPF_FOURCC;
+        header[DDS_PF_FOURCC] = FOURCC('D', 'X', 'T', '1');
+        break;
+    case TextureFormat::BC3:
+        header[DDS_PF_FLAGS] = DDPF_FOURCC;
+        header[DDS_PF_FOURCC] = FOURCC('D', 'X', 'T', '5');
+        break;
+    case TextureFormat::BC7:
+        header[DDS_PF_FLAGS] = DDPF_FOURCC;
+        header[DDS_PF_FOURCC] = FOURCC('D', 'X', '1', '0');
+        break;
+    default:
+        header[DDS_PF_FLAGS] = DDPF_RGB | DDPF_ALPHAPIXELS;
+        header[DDS_PF_BIT_COUNT] = 32;
+        header[DDS_PF_RMASK] = 0x000000FF;
+        header[DDS_PF_GMASK] = 0x0000FF00;
+        header[DDS_PF_BMASK] = 0x00FF0000;
+        header[DDS_PF_AMASK] = 0xFF000000;
+        break;
+    }
+
+    if (texture.format == TextureFormat::RGBA8)
+    {
+        header[DDS_FLAGS] |= DDSD_PITCH;
+        header[DDS_PITCH_OR_LINEAR_SIZE] = base.width * 4;
+    }
+    else
+    {
+        header[DDS_FLAGS] |= DDSD_LINEARSIZE;
+        header[DDS_PITCH_OR_LINEAR_SIZE] = static_cast<uint32_t>(GetImageSize(texture.format, base.width, base.height));
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    const uint32_t magic = FOURCC('D', 'D', 'S', ' ');
+    file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    if (texture.format == TextureFormat::BC7)
+    {
+        // DDS_HEADER_DXT10: format, dimension, misc flags, array size, misc flags 2
+        const uint32_t dx10[5] = { DXGI_FORMAT_BC7_UNORM, D3D10_RESOURCE_DIMENSION_TEXTURE2D, 0, 1, 0 };
+        file.write(reinterpret_cast<const char*>(dx10), sizeof(dx10));
+    }
+
+    for (const TextureMip& mip : texture.mips)
+        file.write(reinterpret_cast<const char*>(mip.data.data()), mip.data.size());
+
+    return static_cast<bool>(file);
+}
+
+// Magic, header and the DX10 extension, the most a cooked file has in front of its first mip
+#define DDS_MAX_PREFIX_SIZE (4 + DDS_HEADER_DWORDS * 4 + 20)
+
+// Validates the header at the start of data, dataOffset is where the first mip begins
+static bool ParseDDSHeader(const std::vector<unsigned char>& data, CookedTexture& texture, uint64_t sourceStamp, size_t& dataOffset)
+{
+    uint32_t magic = 0;
+    uint32_t header[DDS_HEADER_DWORDS] = {};
+    if (data.size() < sizeof(magic) + sizeof(header))
+        return false;
+
+    memcpy(&magic, data.data(), sizeof(magic));
+    memcpy(header, data.data() + sizeof(magic), sizeof(header));
+    dataOffset = sizeof(magic) + sizeof(header);
+
+    if (magic != FOURCC('D', 'D', 'S', ' ') || header[DDS_SIZE] != DDS_HEADER_DWORDS * 4)
+        return false;
+
+    // Only files written by this cooker, for this exact source version
+    uint64_t stamp = header[DDS_COOKED_STAMP_LO] | (static_cast<uint64_t>(header[DDS_COOKED_STAMP_HI]) << 32);
+    if (header[DDS_COOKED_MAGIC] != COOKED_MAGIC || header[DDS_COOKED_VERSION] != COOKER_VERSION || stamp != sourceStamp)
+        return false;
+
+    uint32_t fourCC = header[DDS_PF_FOURCC];
+    if (!(header[DDS_PF_FLAGS] & DDPF_FOURCC))
+    {
+        texture.format = TextureFormat::RGBA8;
+    }
+    else if (fourCC == FOURCC('D', 'X', 'T', '1'))
+    {
+        texture.format = TextureFormat::BC1;
+    }
+    else if (fourCC == FOURCC('D', 'X', 'T', '5'))
+    {
+        texture.format = TextureFormat::BC3;
+    }
+    else if (fourCC == FOURCC('D', 'X', '1', '0'))
+    {
+        uint32_t dx10[5] = {};
+        if (data.size() < dataOffset + sizeof(dx10))
+            return false;
+        memcpy(dx10, data.data() + dataOffset, sizeof(dx10));
+        dataOffset += sizeof(dx10);
+
+        if (dx10[0] != DXGI_FORMAT_BC7_UNORM)
+            return false;
+        texture.format = TextureFormat::BC7;
+    }
+    else
+    {
+        return false;
+    }
+
+    texture.width = static_cast<int>(header[DDS_WIDTH]);
+    texture.height = static_cast<int>(header[DDS_HEIGHT]);
+    texture.levelCount = header[DDS_MIPMAP_COUNT] > 0 ? static_cast<int>(header[DDS_MIPMAP_COUNT]) : 1;
+    texture.baseLevel = 0;
+    texture.alphaMode = static_cast<AlphaMode>(header[DDS_COOKED_ALPHA_MODE]);
+    texture.mips.clear();
+
+    return texture.width > 0 && texture.height > 0 && texture.levelCount <= 32;
+}
+
+bool TextureCooker::ReadDDSInfo(const std::string& path, CookedTexture& texture, uint64_t sourceStamp, IOPriority priority)
+{
+    std::vector<unsigned char> prefix;
+    size_t dataOffset = 0;
+    return VirtualFileSystem::GetInstance().ReadRange(path, 0, DDS_MAX_PREFIX_SIZE, prefix, priority) &&
+        ParseDDSHeader(prefix, texture, sourceStamp, dataOffset);
+}
+
+bool TextureCooker::LoadDDS(const std::string& path, CookedTexture& texture, uint64_t sourceStamp, int firstLevel, int lastLevel, IOPriority priority)
+{
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+
+    std::vector<unsigned char> prefix;
+    size_t dataOffset = 0;
+    if (!vfs.ReadRange(path, 0, DDS_MAX_PREFIX_SIZE, prefix, priority) || !ParseDDSHeader(prefix, texture, sourceStamp, dataOffset))
+        return false;
+
+    if (lastLevel < 0 || lastLevel >= texture.levelCount)
+        lastLevel = texture.levelCount - 1;
+    if (firstLevel < 0 || firstLevel > lastLevel)
+        return false;
+
+    // The requested levels are contiguous in the file, one read covers them all
+    uint64_t rangeStart = dataOffset;
+    uint64_t rangeSize = 0;
+    int width = texture.width;
+    int height = texture.height;
+
+    for (int level = 0; level <= lastLevel; ++level)
+    {
+        size_t size = GetImageSize(texture.format, width, height);
+        if (level < firstLevel)
+            rangeStart += size;
+        else
+            rangeSize += size;
+
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    std::vector<unsigned char> levels;
+    if (!vfs.ReadRange(path, rangeStart, rangeSize, levels, priority) || levels.size() != rangeSize)
+        return false;
+
+    texture.baseLevel = firstLevel;
+    texture.mips.reserve(lastLevel - firstLevel + 1);
+
+    width = std::max(texture.width >> firstLevel, 1);
+    height = std::max(texture.height >> firstLevel, 1);
+    size_t offset = 0;
+
+    for (int level = firstLevel; level <= lastLevel; ++level)
+    {
+        size_t size = GetImageSize(texture.format, width, height);
+
+        TextureMip mip;
+        mip.width = width;
+        mip.height = height;
+        mip.data.assign(levels.begin() + offset, levels.begin() + offset + size);
+        texture.mips.push_back(std::move(mip));
+        offset += size;
+
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    return true;
+}
+
+std::string TextureCooker::GetCookedPath(const std::string& sourcePath)
+{
+    return GetCookedPath(sourcePath, AssetDatabase::GetInstance().GetContentHash(sourcePath));
+}
+
+std::string TextureCooker::GetCookedPath(const std::string& sourcePath, uint64_t contentHash)
+{
+    // Library folder next to the executable
+    std::string execDir = VirtualFileSystem::GetExecutableDirectory();
+
+    CreateDirectoryA((execDir + "\\" + LIBRARY_FOLDER).c_str(), NULL);
+    CreateDirectoryA((execDir + "\\" + LIBRARY_TEXTURES_FOLDER).c_str(), NULL);
+
+    // File name plus a hash of the content, or of the full path when the content is not known,
+    // so equally named textures in different folders do not collide
+    uint64_t hash = contentHash;
+    if (hash == 0)
+    {
+        hash = 14695981039346656037ull;
+        for (char c : sourcePath)
+        {
+            char normalized = (c == '\\') ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+            hash ^= static_cast<unsigned char>(normalized);
+            hash *= 1099511628211ull;
+        }
+    }
+
+    size_t nameStart = sourcePath.find_last_of("\\/");
+    std::string name = sourcePath.substr(nameStart == std::string::npos ? 0 : nameStart + 1);
+    size_t extension = name.find_last_of('.');
+    if (extension != std::string::npos)
+        name = name.substr(0, extension);
+
+    char suffix[24];
+    snprintf(suffix, sizeof(suffix), "_%016llx.dds", static_cast<unsigned long long>(hash));
+
+    return execDir + "\\" + LIBRARY_TEXTURES_FOLDER + "\\" + name + suffix;
+}
+
+uint64_t TextureCooker::GetSourceStamp(const std::string& sourcePath)
+{
+    // A touched but unchanged file keeps its cooked copy
+    uint64_t contentHash = AssetDatabase::GetInstance().GetContentHash(sourcePath);
+    return contentHash != 0 ? contentHash : VirtualFileSystem::GetInstance().GetStamp(sourcePath);
+}
+
+uint32_t TextureCooker::GetVersion()
+{
+    return COOKER_VERSION;
+}
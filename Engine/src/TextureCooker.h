@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "VirtualFileSystem.h"
+
+enum class AlphaMode;
+
+// Pixel formats of cooked textures
+enum class TextureFormat
+{
+    RGBA8, // Uncompressed, 32 bpp
+    BC1,   // 4 bpp, RGB (opaque textures)
+    BC3,   // 8 bpp, BC1 color + interpolated alpha (cutout textures, sharp alpha edges)
+    BC7    // 8 bpp, RGBA with shared endpoints (blended textures, smooth alpha)
+};
+
+struct TextureMip
+{
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> data;
+};
+
+struct CookedTexture
+{
+    TextureFormat format = TextureFormat::RGBA8;
+    AlphaMode alphaMode{};
+    int width = 0;      // Level 0 size, even when level 0 is not loaded
+    int height = 0;
+    int levelCount = 0; // Levels in the full chain, down to 1x1
+    int baseLevel = 0;  // Chain level of mips[0]
+    std::vector<TextureMip> mips; // Finest loaded level first
+};
+
+// Offline texture processing: mip chain generation, block compression and the
+// DDS files stored in the Library folder. CPU only (no GL calls, no logging),
+// so it can run on the worker pool and be checked without a window.
+class TextureCooker
+{
+public:
+    static TextureFormat ChooseFormat(AlphaMode alphaMode);
+
+    // Builds every mip level of an RGBA8 image and compresses it to format
+    static bool Cook(const unsigned char* rgba, int width, int height, AlphaMode alphaMode, TextureFormat format, CookedTexture& out);
+
+    // Mip chain down to 1x1. Color is averaged in linear space and weighted by alpha.
+    // preserveCoverage rescales the alpha of every level so alpha testing keeps the same coverage.
+    static void GenerateMips(const unsigned char* rgba, int width, int height, bool preserveCoverage, std::vector<TextureMip>& mips);
+
+    // 4x4 block codecs: block is 16 RGBA8 pixels row by row, encoded blocks are 8 (BC1) or 16 bytes
+    static void EncodeBC1Block(const unsigned char* block, unsigned char* out);
+    static void EncodeBC3Block(const unsigned char* block, unsigned char* out);
+    static void EncodeBC7Block(const unsigned char* block, unsigned char* out); // Mode 6 only
+    static void DecodeBlock(TextureFormat format, const unsigned char* in, unsigned char* block);
+
+    // Whole images (edge blocks repeat the last row/column)
+    static std::vector<unsigned char> Compress(const TextureMip& mip, TextureFormat format);
+    static std::vector<unsigned char> Decompress(const unsigned char* data, int width, int height, TextureFormat format);
+
+    static size_t GetBlockSize(TextureFormat format); // 0 for RGBA8
+    static size_t GetImageSize(TextureFormat format, int width, int height);
+    static const char* GetFormatName(TextureFormat format);
+
+    // DDS container, BC7 uses the DX10 extension header. The source stamp is kept in the
+    // reserved header fields and a file whose stamp differs is treated as stale.
+    static bool SaveDDS(const std::string& path, const CookedTexture& texture, uint64_t sourceStamp);
+    // Loads chain levels firstLevel..lastLevel (-1: down to 1x1), the others are skipped in the file.
+    // Reads go through the VirtualFileSystem with the given priority.
+    static bool LoadDDS(const std::string& path, CookedTexture& texture, uint64_t sourceStamp, int firstLevel = 0, int lastLevel = -1,
+        IOPriority priority = IOPriority::Normal);
+    // Header only: fills everything but the mips
+    static bool ReadDDSInfo(const std::string& path, CookedTexture& texture, uint64_t sourceStamp, IOPriority priority = IOPriority::Normal);
+
+    // Library/Textures file for a source texture. Files the AssetDatabase has hashed are named
+    // after their content, so equal textures at different paths share one cooked file.
+    static std::string GetCookedPath(const std::string& sourcePath);
+    static std::string GetCookedPath(const std::string& sourcePath, uint64_t contentHash);
+    // Changes whenever the source file (content hash if known, else size and modification time) or the cooker version changes
+    static uint64_t GetSourceStamp(const std::string& sourcePath);
+    static uint32_t GetVersion();
+};
@@ -0,0 +1,282 @@
+#include "TextureStreamer.h"
+#include "Texture.h"
+#include "TextureCooker.h"
+#include "ThreadPool.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#define STREAMING_DEFAULT_BUDGET_MB 256
+// Textures start with their levels up to this size resident
+#define STREAMING_INITIAL_SIZE 64
+// Frames without a request before a texture drops back to its initial level
+#define STREAMING_UNUSED_FRAMES 300
+#define STREAMING_MAX_LOADS 4
+// GL texture rebuilds per frame, spreads the upload cost of many finished loads
+#define STREAMING_MAX_UPLOADS_PER_FRAME 2
+
+TextureStreamer& TextureStreamer::GetInstance()
+{
+    static TextureStreamer instance;
+    return instance;
+}
+
+TextureStreamer::TextureStreamer() : budget(static_cast<size_t>(STREAMING_DEFAULT_BUDGET_MB) * 1024 * 1024)
+{
+}
+
+int TextureStreamer::GetInitialLevel(int width, int height, int levelCount)
+{
+    int level = 0;
+    int size = width > height ? width : height;
+
+    while (size > STREAMING_INITIAL_SIZE && level + 1 < levelCount)
+    {
+        size /= 2;
+        ++level;
+    }
+
+    return level;
+}
+
+void TextureStreamer::Register(Texture* texture)
+{
+    if (FindEntry(texture) != nullptr)
+        return;
+
+    Entry entry;
+    entry.texture = texture;
+    entry.initialLevel = GetInitialLevel(texture->GetWidth(), texture->GetHeight(), texture->GetLevelCount());
+    entry.desiredLevel = texture->GetResidentLevel();
+    entry.lastRequestFrame = frame;
+    entries.push_back(entry);
+}
+
+void TextureStreamer::Unregister(Texture* texture)
+{
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+        [texture](const Entry& entry) { return entry.texture == texture; }), entries.end());
+
+    // Their results are dropped, the workers only hold their own copies
+    loads.erase(std::remove_if(loads.begin(), loads.end(),
+        [texture](const PendingLoad& load) { return load.texture == texture; }), loads.end());
+}
+
+void TextureStreamer::RequestScreenSize(Texture* texture, float screenPixels)
+{
+    Entry* entry = FindEntry(texture);
+    if (entry == nullptr)
+        return;
+
+    // One texel per pixel, assuming the texture spans the mesh once
+    int size = texture->GetWidth() > texture->GetHeight() ? texture->GetWidth() : texture->GetHeight();
+    float ratio = size / (screenPixels > 1.0f ? screenPixels : 1.0f);
+    int level = ratio > 1.0f ? static_cast<int>(std::floor(std::log2(ratio))) : 0;
+
+    if (level > entry->initialLevel)
+        level = entry->initialLevel;
+
+    if (!entry->requested || level < entry->requestedLevel)
+        entry->requestedLevel = level;
+
+    entry->requested = true;
+    entry->lastRequestFrame = frame;
+}
+
+void TextureStreamer::Update()
+{
+    ApplyLoads();
+
+    for (Entry& entry : entries)
+    {
+        if (entry.requested)
+            entry.desiredLevel = entry.requestedLevel;
+        else if (frame - entry.lastRequestFrame > STREAMING_UNUSED_FRAMES)
+            entry.desiredLevel = entry.initialLevel;
+
+        entry.requested = false;
+    }
+
+    ApplyBudget();
+
+    for (Entry& entry : entries)
+    {
+        Texture* texture = entry.texture;
+        int residentLevel = texture->GetResidentLevel();
+
+        // Levels are only copied or evicted once the uploader is done with them
+        if (texture->IsUploading())
+            continue;
+
+        if (entry.desiredLevel > residentLevel)
+        {
+            // Evicting only needs the levels already on the GPU
+            if (texture->SetResidentLevels(entry.desiredLevel, nullptr))
+            {
+                ++entry.generation;
+                entry.loading = false;
+            }
+        }
+        else if (entry.desiredLevel < residentLevel && !entry.loading && loads.size() < STREAMING_MAX_LOADS)
+        {
+            std::string path = texture->GetCookedPath();
+            uint64_t stamp = texture->GetSourceStamp();
+            int firstLevel = entry.desiredLevel;
+            int lastLevel = residentLevel - 1;
+
+            PendingLoad load;
+            load.texture = texture;
+            load.generation = entry.generation;
+            load.residentLevel = residentLevel;
+            load.result = ThreadPool::GetInstance().Submit([path, stamp, firstLevel, lastLevel]()
+            {
+                std::shared_ptr<CookedTexture> levels = std::make_shared<CookedTexture>();
+                if (!TextureCooker::LoadDDS(path, *levels, stamp, firstLevel, lastLevel, IOPriority::Background))
+                    return std::shared_ptr<CookedTexture>();
+                return levels;
+            });
+
+            loads.push_back(std::move(load));
+            entry.loading = true;
+        }
+    }
+
+    ++frame;
+}
+
+void TextureStreamer::ApplyLoads()
+{
+    int uploads = 0;
+
+    for (auto it = loads.begin(); it != loads.end();)
+    {
+        if (uploads >= STREAMING_MAX_UPLOADS_PER_FRAME ||
+            it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        std::shared_ptr<CookedTexture> levels = it->result.get();
+        Entry* entry = FindEntry(it->texture);
+
+        // Anything evicted since the load started invalidates it
+        if (entry != nullptr && entry->generation == it->generation)
+        {
+            entry->loading = false;
+
+            Texture* texture = it->texture;
+            if (!levels)
+            {
+                LOG_DEBUG("TextureStreamer: could not read %s, keeping level %d", texture->GetCookedPath().c_str(), texture->GetResidentLevel());
+
+                // Do not retry every frame
+                entry->desiredLevel = texture->GetResidentLevel();
+            }
+            else if (texture->GetResidentLevel() == it->residentLevel)
+            {
+                // Skip levels no longer wanted
+                int firstLevel = std::max(levels->baseLevel, entry->desiredLevel);
+                if (firstLevel < it->residentLevel && texture->SetResidentLevels(firstLevel, levels))
+                    ++uploads;
+            }
+        }
+
+        it = loads.erase(it);
+    }
+}
+
+void TextureStreamer::ApplyBudget()
+{
+    size_t total = 0;
+    for (const Entry& entry : entries)
+        total += entry.texture->GetMemorySizeFrom(entry.desiredLevel);
+
+    if (total <= budget)
+        return;
+
+    // Least recently seen first, the biggest first among equally recent ones
+    std::vector<Entry*> order;
+    order.reserve(entries.size());
+    for (Entry& entry : entries)
+        order.push_back(&entry);
+
+    std::sort(order.begin(), order.end(), [](const Entry* a, const Entry* b)
+    {
+        if (a->lastRequestFrame != b->lastRequestFrame)
+            return a->lastRequestFrame < b->lastRequestFrame;
+        return a->texture->GetMemorySizeFrom(a->desiredLevel) > b->texture->GetMemorySizeFrom(b->desiredLevel);
+    });
+
+    auto dropLevel = [&total](Entry* entry)
+    {
+        size_t before = entry->texture->GetMemorySizeFrom(entry->desiredLevel);
+        ++entry->desiredLevel;
+        total -= before - entry->texture->GetMemorySizeFrom(entry->desiredLevel);
+    };
+
+    // Textures not drawn this frame go straight back to their initial level
+    for (Entry* entry : order)
+    {
+        if (entry->lastRequestFrame == frame)
+            continue;
+
+        while (total > budget && entry->desiredLevel < entry->initialLevel)
+            dropLevel(entry);
+    }
+
+    // Visible ones lose one level at a time in turn
+    bool dropped = true;
+    while (total > budget && dropped)
+    {
+        dropped = false;
+
+        for (Entry* entry : order)
+        {
+            if (total <= budget)
+                break;
+
+            if (entry->desiredLevel < entry->initialLevel)
+            {
+                dropLevel(entry);
+                dropped = true;
+            }
+        }
+    }
+}
+
+void TextureStreamer::Clear()
+{
+    entries.clear();
+    loads.clear();
+}
+
+size_t TextureStreamer::GetResidentBytes() const
+{
+    size_t total = 0;
+    for (const Entry& entry : entries)
+        total += entry.texture->GetMemorySize();
+    return total;
+}
+
+std::vector<TextureStreamer::TextureInfo> TextureStreamer::GetTextureInfo() const
+{
+    std::vector<TextureInfo> info;
+    info.reserve(entries.size());
+
+    for (const Entry& entry : entries)
+        info.push_back({ entry.texture, entry.texture->GetResidentLevel(), entry.desiredLevel, entry.loading });
+
+    return info;
+}
+
+TextureStreamer::Entry* TextureStreamer::FindEntry(Texture* texture)
+{
+    for (Entry& entry : entries)
+    {
+        if (entry.texture == texture)
+            return &entry;
+    }
+    return nullptr;
+}
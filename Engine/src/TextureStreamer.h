@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <future>
+#include <cstddef>
+
+class Texture;
+struct CookedTexture;
+
+// Keeps on the GPU only the mip levels the view needs. Cooked textures start with
+// just their small mips resident; the renderer reports how big every textured mesh
+// is on screen, and finer levels are read from the Library files on the worker pool.
+// Textures that go unseen, or the least recently seen ones when the VRAM budget is
+// exceeded, fall back to coarser levels.
+class TextureStreamer
+{
+public:
+    // One registered texture, for the editor
+    struct TextureInfo
+    {
+        const Texture* texture;
+        int residentLevel;
+        int desiredLevel;
+        bool loading;
+    };
+
+    static TextureStreamer& GetInstance();
+
+    // Only affects textures loaded afterwards
+    bool IsEnabled() const { return enabled; }
+    void SetEnabled(bool value) { enabled = value; }
+
+    size_t GetBudget() const { return budget; }
+    void SetBudget(size_t bytes) { budget = bytes; }
+
+    // Finest level loaded up front, and the coarsest a texture is ever dropped to
+    static int GetInitialLevel(int width, int height, int levelCount);
+
+    void Register(Texture* texture);
+    void Unregister(Texture* texture);
+
+    // The texture is drawn screenPixels pixels wide this frame (projected diameter of the mesh)
+    void RequestScreenSize(Texture* texture, float screenPixels);
+
+    // Once per frame after drawing: uploads finished loads, updates the desired levels
+    // from this frame's requests, evicts and starts new loads
+    void Update();
+
+    // Forgets every texture and pending load
+    void Clear();
+
+    size_t GetResidentBytes() const;
+    unsigned int GetLoadsInFlight() const { return static_cast<unsigned int>(loads.size()); }
+    std::vector<TextureInfo> GetTextureInfo() const;
+
+private:
+    TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    struct Entry
+    {
+        Texture* texture = nullptr;
+        int initialLevel = 0;
+        int desiredLevel = 0;
+        int requestedLevel = 0;          // Finest level asked for this frame
+        unsigned int lastRequestFrame = 0;
+        unsigned int generation = 0;     // Bumped on eviction, older loads are then ignored
+        bool requested = false;
+        bool loading = false;
+    };
+
+    // Levels being read on a worker
+    struct PendingLoad
+    {
+        Texture* texture;
+        unsigned int generation;
+        int residentLevel; // Resident level when the load started, the new levels end right above it
+        std::future<std::shared_ptr<CookedTexture>> result;
+    };
+
+    Entry* FindEntry(Texture* texture);
+    void ApplyLoads();
+    void ApplyBudget();
+
+    bool enabled = true;
+    size_t budget;
+    unsigned int frame = 1;
+
+    std::vector<Entry> entries;
+    std::vector<PendingLoad> loads;
+};
@@ -0,0 +1,191 @@
+#include "TextureUploader.h"
+#include "Texture.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#define UPLOADER_BUFFER_COUNT 4
+#define UPLOADER_BUFFER_SIZE (4 * 1024 * 1024)
+// Time spent copying and submitting rows per frame, at least one buffer is always submitted
+#define UPLOADER_FRAME_BUDGET_MS 2.0f
+
+TextureUploader& TextureUploader::GetInstance()
+{
+    static TextureUploader instance;
+    return instance;
+}
+
+void TextureUploader::Queue(Texture* texture, GLuint textureID, GLint mipLevel, int chainLevel, int width, int height,
+    TextureFormat format, GLenum internalFormat, std::shared_ptr<const void> owner, const unsigned char* data, size_t size)
+{
+    Job job;
+    job.texture = texture;
+    job.textureID = textureID;
+    job.mipLevel = mipLevel;
+    job.chainLevel = chainLevel;
+    job.width = width;
+    job.height = height;
+    job.format = format;
+    job.internalFormat = internalFormat;
+    job.owner = std::move(owner);
+    job.data = data;
+    job.size = size;
+    jobs.push_back(std::move(job));
+
+    // Created here rather than in Update, which may run while the main thread logs
+    if (buffers.empty())
+        CreateBuffers();
+
+    UpdatePendingCounters();
+}
+
+void TextureUploader::Cancel(Texture* texture)
+{
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+        [texture](const Job& job) { return job.texture == texture; }), jobs.end());
+
+    UpdatePendingCounters();
+}
+
+void TextureUploader::Update()
+{
+    if (jobs.empty() || buffers.empty())
+        return;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool submitted = false;
+
+    while (!jobs.empty())
+    {
+        if (submitted && std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count() > UPLOADER_FRAME_BUDGET_MS)
+            break;
+
+        // The driver may still be reading the buffer from a previous submit
+        StagingBuffer& staging = buffers[nextBuffer];
+        if (staging.fence != nullptr)
+        {
+            if (glClientWaitSync(staging.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+                break;
+
+            glDeleteSync(staging.fence);
+            staging.fence = nullptr;
+        }
+
+        Job& job = jobs.front();
+        SubmitRows(job, staging);
+        submitted = true;
+        nextBuffer = (nextBuffer + 1) % buffers.size();
+
+        if (job.nextRow >= job.height)
+        {
+            Texture* texture = job.texture;
+            int chainLevel = job.chainLevel;
+            jobs.pop_front();
+
+            // Later draws already see the level, commands reach the GPU in order
+            texture->OnLevelUploaded(chainLevel);
+        }
+    }
+
+    UpdatePendingCounters();
+}
+
+void TextureUploader::SubmitRows(Job& job, StagingBuffer& staging)
+{
+    // Block compressed levels go in whole 4 pixel rows of blocks
+    int rowAlign = job.format == TextureFormat::RGBA8 ? 1 : 4;
+    size_t rowBytes = TextureCooker::GetImageSize(job.format, job.width, rowAlign);
+
+    int maxRows = static_cast<int>(UPLOADER_BUFFER_SIZE / rowBytes) * rowAlign;
+    int rows = std::min(job.height - job.nextRow, std::max(maxRows, rowAlign));
+
+    size_t offset = static_cast<size_t>(job.nextRow / rowAlign) * rowBytes;
+    size_t bytes = std::min(static_cast<size_t>((rows + rowAlign - 1) / rowAlign) * rowBytes, job.size - offset);
+
+    std::memcpy(staging.mapped, job.data + offset, bytes);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+    glBindTexture(GL_TEXTURE_2D, job.textureID);
+
+    // With a buffer bound, the data pointer is an offset into it
+    if (job.format == TextureFormat::RGBA8)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexSubImage2D(GL_TEXTURE_2D, job.mipLevel, 0, job.nextRow, job.width, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    else
+    {
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, job.mipLevel, 0, job.nextRow, job.width, rows,
+            job.internalFormat, static_cast<GLsizei>(bytes), nullptr);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    staging.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    job.nextRow += rows;
+}
+
+bool TextureUploader::CreateBuffers()
+{
+    // Persistent coherent mapping (GL 4.4): written directly, never unmapped
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    for (int i = 0; i < UPLOADER_BUFFER_COUNT; ++i)
+    {
+        StagingBuffer staging;
+        glGenBuffers(1, &staging.buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, UPLOADER_BUFFER_SIZE, nullptr, flags);
+        staging.mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, UPLOADER_BUFFER_SIZE, flags));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (staging.mapped == nullptr)
+        {
+            LOG_DEBUG("ERROR: TextureUploader could not map a pixel unpack buffer");
+            glDeleteBuffers(1, &staging.buffer);
+            Release();
+            return false;
+        }
+
+        buffers.push_back(staging);
+    }
+
+    LOG_DEBUG("TextureUploader: %d pixel unpack buffers of %d KB", UPLOADER_BUFFER_COUNT, UPLOADER_BUFFER_SIZE / 1024);
+    return true;
+}
+
+void TextureUploader::Release()
+{
+    jobs.clear();
+
+    for (StagingBuffer& staging : buffers)
+    {
+        if (staging.fence != nullptr)
+            glDeleteSync(staging.fence);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &staging.buffer);
+    }
+
+    buffers.clear();
+    nextBuffer = 0;
+
+    UpdatePendingCounters();
+}
+
+void TextureUploader::UpdatePendingCounters()
+{
+    size_t total = 0;
+    for (const Job& job : jobs)
+    {
+        int rowAlign = job.format == TextureFormat::RGBA8 ? 1 : 4;
+        total += job.size - static_cast<size_t>(job.nextRow / rowAlign) * TextureCooker::GetImageSize(job.format, job.width, rowAlign);
+    }
+
+    pendingLevels = static_cast<unsigned int>(jobs.size());
+    pendingBytes = total;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include "TextureCooker.h"
+
+class Texture;
+
+// Uploads large texture levels from a pool of persistently mapped pixel unpack buffers.
+// Each frame as many rows as fit in the time budget are copied into free buffers and
+// handed to the driver, which reads them asynchronously; a fence per buffer tells when
+// it can be reused. Levels are uploaded in the order they were queued.
+// Everything but the pending counters belongs to the GL thread.
+class TextureUploader
+{
+public:
+    static TextureUploader& GetInstance();
+
+    // Queues level 'mipLevel' of the texture object 'textureID'. 'owner' keeps 'data' alive until it is copied.
+    // Texture::OnLevelUploaded(chainLevel) is called once all of its rows are submitted.
+    void Queue(Texture* texture, GLuint textureID, GLint mipLevel, int chainLevel, int width, int height,
+        TextureFormat format, GLenum internalFormat, std::shared_ptr<const void> owner, const unsigned char* data, size_t size);
+
+    // Drops every queued level of the texture (rebuilt or destroyed)
+    void Cancel(Texture* texture);
+
+    // Once per frame before drawing
+    void Update();
+
+    // Deletes the buffers, GL thread before the context goes away
+    void Release();
+
+    // Any thread
+    unsigned int GetPendingLevels() const { return pendingLevels.load(); }
+    size_t GetPendingBytes() const { return pendingBytes.load(); }
+
+private:
+    TextureUploader() = default;
+
+    TextureUploader(const TextureUploader&) = delete;
+    TextureUploader& operator=(const TextureUploader&) = delete;
+
+    struct Job
+    {
+        Texture* texture;
+        GLuint textureID;
+        GLint mipLevel; // Level of the GL texture, chainLevel minus the texture's first loaded level
+        int chainLevel;
+        int width;
+        int height;
+        TextureFormat format;
+        GLenum internalFormat;
+        std::shared_ptr<const void> owner;
+        const unsigned char* data;
+        size_t size;
+        int nextRow = 0; // First pixel row not submitted yet
+    };
+
+    struct StagingBuffer
+    {
+        GLuint buffer = 0;
+        unsigned char* mapped = nullptr;
+        GLsync fence = nullptr;
+    };
+
+    bool CreateBuffers();
+    // Copies the next rows of the job that fit in the buffer and submits them
+    void SubmitRows(Job& job, StagingBuffer& staging);
+    void UpdatePendingCounters();
+
+    std::deque<Job> jobs;
+    std::vector<StagingBuffer> buffers;
+    size_t nextBuffer = 0;
+
+    std::atomic<unsigned int> pendingLevels{ 0 };
+    std::atomic<size_t> pendingBytes{ 0 };
+};
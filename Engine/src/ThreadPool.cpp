@@ -0,0 +1,140 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <algorithm>
+
+ThreadPool& ThreadPool::GetInstance()
+{
+    static ThreadPool instance;
+    return instance;
+}
+
+ThreadPool::ThreadPool()
+{
+    // Leave one core for the main thread
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    unsigned int workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+
+    workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    Shutdown();
+}
+
+void ThreadPool::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping) return;
+        stopping = true;
+    }
+
+    condition.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+    workers.clear();
+}
+
+void ThreadPool::Enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        if (!stopping)
+        {
+            jobs.push(std::move(job));
+            condition.notify_one();
+            return;
+        }
+    }
+
+    // After shutdown there is nobody to run it, so run it inline
+    job();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            condition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+            if (jobs.empty())
+                return;
+
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+
+        job();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& body, size_t minChunk)
+{
+    if (count == 0) return;
+
+    minChunk = std::max<size_t>(minChunk, 1);
+
+    // Aim for a few chunks per thread so uneven items still balance out
+    size_t threadCount = workers.size() + 1;
+    size_t chunkSize = std::max(minChunk, count / (threadCount * 4));
+    size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    if (chunkCount == 1 || workers.empty())
+    {
+        body(0, count);
+        return;
+    }
+
+    // Shared with helper tasks that may start after this call already returned
+    struct ForState
+    {
+        std::atomic<size_t> nextChunk{ 0 };
+        std::atomic<size_t> doneChunks{ 0 };
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+    };
+    auto state = std::make_shared<ForState>();
+    const std::function<void(size_t, size_t)>* bodyPtr = &body;
+
+    auto runChunks = [state, bodyPtr, count, chunkSize, chunkCount]()
+    {
+        size_t chunk;
+        while ((chunk = state->nextChunk.fetch_add(1)) < chunkCount)
+        {
+            size_t begin = chunk * chunkSize;
+            size_t end = std::min(begin + chunkSize, count);
+            (*bodyPtr)(begin, end);
+
+            if (state->doneChunks.fetch_add(1) + 1 == chunkCount)
+            {
+                std::lock_guard<std::mutex> lock(state->doneMutex);
+                state->doneCondition.notify_all();
+            }
+        }
+    };
+
+    size_t helperCount = std::min(workers.size(), chunkCount - 1);
+    for (size_t i = 0; i < helperCount; ++i)
+    {
+        Enqueue(runChunks);
+    }
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(state->doneMutex);
+    state->doneCondition.wait(lock, [&]() { return state->doneChunks.load() == chunkCount; });
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+// Fixed set of worker threads shared by the loaders.
+// Tasks must not touch OpenGL (render thread), their console lines show up a frame later.
+class ThreadPool
+{
+public:
+    static ThreadPool& GetInstance();
+
+    // Queue a task and get a future for its result
+    template<typename F>
+    auto Submit(F&& task) -> std::future<decltype(task())>
+    {
+        using ResultType = decltype(task());
+
+        auto packaged = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(task));
+        std::future<ResultType> result = packaged->get_future();
+
+        Enqueue([packaged]() { (*packaged)(); });
+
+        return result;
+    }
+
+    // Runs body over [0, count) split in chunks of at least minChunk items.
+    // The calling thread works too, so it is safe to call from inside a task.
+    void ParallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& body, size_t minChunk = 1);
+
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+    // Stops and joins the workers (pending tasks are still executed)
+    void Shutdown();
+
+private:
+    ThreadPool();
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Enqueue(std::function<void()> job);
+    void WorkerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> jobs;
+    std::mutex queueMutex;
+    std::condition_variable condition;
+    bool stopping = false;
+};
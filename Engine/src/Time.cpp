@@ -1,7 +1,19 @@
 #include "Time.h"
+#include "Application.h"
 #include <SDL3/SDL.h>
+#include <algorithm>
 
-Time::Time() : Module(), deltaTime(0.0f), totalTime(0.0f), lastFrame(0.0f)
+// Simulation rate, independent of the rendered frame rate
+#define FIXED_TIMESTEP (1.0f / 60.0f)
+// Steps run at most per frame, time beyond that is dropped so a slow frame cannot snowball
+#define MAX_FIXED_STEPS 5
+// A longer frame (breakpoint, window drag) counts as this long
+#define MAX_FRAME_TIME 0.25
+#define DEFAULT_FRAME_RATE_CAP 0
+#define DEFAULT_IDLE_FRAME_RATE_CAP 15
+
+Time::Time() : Module(), deltaTime(0.0f), totalTime(0.0f), fixedDeltaTime(FIXED_TIMESTEP),
+	frameRateCap(DEFAULT_FRAME_RATE_CAP), idleFrameRateCap(DEFAULT_IDLE_FRAME_RATE_CAP)
 {
 }
 
@@ -11,15 +23,64 @@ Time::~Time()
 
 bool Time::Start()
 {
-	lastFrame = SDL_GetTicks() / 1000.0f;
+	startCounter = SDL_GetPerformanceCounter();
+	counterPeriod = 1.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+	frameStart = 0.0;
 	return true;
 }
 
+double Time::Now() const
+{
+	return static_cast<double>(SDL_GetPerformanceCounter() - startCounter) * counterPeriod;
+}
+
 bool Time::PreUpdate()
 {
-	float currentFrame = SDL_GetTicks() / 1000.0f;
-	deltaTime = currentFrame - lastFrame;
-	totalTime = currentFrame;
-	lastFrame = currentFrame;
+	double currentFrame = Now();
+	double frameTime = std::min(currentFrame - frameStart, MAX_FRAME_TIME);
+
+	deltaTime = static_cast<float>(frameTime);
+	totalTime = static_cast<float>(currentFrame);
+	frameStart = currentFrame;
+	frameCount++;
+
+	// Catch up in whole steps, up to MAX_FIXED_STEPS
+	accumulator = std::min(accumulator + frameTime, static_cast<double>(fixedDeltaTime) * MAX_FIXED_STEPS);
+	fixedStepsThisFrame = static_cast<int>(accumulator / fixedDeltaTime);
+	interpolationAlpha = static_cast<float>((accumulator - fixedStepsThisFrame * static_cast<double>(fixedDeltaTime)) / fixedDeltaTime);
+
 	return true;
+}
+
+void Time::BeginFixedStep()
+{
+	accumulator -= fixedDeltaTime;
+	fixedStepCount++;
+	inFixedStep = true;
+}
+
+void Time::SkipFrame()
+{
+	frameStart = Now();
+}
+
+void Time::WaitForNextFrame()
+{
+	double workEnd = Now();
+	frameWorkMs = static_cast<float>((workEnd - frameStart) * 1000.0);
+
+	SDL_Window* window = Application::GetInstance().window->GetWindow();
+	SDL_WindowFlags flags = window != nullptr ? SDL_GetWindowFlags(window) : 0;
+	idle = (flags & SDL_WINDOW_MINIMIZED) || !(flags & SDL_WINDOW_INPUT_FOCUS);
+
+	int cap = idle && idleFrameRateCap > 0 ? idleFrameRateCap : frameRateCap;
+	if (cap <= 0)
+		return;
+
+	// SDL sleeps most of it and spins the last bit, so the pacing stays even
+	double remaining = 1.0 / cap - (workEnd - frameStart);
+	if (remaining > 0.0)
+	{
+		SDL_DelayPrecise(static_cast<Uint64>(remaining * 1e9));
+	}
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 #include "Module.h"
+#include <cstdint>
 
+// Frame timing from the high resolution counter. The simulation advances in fixed steps:
+// frame time is accumulated and consumed one FixedUpdate at a time, and rendering
+// interpolates transforms between the last two steps.
 class Time : public Module
 {
 public:
@@ -12,9 +16,56 @@ public:
 
 	float GetDeltaTime() const { return deltaTime; }
 	float GetTotalTime() const { return totalTime; }
+	uint64_t GetFrameCount() const { return frameCount; }
+
+	// Fixed step phase, driven by Application after PreUpdate
+	float GetFixedDeltaTime() const { return fixedDeltaTime; }
+	int GetFixedStepsThisFrame() const { return fixedStepsThisFrame; }
+	void BeginFixedStep();
+	void EndFixedStep() { inFixedStep = false; }
+	bool IsInFixedStep() const { return inFixedStep; }
+	uint64_t GetFixedStepCount() const { return fixedStepCount; }
+	// Fraction of a step accumulated since the last one, 0..1
+	float GetInterpolationAlpha() const { return interpolationAlpha; }
+
+	bool IsInterpolationEnabled() const { return interpolationEnabled; }
+	void SetInterpolationEnabled(bool enabled) { interpolationEnabled = enabled; }
+
+	// 0 disables the cap. The idle cap applies while the window is minimized or unfocused.
+	int GetFrameRateCap() const { return frameRateCap; }
+	void SetFrameRateCap(int fps) { frameRateCap = fps; }
+	int GetIdleFrameRateCap() const { return idleFrameRateCap; }
+	void SetIdleFrameRateCap(int fps) { idleFrameRateCap = fps; }
+
+	// Sleeps what is left of the frame budget, called at the end of each loop iteration
+	void WaitForNextFrame();
+	// Time the last frame spent working, without the wait
+	float GetFrameWorkMs() const { return frameWorkMs; }
+	bool IsIdle() const { return idle; }
+	// Iteration that did not draw, the idle time is not simulated afterwards
+	void SkipFrame();
 
 private:
+	double Now() const;
+
 	float deltaTime;
 	float totalTime;
-	float lastFrame;
+
+	uint64_t startCounter = 0;
+	double counterPeriod = 0.0;  // Seconds per counter tick
+	double frameStart = 0.0;
+	uint64_t frameCount = 0;
+
+	float fixedDeltaTime;
+	double accumulator = 0.0;
+	int fixedStepsThisFrame = 0;
+	uint64_t fixedStepCount = 0;
+	bool inFixedStep = false;
+	float interpolationAlpha = 0.0f;
+	bool interpolationEnabled = true;
+
+	int frameRateCap;
+	int idleFrameRateCap;
+	float frameWorkMs = 0.0f;
+	bool idle = false;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Transform.h"
 #include "GameObject.h"
+#include "Application.h"
+#include "RedrawScheduler.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/euler_angles.hpp>
@@ -27,14 +29,27 @@ void Transform::OnEditor()
 
 }
 
+void Transform::SavePreviousState()
+{
+    // Only changes made by the simulation are interpolated, editor edits show up at once
+    Time* time = Application::GetInstance().time.get();
+    if (time == nullptr || !time->IsInFixedStep() || movedStep == time->GetFixedStepCount())
+        return;
+
+    previousPosition = position;
+    previousRotation = rotationQuat;
+    previousScale = scale;
+    movedStep = time->GetFixedStepCount();
+}
+
 void Transform::SetPosition(const glm::vec3& pos)
 {
     if (position != pos)
     {
+        SavePreviousState();
         position = pos;
         localDirty = true;
-        globalDirty = true;
-        MarkChildrenGlobalDirty();
+        MarkGlobalDirty();
     }
 }
 
@@ -42,11 +57,11 @@ void Transform::SetRotation(const glm::vec3& rot)
 {
     if (rotation != rot)
     {
+        SavePreviousState();
         rotation = rot;
         UpdateQuaternionFromEuler();
         localDirty = true;
-        globalDirty = true;
-        MarkChildrenGlobalDirty();
+        MarkGlobalDirty();
     }
 }
 
@@ -54,11 +69,11 @@ void Transform::SetRotationQuat(const glm::quat& quat)
 {
     if (rotationQuat != quat)
     {
+        SavePreviousState();
         rotationQuat = quat;
         UpdateEulerFromQuaternion();
         localDirty = true;
-        globalDirty = true;
-        MarkChildrenGlobalDirty();
+        MarkGlobalDirty();
     }
 }
 
@@ -66,10 +81,10 @@ void Transform::SetScale(const glm::vec3& scl)
 {
     if (scale != scl)
     {
+        SavePreviousState();
         scale = scl;
         localDirty = true;
-        globalDirty = true;
-        MarkChildrenGlobalDirty();
+        MarkGlobalDirty();
     }
 }
 
@@ -91,6 +106,40 @@ const glm::mat4& Transform::GetGlobalMatrix()
     return globalMatrix;
 }
 
+const glm::mat4& Transform::GetRenderMatrix()
+{
+    Time* time = Application::GetInstance().time.get();
+    if (time == nullptr || !time->IsInterpolationEnabled())
+        return GetGlobalMatrix();
+
+    if (renderFrame == time->GetFrameCount())
+        return renderInterpolated ? renderMatrix : GetGlobalMatrix();
+    renderFrame = time->GetFrameCount();
+
+    GameObject* parent = owner->GetParent();
+    Transform* parentTransform = parent != nullptr ? static_cast<Transform*>(parent->GetComponent(ComponentType::TRANSFORM)) : nullptr;
+
+    const glm::mat4* parentMatrix = parentTransform != nullptr ? &parentTransform->GetRenderMatrix() : nullptr;
+    bool parentInterpolated = parentTransform != nullptr && parentTransform->renderInterpolated;
+    bool moved = movedStep != 0 && movedStep == time->GetFixedStepCount();
+
+    renderInterpolated = moved || parentInterpolated;
+    if (!renderInterpolated)
+        return GetGlobalMatrix();
+
+    glm::mat4 local = GetLocalMatrix();
+    if (moved)
+    {
+        float alpha = time->GetInterpolationAlpha();
+        local = glm::translate(glm::mat4(1.0f), glm::mix(previousPosition, position, alpha)) *
+            glm::mat4_cast(glm::slerp(previousRotation, rotationQuat, alpha)) *
+            glm::scale(glm::mat4(1.0f), glm::mix(previousScale, scale, alpha));
+    }
+
+    renderMatrix = parentMatrix != nullptr ? *parentMatrix * local : local;
+    return renderMatrix;
+}
+
 void Transform::UpdateLocalMatrix()
 {
     glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position);
@@ -131,6 +180,21 @@ void Transform::UpdateGlobalMatrix()
     globalDirty = false;
 }
 
+void Transform::MarkGlobalDirty()
+{
+    globalDirty = true;
+    RedrawScheduler::GetInstance().RequestRedraw(RedrawReason::Transform);
+
+    // The scene re-indexes the world bounds lazily, before its next spatial query
+    ModuleScene* scene = Application::GetInstance().scene.get();
+    if (scene != nullptr)
+    {
+        scene->MarkSpatialDirty(owner);
+    }
+
+    MarkChildrenGlobalDirty();
+}
+
 void Transform::MarkChildrenGlobalDirty()
 {
     const std::vector<GameObject*>& children = owner->GetChildren();
@@ -141,8 +205,7 @@ void Transform::MarkChildrenGlobalDirty()
 
         if (childTransform != nullptr)
         {
-            childTransform->globalDirty = true;
-            childTransform->MarkChildrenGlobalDirty();
+            childTransform->MarkGlobalDirty();
         }
     }
 }
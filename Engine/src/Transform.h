@@ -5,6 +5,7 @@
 #include "Component.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <cstdint>
 
 class Transform : public Component {
 public:
@@ -27,9 +28,16 @@ public:
     const glm::mat4& GetLocalMatrix();
     const glm::mat4& GetGlobalMatrix();
 
+    // Matrix to draw with. Transforms moved during the last fixed step (or under a parent
+    // that was) are drawn between their previous and current state, by Time's interpolation alpha.
+    const glm::mat4& GetRenderMatrix();
+
     void UpdateLocalMatrix();
     void UpdateGlobalMatrix();
 
+    // Global matrix of this transform and its children is stale (moved or reparented)
+    void MarkGlobalDirty();
+
 private:
     // Transforms
     glm::vec3 position;
@@ -45,6 +53,20 @@ private:
     bool localDirty = true;
     bool globalDirty = true;
 
+    // State before the first change of the latest fixed step that moved this transform
+    glm::vec3 previousPosition = glm::vec3(0.0f);
+    glm::quat previousRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 previousScale = glm::vec3(1.0f);
+    uint64_t movedStep = 0;
+
+    // Cached once per frame
+    glm::mat4 renderMatrix = glm::mat4(1.0f);
+    uint64_t renderFrame = 0;
+    bool renderInterpolated = false;
+
+    // Called by the setters before they change anything
+    void SavePreviousState();
+
     void UpdateQuaternionFromEuler();
     void UpdateEulerFromQuaternion();
 
@@ -0,0 +1,627 @@
+#include "VirtualFileSystem.h"
+#include "Log.h"
+#include <windows.h>
+#include <sys/stat.h>
+#include <lz4.h>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include <cctype>
+
+#define VFS_IO_THREADS 2
+
+#define PACK_MAGIC 0x4B415057 // "WPAK"
+#define PACK_VERSION 1
+// Raw entries start on a page boundary so a view of the entry alone is possible
+#define PACK_RAW_ALIGNMENT 4096
+// Compressed size below which an entry is stored compressed, relative to its size
+#define PACK_COMPRESS_RATIO 0.9
+
+#define PACK_ENTRY_RAW 0
+#define PACK_ENTRY_LZ4 1
+
+struct PackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t stringBytes;
+    uint64_t tocOffset;     // Entries, then the names
+};
+
+struct PackEntry
+{
+    uint64_t dataOffset;
+    uint64_t storedSize;
+    uint64_t size;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t compression;
+    uint32_t reserved;
+};
+
+// A mounted pack, mapped read-only as a whole for as long as anyone references it
+struct VirtualFileSystem::Pack
+{
+    std::string path;
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    const unsigned char* view = nullptr;
+    uint64_t size = 0;
+    uint64_t stamp = 0;
+    std::vector<PackEntry> entries;
+    std::unordered_map<std::string, uint32_t> lookup;
+
+    ~Pack()
+    {
+        if (view != nullptr) UnmapViewOfFile(view);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    }
+};
+
+// Lower case with forward slashes, Windows paths are case insensitive
+static std::string NormalizeVirtualPath(const std::string& path)
+{
+    std::string normalized = path;
+    for (char& c : normalized)
+        c = (c == '\\') ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+
+    while (normalized.compare(0, 2, "./") == 0)
+        normalized.erase(0, 2);
+    while (!normalized.empty() && normalized.back() == '/')
+        normalized.pop_back();
+
+    return normalized;
+}
+
+static uint64_t GetDiskStamp(const std::string& path)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return 0;
+
+    uint64_t stamp = static_cast<uint64_t>(info.st_mtime);
+    stamp = stamp * 1099511628211ull ^ static_cast<uint64_t>(info.st_size);
+    return stamp;
+}
+
+static bool IsDirectory(const std::string& path)
+{
+    DWORD attribs = GetFileAttributesA(path.c_str());
+    return attribs != INVALID_FILE_ATTRIBUTES && (attribs & FILE_ATTRIBUTE_DIRECTORY);
+}
+
+static bool IsFile(const std::string& path)
+{
+    DWORD attribs = GetFileAttributesA(path.c_str());
+    return attribs != INVALID_FILE_ATTRIBUTES && !(attribs & FILE_ATTRIBUTE_DIRECTORY);
+}
+
+// Relative paths of every file below directory, '/' separated
+static void CollectFiles(const std::string& directory, const std::string& relative, std::vector<std::string>& files)
+{
+    WIN32_FIND_DATAA findData;
+    std::string pattern = directory + "\\" + (relative.empty() ? "" : relative + "\\") + "*";
+    HANDLE find = FindFirstFileA(pattern.c_str(), &findData);
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+
+    do
+    {
+        std::string name = findData.cFileName;
+        if (name == "." || name == "..")
+            continue;
+
+        std::string child = relative.empty() ? name : relative + "/" + name;
+        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            CollectFiles(directory, child, files);
+        else
+            files.push_back(child);
+    } while (FindNextFileA(find, &findData));
+
+    FindClose(find);
+}
+
+static void WritePadding(std::ofstream& file, uint64_t& offset, uint64_t alignment)
+{
+    static const char zeros[PACK_RAW_ALIGNMENT] = {};
+    uint64_t padding = (alignment - offset % alignment) % alignment;
+    file.write(zeros, static_cast<std::streamsize>(padding));
+    offset += padding;
+}
+
+VirtualFileSystem& VirtualFileSystem::GetInstance()
+{
+    static VirtualFileSystem instance;
+    return instance;
+}
+
+VirtualFileSystem::VirtualFileSystem()
+{
+    ioThreads.reserve(VFS_IO_THREADS);
+    for (int i = 0; i < VFS_IO_THREADS; ++i)
+    {
+        ioThreads.emplace_back(&VirtualFileSystem::IOLoop, this);
+    }
+}
+
+VirtualFileSystem::~VirtualFileSystem()
+{
+    Shutdown();
+}
+
+void VirtualFileSystem::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping) return;
+        stopping = true;
+    }
+
+    condition.notify_all();
+
+    for (std::thread& thread : ioThreads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+    ioThreads.clear();
+}
+
+std::string VirtualFileSystem::GetExecutableDirectory()
+{
+    char buffer[MAX_PATH];
+    GetModuleFileNameA(NULL, buffer, MAX_PATH);
+    std::string execPath(buffer);
+    return execPath.substr(0, execPath.find_last_of("\\/"));
+}
+
+std::string VirtualFileSystem::FindDirectoryUpwards(const std::string& startDirectory, const std::string& name, int maxLevels)
+{
+    std::string searchDir = startDirectory;
+
+    for (int i = 0; i < maxLevels; i++)
+    {
+        std::string testPath = searchDir + "\\" + name;
+        if (IsDirectory(testPath))
+            return testPath;
+
+        // Move up a level
+        size_t pos = searchDir.find_last_of("\\/");
+        if (pos == std::string::npos)
+            break;
+        searchDir = searchDir.substr(0, pos);
+    }
+
+    return std::string();
+}
+
+void VirtualFileSystem::ListFiles(const std::string& directory, std::vector<std::string>& files)
+{
+    files.clear();
+    CollectFiles(directory, "", files);
+}
+
+bool VirtualFileSystem::MountDirectory(const std::string& directory, const std::string& mountPoint)
+{
+    if (!IsDirectory(directory))
+    {
+        LOG_DEBUG("VFS: cannot mount %s, not a directory", directory.c_str());
+        return false;
+    }
+
+    Mount mount;
+    mount.mountPoint = NormalizeVirtualPath(mountPoint);
+    mount.directory = directory;
+
+    std::lock_guard<std::mutex> lock(mountMutex);
+    mounts.push_back(mount);
+
+    LOG_DEBUG("VFS: mounted %s as '%s'", directory.c_str(), mount.mountPoint.c_str());
+    return true;
+}
+
+bool VirtualFileSystem::MountPack(const std::string& packPath, const std::string& mountPoint)
+{
+    std::shared_ptr<Pack> pack = std::make_shared<Pack>();
+    pack->path = packPath;
+    pack->stamp = GetDiskStamp(packPath);
+
+    pack->file = CreateFileA(packPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (pack->file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(pack->file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(PackHeader)))
+        return false;
+    pack->size = static_cast<uint64_t>(fileSize.QuadPart);
+
+    pack->mapping = CreateFileMappingA(pack->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (pack->mapping == NULL)
+        return false;
+
+    pack->view = static_cast<const unsigned char*>(MapViewOfFile(pack->mapping, FILE_MAP_READ, 0, 0, 0));
+    if (pack->view == nullptr)
+        return false;
+
+    PackHeader header;
+    memcpy(&header, pack->view, sizeof(header));
+
+    uint64_t tocSize = static_cast<uint64_t>(header.entryCount) * sizeof(PackEntry) + header.stringBytes;
+    if (header.magic != PACK_MAGIC || header.version != PACK_VERSION ||
+        header.tocOffset > pack->size || tocSize > pack->size - header.tocOffset)
+    {
+        LOG_DEBUG("VFS: %s is not a pack of version %d", packPath.c_str(), PACK_VERSION);
+        LOG_CONSOLE("ERROR: Invalid pack file %s", packPath.c_str());
+        return false;
+    }
+
+    pack->entries.resize(header.entryCount);
+    memcpy(pack->entries.data(), pack->view + header.tocOffset, header.entryCount * sizeof(PackEntry));
+    const char* names = reinterpret_cast<const char*>(pack->view + header.tocOffset + header.entryCount * sizeof(PackEntry));
+
+    pack->lookup.reserve(header.entryCount);
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        const PackEntry& entry = pack->entries[i];
+        bool valid = entry.nameOffset <= header.stringBytes && entry.nameLength <= header.stringBytes - entry.nameOffset &&
+            entry.dataOffset <= pack->size && entry.storedSize <= pack->size - entry.dataOffset &&
+            ((entry.compression == PACK_ENTRY_LZ4 && entry.size <= LZ4_MAX_INPUT_SIZE && entry.storedSize <= LZ4_MAX_INPUT_SIZE) ||
+             (entry.compression == PACK_ENTRY_RAW && entry.storedSize == entry.size));
+
+        if (!valid)
+        {
+            LOG_CONSOLE("ERROR: Pack %s has a damaged entry", packPath.c_str());
+            return false;
+        }
+
+        pack->lookup.emplace(std::string(names + entry.nameOffset, entry.nameLength), i);
+    }
+
+    Mount mount;
+    mount.mountPoint = NormalizeVirtualPath(mountPoint);
+    mount.pack = pack;
+
+    std::lock_guard<std::mutex> lock(mountMutex);
+    mounts.push_back(mount);
+
+    LOG_DEBUG("VFS: mounted pack %s as '%s' (%u entries)", packPath.c_str(), mount.mountPoint.c_str(), header.entryCount);
+    LOG_CONSOLE("Pack mounted: %s (%u files)", packPath.c_str(), header.entryCount);
+    return true;
+}
+
+void VirtualFileSystem::Unmount(const std::string& source)
+{
+    std::lock_guard<std::mutex> lock(mountMutex);
+
+    // Reads in flight hold their own reference to a pack, it is unmapped after them
+    mounts.erase(std::remove_if(mounts.begin(), mounts.end(), [&source](const Mount& mount)
+    {
+        return mount.pack ? mount.pack->path == source : mount.directory == source;
+    }), mounts.end());
+}
+
+std::vector<VirtualFileSystem::MountInfo> VirtualFileSystem::GetMounts()
+{
+    std::lock_guard<std::mutex> lock(mountMutex);
+
+    std::vector<MountInfo> result;
+    for (const Mount& mount : mounts)
+    {
+        MountInfo info;
+        info.mountPoint = mount.mountPoint;
+        info.source = mount.pack ? mount.pack->path : mount.directory;
+        info.pack = mount.pack != nullptr;
+        info.entryCount = mount.pack ? static_cast<unsigned int>(mount.pack->entries.size()) : 0;
+        result.push_back(info);
+    }
+    return result;
+}
+
+bool VirtualFileSystem::BuildPack(const std::string& directory, const std::string& packPath)
+{
+    std::vector<std::string> files;
+    ListFiles(directory, files);
+    if (files.empty())
+        return false;
+
+    std::ofstream file(packPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        LOG_DEBUG("VFS: could not write %s", packPath.c_str());
+        return false;
+    }
+
+    // Written again with the final values at the end
+    PackHeader header = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    std::vector<PackEntry> entries;
+    std::string names;
+    std::vector<unsigned char> bytes;
+    std::vector<char> compressed;
+    uint64_t totalSize = 0;
+
+    for (const std::string& relative : files)
+    {
+        std::string diskPath = directory + "\\" + relative;
+        if (!GetInstance().ReadFile(diskPath, bytes, IOPriority::Urgent))
+            continue;
+
+        std::string name = NormalizeVirtualPath(relative);
+
+        PackEntry entry = {};
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint32_t>(name.size());
+        entry.size = bytes.size();
+        names += name;
+
+        // LZ4 sizes are ints, files past its input limit are stored raw
+        int compressedSize = 0;
+        if (!bytes.empty() && bytes.size() <= LZ4_MAX_INPUT_SIZE)
+        {
+            int sourceSize = static_cast<int>(bytes.size());
+            compressed.resize(LZ4_compressBound(sourceSize));
+            compressedSize = LZ4_compress_default(reinterpret_cast<const char*>(bytes.data()), compressed.data(), sourceSize, static_cast<int>(compressed.size()));
+        }
+
+        if (compressedSize > 0 && compressedSize < bytes.size() * PACK_COMPRESS_RATIO)
+        {
+            entry.compression = PACK_ENTRY_LZ4;
+            entry.storedSize = static_cast<uint64_t>(compressedSize);
+            entry.dataOffset = offset;
+            file.write(compressed.data(), compressedSize);
+        }
+        else
+        {
+            WritePadding(file, offset, PACK_RAW_ALIGNMENT);
+            entry.compression = PACK_ENTRY_RAW;
+            entry.storedSize = bytes.size();
+            entry.dataOffset = offset;
+            file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+
+        offset += entry.storedSize;
+        totalSize += entry.size;
+        entries.push_back(entry);
+    }
+
+    WritePadding(file, offset, sizeof(uint64_t));
+
+    header.magic = PACK_MAGIC;
+    header.version = PACK_VERSION;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.stringBytes = static_cast<uint32_t>(names.size());
+    header.tocOffset = offset;
+
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackEntry));
+    file.write(names.data(), names.size());
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!file)
+        return false;
+
+    LOG_CONSOLE("Pack built: %s, %u files, %.1f MB -> %.1f MB", packPath.c_str(), header.entryCount,
+        totalSize / (1024.0f * 1024.0f), offset / (1024.0f * 1024.0f));
+    return true;
+}
+
+VirtualFileSystem::Location VirtualFileSystem::Resolve(const std::string& path)
+{
+    std::string normalized = NormalizeVirtualPath(path);
+
+    {
+        std::lock_guard<std::mutex> lock(mountMutex);
+
+        for (auto it = mounts.rbegin(); it != mounts.rend(); ++it)
+        {
+            const Mount& mount = *it;
+
+            std::string relative;
+            if (mount.mountPoint.empty())
+                relative = normalized;
+            else if (normalized.size() > mount.mountPoint.size() && normalized[mount.mountPoint.size()] == '/' &&
+                normalized.compare(0, mount.mountPoint.size(), mount.mountPoint) == 0)
+                relative = normalized.substr(mount.mountPoint.size() + 1);
+            else
+                continue;
+
+            if (mount.pack)
+            {
+                auto found = mount.pack->lookup.find(relative);
+                if (found != mount.pack->lookup.end())
+                {
+                    Location location;
+                    location.pack = mount.pack;
+                    location.entry = found->second;
+                    return location;
+                }
+            }
+            else
+            {
+                std::string diskPath = mount.directory + "\\" + relative;
+                std::replace(diskPath.begin(), diskPath.end(), '/', '\\');
+                if (IsFile(diskPath))
+                {
+                    Location location;
+                    location.diskPath = diskPath;
+                    return location;
+                }
+            }
+        }
+    }
+
+    // Not mounted, a plain disk path
+    Location location;
+    location.diskPath = path;
+    return location;
+}
+
+bool VirtualFileSystem::Exists(const std::string& path)
+{
+    Location location = Resolve(path);
+    return location.pack != nullptr || IsFile(location.diskPath);
+}
+
+uint64_t VirtualFileSystem::GetStamp(const std::string& path)
+{
+    Location location = Resolve(path);
+    if (!location.pack)
+        return GetDiskStamp(location.diskPath);
+
+    // Rebuilding the pack changes every entry's stamp
+    const PackEntry& entry = location.pack->entries[location.entry];
+    return (location.pack->stamp * 1099511628211ull ^ entry.dataOffset) * 1099511628211ull ^ entry.size;
+}
+
+std::future<FileData> VirtualFileSystem::ReadAsync(const std::string& path, IOPriority priority, uint64_t offset, uint64_t size)
+{
+    ReadRequest request;
+    request.path = path;
+    request.offset = offset;
+    request.size = size;
+    request.priority = priority;
+    request.promise = std::make_shared<std::promise<FileData>>();
+
+    std::future<FileData> result = request.promise->get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        if (!stopping)
+        {
+            request.sequence = nextSequence++;
+            requests.push(std::move(request));
+            ++pendingReads;
+            condition.notify_one();
+            return result;
+        }
+    }
+
+    // After shutdown there is nobody to serve it, so read it here
+    FileData data;
+    data.ok = Read(Resolve(path), offset, size, data.bytes);
+    request.promise->set_value(std::move(data));
+    return result;
+}
+
+bool VirtualFileSystem::ReadFile(const std::string& path, std::vector<unsigned char>& bytes, IOPriority priority)
+{
+    return ReadRange(path, 0, 0, bytes, priority);
+}
+
+bool VirtualFileSystem::ReadRange(const std::string& path, uint64_t offset, uint64_t size, std::vector<unsigned char>& bytes, IOPriority priority)
+{
+    FileData data = ReadAsync(path, priority, offset, size).get();
+    bytes = std::move(data.bytes);
+    return data.ok;
+}
+
+bool VirtualFileSystem::MapFile(const std::string& path, MappedFile& file)
+{
+    Location location = Resolve(path);
+    if (!location.pack)
+        return false;
+
+    const PackEntry& entry = location.pack->entries[location.entry];
+    if (entry.compression != PACK_ENTRY_RAW)
+        return false;
+
+    file.data = location.pack->view + entry.dataOffset;
+    file.size = static_cast<size_t>(entry.size);
+    file.owner = location.pack;
+    return true;
+}
+
+bool VirtualFileSystem::Read(const Location& location, uint64_t offset, uint64_t size, std::vector<unsigned char>& bytes)
+{
+    bytes.clear();
+
+    if (!location.pack)
+    {
+        std::ifstream file(location.diskPath, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+
+        uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+
+        // An empty file reads as no data, not as a range past its end
+        if (fileSize == 0)
+            return offset == 0;
+
+        if (offset >= fileSize)
+            return false;
+
+        uint64_t count = (size == 0 || size > fileSize - offset) ? fileSize - offset : size;
+        bytes.resize(static_cast<size_t>(count));
+        file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(count));
+
+        bytesRead += count;
+        return static_cast<bool>(file);
+    }
+
+    const PackEntry& entry = location.pack->entries[location.entry];
+    if (entry.size == 0)
+        return offset == 0;
+
+    if (offset >= entry.size)
+        return false;
+
+    uint64_t count = (size == 0 || size > entry.size - offset) ? entry.size - offset : size;
+    const unsigned char* stored = location.pack->view + entry.dataOffset;
+
+    if (entry.compression == PACK_ENTRY_RAW)
+    {
+        bytes.assign(stored + offset, stored + offset + count);
+    }
+    else
+    {
+        // LZ4 blocks cannot be entered in the middle, a range needs the whole entry
+        std::vector<unsigned char> whole;
+        std::vector<unsigned char>& target = (offset == 0 && count == entry.size) ? bytes : whole;
+        target.resize(static_cast<size_t>(entry.size));
+
+        int decompressed = LZ4_decompress_safe(reinterpret_cast<const char*>(stored), reinterpret_cast<char*>(target.data()),
+            static_cast<int>(entry.storedSize), static_cast<int>(entry.size));
+        if (decompressed != static_cast<int>(entry.size))
+        {
+            bytes.clear();
+            return false;
+        }
+
+        if (&target == &whole)
+            bytes.assign(whole.begin() + offset, whole.begin() + offset + count);
+    }
+
+    bytesRead += count;
+    return true;
+}
+
+void VirtualFileSystem::IOLoop()
+{
+    while (true)
+    {
+        ReadRequest request;
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            condition.wait(lock, [this]() { return stopping || !requests.empty(); });
+
+            if (requests.empty())
+                return;
+
+            request = requests.top();
+            requests.pop();
+        }
+
+        FileData data;
+        data.ok = Read(Resolve(request.path), request.offset, request.size, data.bytes);
+        --pendingReads;
+        request.promise->set_value(std::move(data));
+    }
+}
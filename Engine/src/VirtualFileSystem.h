@@ -0,0 +1,152 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+
+// Order in which queued reads are served, requests of equal priority run in submission order
+enum class IOPriority
+{
+    Background = 0, // Streaming, nobody waits on it
+    Normal,         // Loaders on the worker threads
+    Urgent          // The main thread is blocked on it
+};
+
+// Result of an asynchronous read
+struct FileData
+{
+    std::vector<unsigned char> bytes;
+    bool ok = false;
+};
+
+// Bytes of an uncompressed pack entry, read in place from the mapping.
+// owner keeps the pack mapped, even if it is unmounted meanwhile.
+struct MappedFile
+{
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    std::shared_ptr<const void> owner;
+};
+
+// Every file read of the engine goes through here. Directories and pack files are mounted
+// under a virtual prefix ("Assets/BakerHouse.fbx"), paths matching no mount are plain disk
+// paths. Reads are queued by priority and served by a few I/O threads, so the loaders on the
+// worker pool share one scheduler instead of each blocking on its own opens.
+class VirtualFileSystem
+{
+public:
+    struct MountInfo
+    {
+        std::string mountPoint;
+        std::string source;
+        bool pack = false;
+        unsigned int entryCount = 0;
+    };
+
+    static VirtualFileSystem& GetInstance();
+
+    static std::string GetExecutableDirectory();
+    // First folder called name in startDirectory or up to maxLevels above it, empty if none
+    static std::string FindDirectoryUpwards(const std::string& startDirectory, const std::string& name, int maxLevels);
+    // Paths of every file below a disk directory, relative to it and '/' separated
+    static void ListFiles(const std::string& directory, std::vector<std::string>& files);
+
+    // The latest mount wins when several provide the same file
+    bool MountDirectory(const std::string& directory, const std::string& mountPoint);
+    bool MountPack(const std::string& packPath, const std::string& mountPoint);
+    void Unmount(const std::string& source);
+    std::vector<MountInfo> GetMounts();
+
+    // Writes every file under directory into a pack. Entries LZ4 shrinks enough are stored
+    // compressed, the rest raw at page aligned offsets so they can be used straight from the mapping.
+    static bool BuildPack(const std::string& directory, const std::string& packPath);
+
+    bool Exists(const std::string& path);
+    // Changes whenever the file (or the pack holding it) does, 0 when it does not exist
+    uint64_t GetStamp(const std::string& path);
+
+    // size 0 reads to the end, a range past the end returns the bytes that exist
+    std::future<FileData> ReadAsync(const std::string& path, IOPriority priority = IOPriority::Normal,
+        uint64_t offset = 0, uint64_t size = 0);
+    // ReadAsync and wait for it
+    bool ReadFile(const std::string& path, std::vector<unsigned char>& bytes, IOPriority priority = IOPriority::Normal);
+    bool ReadRange(const std::string& path, uint64_t offset, uint64_t size, std::vector<unsigned char>& bytes,
+        IOPriority priority = IOPriority::Normal);
+
+    // Zero copy access, only for uncompressed pack entries
+    bool MapFile(const std::string& path, MappedFile& file);
+
+    unsigned int GetPendingReads() const { return pendingReads.load(); }
+    uint64_t GetBytesRead() const { return bytesRead.load(); }
+
+    // Serves what is still queued and joins the I/O threads, later reads run on the caller
+    void Shutdown();
+
+private:
+    VirtualFileSystem();
+    ~VirtualFileSystem();
+
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+    struct Pack;
+
+    struct Mount
+    {
+        std::string mountPoint;     // Normalized, no trailing slash
+        std::string directory;
+        std::shared_ptr<Pack> pack;
+    };
+
+    // Where a virtual path ended up
+    struct Location
+    {
+        std::string diskPath;       // Used when pack is null
+        std::shared_ptr<Pack> pack;
+        uint32_t entry = 0;
+    };
+
+    struct ReadRequest
+    {
+        std::string path;
+        uint64_t offset;
+        uint64_t size;
+        IOPriority priority;
+        uint64_t sequence;
+        std::shared_ptr<std::promise<FileData>> promise;
+    };
+
+    struct RequestOrder
+    {
+        bool operator()(const ReadRequest& a, const ReadRequest& b) const
+        {
+            if (a.priority != b.priority)
+                return a.priority < b.priority;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    Location Resolve(const std::string& path);
+    bool Read(const Location& location, uint64_t offset, uint64_t size, std::vector<unsigned char>& bytes);
+    void IOLoop();
+
+    std::vector<Mount> mounts;
+    std::mutex mountMutex;
+
+    std::vector<std::thread> ioThreads;
+    std::priority_queue<ReadRequest, std::vector<ReadRequest>, RequestOrder> requests;
+    std::mutex queueMutex;
+    std::condition_variable condition;
+    uint64_t nextSequence = 0;
+    bool stopping = false;
+
+    std::atomic<unsigned int> pendingReads{ 0 };
+    std::atomic<uint64_t> bytesRead{ 0 };
+};
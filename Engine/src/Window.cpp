@@ -2,6 +2,7 @@
 #include <iostream>
 #include <glad/glad.h>
 #include "Log.h"
+#include "RenderThread.h"
 
 Window::Window() : window(nullptr), width(1280), height(720), scale(1)
 {
@@ -75,7 +76,13 @@ bool Window::Update()
     {
         width = newWidth;
         height = newHeight;
-        glViewport(0, 0, width, height);
+
+        int viewportWidth = width;
+        int viewportHeight = height;
+        RenderThread::GetInstance().Enqueue([viewportWidth, viewportHeight]()
+        {
+            glViewport(0, 0, viewportWidth, viewportHeight);
+        });
     }
 
     return true;
@@ -84,12 +91,19 @@ bool Window::Update()
 bool Window::PostUpdate()
 {
     Render();
+
+    // The frame is recorded, the render thread submits it while the next one is simulated
+    RenderThread::GetInstance().EndFrame();
     return true;
 }
 
 void Window::Render()
 {
-    SDL_GL_SwapWindow(window);
+    SDL_Window* target = window;
+    RenderThread::GetInstance().Enqueue([target]()
+    {
+        SDL_GL_SwapWindow(target);
+    });
 }
 
 bool Window::CleanUp()
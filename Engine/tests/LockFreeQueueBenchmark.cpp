@@ -0,0 +1,101 @@
+#include "LockFreeQueue.h"
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Messages per run, split between the producers
+#define BENCHMARK_MESSAGES 4000000
+#define BENCHMARK_CAPACITY 1024
+
+// Mutex and deque, what the queues replace
+template<typename T>
+class LockedQueue
+{
+public:
+    explicit LockedQueue(size_t capacity) : capacity(capacity) {}
+
+    bool TryPush(T value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.size() >= capacity)
+            return false;
+        items.push_back(value);
+        return true;
+    }
+
+    bool TryPop(T& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty())
+            return false;
+        value = items.front();
+        items.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<T> items;
+    size_t capacity;
+};
+
+// Millions of messages per second from 'producers' threads to the calling thread
+template<typename Queue>
+static double Measure(int producers)
+{
+    Queue queue(BENCHMARK_CAPACITY);
+    const size_t perProducer = BENCHMARK_MESSAGES / producers;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&queue, perProducer]()
+        {
+            for (size_t i = 0; i < perProducer;)
+            {
+                if (queue.TryPush(i))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    size_t received = 0;
+    size_t value = 0;
+    while (received < perProducer * producers)
+    {
+        if (queue.TryPop(value))
+            ++received;
+        else
+            std::this_thread::yield();
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return received / seconds / 1e6;
+}
+
+int main()
+{
+    std::printf("%-12s %10s %12s\n", "Queue", "Producers", "Mmsg/s");
+
+    std::printf("%-12s %10d %12.1f\n", "SPSCQueue", 1, Measure<SPSCQueue<size_t>>(1));
+    std::printf("%-12s %10d %12.1f\n", "Locked", 1, Measure<LockedQueue<size_t>>(1));
+
+    const int producerCounts[] = { 1, 2, 4 };
+    for (int producers : producerCounts)
+    {
+        std::printf("%-12s %10d %12.1f\n", "MPSCQueue", producers, Measure<MPSCQueue<size_t>>(producers));
+        std::printf("%-12s %10d %12.1f\n", "Locked", producers, Measure<LockedQueue<size_t>>(producers));
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "LockFreeQueue.h"
+#include "TestUtils.h"
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Producer id in the high bits, sequence number in the low ones
+#define PRODUCER_SHIFT 40
+#define SEQUENCE_MASK ((static_cast<uint64_t>(1) << PRODUCER_SHIFT) - 1)
+
+static void TestCapacity()
+{
+    SPSCQueue<int> spsc(5);
+    MPSCQueue<int> mpsc(1);
+    CHECK(spsc.GetCapacity() == 8);
+    CHECK(mpsc.GetCapacity() == 2);
+
+    int value = 0;
+    CHECK(!spsc.TryPop(value));
+    CHECK(!mpsc.TryPop(value));
+
+    for (int i = 0; i < 8; ++i)
+        CHECK(spsc.TryPush(i));
+    CHECK(!spsc.TryPush(8));
+    CHECK(spsc.GetSizeApprox() == 8);
+
+    // A full queue takes pushes again once the consumer frees a cell
+    CHECK(spsc.TryPop(value) && value == 0);
+    CHECK(spsc.TryPush(8));
+
+    CHECK(mpsc.TryPush(1) && mpsc.TryPush(2));
+    CHECK(!mpsc.TryPush(3));
+    CHECK(mpsc.TryPop(value) && value == 1);
+    CHECK(mpsc.TryPush(3));
+    CHECK(mpsc.TryPop(value) && value == 2);
+    CHECK(mpsc.TryPop(value) && value == 3);
+    CHECK(!mpsc.TryPop(value));
+}
+
+static void TestMovesValues()
+{
+    // Wraps around several times with a type that owns memory
+    SPSCQueue<std::string> spsc(4);
+    MPSCQueue<std::string> mpsc(4);
+    std::string value;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        std::string text(64, static_cast<char>('a' + i));
+        CHECK(spsc.TryPush(text));
+        CHECK(mpsc.TryPush(text));
+        CHECK(spsc.TryPop(value) && value == text);
+        CHECK(mpsc.TryPop(value) && value == text);
+    }
+}
+
+static void TestSPSCStress()
+{
+    const uint64_t count = 1000000;
+    SPSCQueue<uint64_t> queue(256);
+
+    std::thread producer([&]()
+    {
+        for (uint64_t i = 0; i < count;)
+        {
+            if (queue.TryPush(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    uint64_t expected = 0;
+    bool ordered = true;
+    uint64_t value = 0;
+    while (expected < count)
+    {
+        if (!queue.TryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ordered = ordered && value == expected;
+        ++expected;
+    }
+
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(!queue.TryPop(value));
+}
+
+static void TestMPSCStress()
+{
+    const int producerCount = 4;
+    const uint64_t countPerProducer = 250000;
+    MPSCQueue<uint64_t> queue(256);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p)
+    {
+        producers.emplace_back([&queue, p, countPerProducer]()
+        {
+            for (uint64_t i = 0; i < countPerProducer;)
+            {
+                if (queue.TryPush((static_cast<uint64_t>(p) << PRODUCER_SHIFT) | i))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // Producers interleave freely, but each one's values must arrive in its push order
+    std::vector<uint64_t> next(producerCount, 0);
+    uint64_t received = 0;
+    bool ordered = true;
+    bool known = true;
+    uint64_t value = 0;
+    while (received < producerCount * countPerProducer && ordered && known)
+    {
+        if (!queue.TryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint64_t producer = value >> PRODUCER_SHIFT;
+        known = producer < static_cast<uint64_t>(producerCount);
+        if (known)
+        {
+            ordered = (value & SEQUENCE_MASK) == next[producer];
+            ++next[producer];
+        }
+        ++received;
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+
+    CHECK(known);
+    CHECK(ordered);
+    CHECK(received == producerCount * countPerProducer);
+    for (int p = 0; p < producerCount; ++p)
+        CHECK(next[p] == countPerProducer);
+    CHECK(!queue.TryPop(value));
+}
+
+int main()
+{
+    TestCapacity();
+    TestMovesValues();
+    TestSPSCStress();
+    TestMPSCStress();
+
+    return TEST_RESULT();
+}
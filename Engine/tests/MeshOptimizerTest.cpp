@@ -0,0 +1,203 @@
+#include "MeshOptimizer.h"
+#include "FileSystem.h"
+#include "TestUtils.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// A triangle as its three corner positions, rotated to start at the smallest one so the
+// winding is kept but the starting corner does not matter
+typedef std::array<float, 9> TriangleKey;
+
+// (size + 1)^2 vertices in rows, two triangles per cell
+static Mesh MakeGrid(int size)
+{
+    Mesh mesh;
+    for (int y = 0; y <= size; ++y)
+    {
+        for (int x = 0; x <= size; ++x)
+        {
+            Vertex vertex;
+            vertex.position = glm::vec3(static_cast<float>(x), static_cast<float>(y), 0.0f);
+            vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+            vertex.texCoords = glm::vec2(static_cast<float>(x) / size, static_cast<float>(y) / size);
+            mesh.vertices.push_back(vertex);
+        }
+    }
+
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            unsigned int corner = static_cast<unsigned int>(y * (size + 1) + x);
+            unsigned int row = static_cast<unsigned int>(size + 1);
+            unsigned int cell[6] = { corner, corner + 1, corner + row, corner + row, corner + 1, corner + row + 1 };
+            mesh.indices.insert(mesh.indices.end(), cell, cell + 6);
+        }
+    }
+
+    return mesh;
+}
+
+// Deterministic triangle shuffle, the worst case for the cache
+static void ShuffleTriangles(std::vector<unsigned int>& indices)
+{
+    uint32_t state = 99;
+    size_t triangleCount = indices.size() / 3;
+    for (size_t t = triangleCount - 1; t > 0; --t)
+    {
+        state = state * 1664525u + 1013904223u;
+        size_t other = (state >> 8) % (t + 1);
+        for (int corner = 0; corner < 3; ++corner)
+            std::swap(indices[t * 3 + corner], indices[other * 3 + corner]);
+    }
+}
+
+static std::vector<TriangleKey> GetTriangles(const Mesh& mesh)
+{
+    std::vector<TriangleKey> triangles;
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+    {
+        std::array<std::array<float, 3>, 3> corners;
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const glm::vec3& position = mesh.vertices[mesh.indices[t + corner]].position;
+            corners[corner] = { position.x, position.y, position.z };
+        }
+
+        int first = static_cast<int>(std::min_element(corners.begin(), corners.end()) - corners.begin());
+        TriangleKey key;
+        for (int corner = 0; corner < 3; ++corner)
+            std::copy(corners[(first + corner) % 3].begin(), corners[(first + corner) % 3].end(), key.begin() + corner * 3);
+        triangles.push_back(key);
+    }
+
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+static bool IndicesInRange(const Mesh& mesh)
+{
+    for (unsigned int index : mesh.indices)
+    {
+        if (index >= mesh.vertices.size())
+            return false;
+    }
+    return true;
+}
+
+static void TestAnalyzeVertexCache()
+{
+    std::vector<unsigned int> single = { 0, 1, 2 };
+    VertexCacheStats stats = MeshOptimizer::AnalyzeVertexCache(single, 3);
+    CHECK(stats.acmr == 3.0f);
+    CHECK(stats.atvr == 1.0f);
+
+    // The second copy of the triangle hits the cache on all three vertices
+    std::vector<unsigned int> twice = { 0, 1, 2, 0, 1, 2 };
+    stats = MeshOptimizer::AnalyzeVertexCache(twice, 3);
+    CHECK(stats.acmr == 1.5f);
+}
+
+static void TestVertexCache()
+{
+    Mesh mesh = MakeGrid(32);
+    ShuffleTriangles(mesh.indices);
+    std::vector<TriangleKey> triangles = GetTriangles(mesh);
+    size_t indexCount = mesh.indices.size();
+
+    float before = MeshOptimizer::AnalyzeVertexCache(mesh.indices, mesh.vertices.size()).acmr;
+    MeshOptimizer::OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+    float after = MeshOptimizer::AnalyzeVertexCache(mesh.indices, mesh.vertices.size()).acmr;
+
+    CHECK(mesh.indices.size() == indexCount);
+    CHECK(IndicesInRange(mesh));
+    CHECK(GetTriangles(mesh) == triangles);
+    CHECK(after < before);
+    // A grid can get close to 0.5 with a 16 entry FIFO, shuffled it is near 3
+    CHECK(after < 0.8f);
+
+    // An already optimized order must not get worse
+    MeshOptimizer::OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+    CHECK(MeshOptimizer::AnalyzeVertexCache(mesh.indices, mesh.vertices.size()).acmr <= after + 0.01f);
+}
+
+static void TestOverdraw()
+{
+    Mesh mesh = MakeGrid(32);
+    ShuffleTriangles(mesh.indices);
+    MeshOptimizer::OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+    std::vector<TriangleKey> triangles = GetTriangles(mesh);
+
+    float before = MeshOptimizer::AnalyzeVertexCache(mesh.indices, mesh.vertices.size()).acmr;
+    MeshOptimizer::OptimizeOverdraw(mesh.indices, mesh.vertices, 1.05f);
+    float after = MeshOptimizer::AnalyzeVertexCache(mesh.indices, mesh.vertices.size()).acmr;
+
+    CHECK(IndicesInRange(mesh));
+    CHECK(GetTriangles(mesh) == triangles);
+    CHECK(after <= before * 1.05f + 0.01f);
+}
+
+static void TestVertexFetch()
+{
+    Mesh mesh = MakeGrid(8);
+    ShuffleTriangles(mesh.indices);
+
+    // A vertex no triangle uses is dropped
+    Vertex unused;
+    unused.position = glm::vec3(100.0f);
+    mesh.vertices.insert(mesh.vertices.begin(), unused);
+    for (unsigned int& index : mesh.indices)
+        ++index;
+
+    std::vector<TriangleKey> triangles = GetTriangles(mesh);
+    size_t usedVertices = mesh.vertices.size() - 1;
+
+    MeshOptimizer::OptimizeVertexFetch(mesh);
+
+    CHECK(mesh.vertices.size() == usedVertices);
+    CHECK(IndicesInRange(mesh));
+    CHECK(GetTriangles(mesh) == triangles);
+
+    // Vertices are stored in first use order: every new index is at most one past the highest so far
+    unsigned int next = 0;
+    bool firstUseOrder = true;
+    for (unsigned int index : mesh.indices)
+    {
+        firstUseOrder = firstUseOrder && index <= next;
+        if (index == next)
+            ++next;
+    }
+    CHECK(firstUseOrder);
+    CHECK(next == mesh.vertices.size());
+}
+
+static void TestOptimize()
+{
+    Mesh mesh = MakeGrid(48);
+    ShuffleTriangles(mesh.indices);
+    std::vector<TriangleKey> triangles = GetTriangles(mesh);
+
+    MeshOptimizationStats stats;
+    MeshOptimizer::Optimize(mesh, &stats);
+
+    CHECK(IndicesInRange(mesh));
+    CHECK(GetTriangles(mesh) == triangles);
+    CHECK(stats.triangles == triangles.size());
+    CHECK(stats.vertices == mesh.vertices.size());
+    CHECK(stats.after.acmr <= stats.before.acmr);
+    CHECK(stats.after.acmr < 0.85f);
+    CHECK(stats.after.atvr <= stats.before.atvr);
+}
+
+int main()
+{
+    TestAnalyzeVertexCache();
+    TestVertexCache();
+    TestOverdraw();
+    TestVertexFetch();
+    TestOptimize();
+
+    return TEST_RESULT();
+}
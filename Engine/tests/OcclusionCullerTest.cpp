@@ -0,0 +1,104 @@
+#include "OcclusionCuller.h"
+#include "AABB.h"
+#include "FileSystem.h"
+#include "TestUtils.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+// Camera at the origin looking down -Z, a 10x10 wall at z = -10
+static glm::mat4 MakeViewProjection()
+{
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return projection * view;
+}
+
+static void AddWall(OcclusionCuller& culler, const glm::mat4& model)
+{
+    std::vector<Vertex> vertices(4);
+    vertices[0].position = glm::vec3(-5.0f, -5.0f, -10.0f);
+    vertices[1].position = glm::vec3(5.0f, -5.0f, -10.0f);
+    vertices[2].position = glm::vec3(5.0f, 5.0f, -10.0f);
+    vertices[3].position = glm::vec3(-5.0f, 5.0f, -10.0f);
+
+    // Second triangle wound clockwise, occluders are double sided
+    std::vector<unsigned int> indices = { 0, 1, 2, 0, 3, 2 };
+    culler.AddOccluder(vertices, indices, model);
+}
+
+static AABB Box(const glm::vec3& center, float halfSize)
+{
+    return AABB(center - glm::vec3(halfSize), center + glm::vec3(halfSize));
+}
+
+static void TestEmptyBufferOccludesNothing()
+{
+    OcclusionCuller culler;
+    culler.BeginFrame(MakeViewProjection());
+    culler.EndOccluders();
+
+    CHECK(!culler.IsOccluded(Box(glm::vec3(0.0f, 0.0f, -50.0f), 1.0f)));
+    CHECK(culler.GetStats().occluded == 0);
+}
+
+static void TestWallHidesBoxBehind()
+{
+    OcclusionCuller culler;
+    culler.BeginFrame(MakeViewProjection());
+    AddWall(culler, glm::mat4(1.0f));
+    culler.EndOccluders();
+
+    CHECK(culler.GetStats().occluders == 1);
+    CHECK(culler.GetStats().occluderTriangles == 2);
+
+    // Behind the wall and inside its silhouette
+    CHECK(culler.IsOccluded(Box(glm::vec3(0.0f, 0.0f, -20.0f), 1.0f)));
+    // In front of the wall
+    CHECK(!culler.IsOccluded(Box(glm::vec3(0.0f, 0.0f, -5.0f), 1.0f)));
+    // Behind the wall's depth but beside it
+    CHECK(!culler.IsOccluded(Box(glm::vec3(20.0f, 0.0f, -20.0f), 1.0f)));
+    // Straddling the wall's edge, partly visible
+    CHECK(!culler.IsOccluded(Box(glm::vec3(10.0f, 0.0f, -20.0f), 2.0f)));
+    // Crossing the near plane
+    CHECK(!culler.IsOccluded(Box(glm::vec3(0.0f), 1.0f)));
+
+    CHECK(culler.GetStats().tested == 5);
+    CHECK(culler.GetStats().occluded == 1);
+}
+
+static void TestOccluderModelMatrix()
+{
+    OcclusionCuller culler;
+    culler.BeginFrame(MakeViewProjection());
+    AddWall(culler, glm::translate(glm::mat4(1.0f), glm::vec3(5.0f, 0.0f, 0.0f)));
+    culler.EndOccluders();
+
+    CHECK(culler.IsOccluded(Box(glm::vec3(10.0f, 0.0f, -20.0f), 1.0f)));
+    CHECK(!culler.IsOccluded(Box(glm::vec3(-10.0f, 0.0f, -20.0f), 1.0f)));
+}
+
+static void TestBeginFrameClears()
+{
+    OcclusionCuller culler;
+    culler.BeginFrame(MakeViewProjection());
+    AddWall(culler, glm::mat4(1.0f));
+    culler.EndOccluders();
+    CHECK(culler.IsOccluded(Box(glm::vec3(0.0f, 0.0f, -20.0f), 1.0f)));
+
+    // A new frame without occluders, such as when every occluder got disabled
+    culler.BeginFrame(MakeViewProjection());
+    culler.EndOccluders();
+    CHECK(!culler.IsOccluded(Box(glm::vec3(0.0f, 0.0f, -20.0f), 1.0f)));
+
+    for (float depth : culler.GetDepthBuffer())
+        CHECK(depth == 1.0f);
+}
+
+int main()
+{
+    TestEmptyBufferOccludesNothing();
+    TestWallHidesBoxBehind();
+    TestOccluderModelMatrix();
+    TestBeginFrameClears();
+
+    return TEST_RESULT();
+}
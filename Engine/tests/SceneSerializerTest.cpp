@@ -0,0 +1,256 @@
+#include "SceneSerializer.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "ComponentMesh.h"
+#include "FileSystem.h"
+#include "TestUtils.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#define SCENE_FILE "SceneSerializerTest.scene"
+#define DAMAGED_FILE "SceneSerializerTest.damaged.scene"
+#define MESH_FILE "SceneSerializerTest.mesh"
+
+// Same layout as SceneFileHeader in SceneSerializer.cpp: seven 32 bit counts, then the records
+#define SCENE_HEADER_BYTES 28
+
+static std::vector<unsigned char> ReadBytes(const char* path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void WriteBytes(const char* path, const std::vector<unsigned char>& bytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+// CPU only: without a VAO no GL buffer is ever created or released for it
+static std::shared_ptr<const Mesh> MakeMesh(float offset, bool withLOD)
+{
+    auto mesh = std::make_shared<Mesh>();
+    mesh->vertices.resize(4);
+    for (size_t i = 0; i < mesh->vertices.size(); ++i)
+    {
+        mesh->vertices[i].position = glm::vec3(offset + (i & 1), static_cast<float>(i >> 1), 0.0f);
+        mesh->vertices[i].normal = glm::vec3(0.0f, 0.0f, 1.0f);
+        mesh->vertices[i].texCoords = glm::vec2(static_cast<float>(i & 1), static_cast<float>(i >> 1));
+    }
+    mesh->indices = { 0, 1, 2, 2, 1, 3 };
+
+    if (withLOD)
+    {
+        MeshLOD lod;
+        lod.indices = { 0, 1, 2 };
+        lod.error = 0.25f;
+        mesh->lods.push_back(lod);
+    }
+
+    return mesh;
+}
+
+static ComponentMesh* AddMesh(GameObject* gameObject, const std::shared_ptr<const Mesh>& mesh, const char* source, unsigned int index)
+{
+    ComponentMesh* meshComp = static_cast<ComponentMesh*>(gameObject->CreateComponent(ComponentType::MESH));
+    meshComp->SetSharedMesh(mesh, ComputeVertexBounds(mesh->vertices.data(), mesh->vertices.size()));
+    meshComp->SetSource(source, index);
+    return meshComp;
+}
+
+static Transform* GetTransform(GameObject* gameObject)
+{
+    return static_cast<Transform*>(gameObject->GetComponent(ComponentType::TRANSFORM));
+}
+
+static const Mesh* GetMesh(GameObject* gameObject, size_t index)
+{
+    std::vector<Component*> meshComps = gameObject->GetComponentsOfType(ComponentType::MESH);
+    return index < meshComps.size() ? static_cast<ComponentMesh*>(meshComps[index])->GetSharedMesh().get() : nullptr;
+}
+
+static bool Near(const glm::vec3& a, const glm::vec3& b)
+{
+    return std::abs(a.x - b.x) < 1e-5f && std::abs(a.y - b.y) < 1e-5f && std::abs(a.z - b.z) < 1e-5f;
+}
+
+static bool Near(const glm::quat& a, const glm::quat& b)
+{
+    return std::abs(a.x - b.x) < 1e-5f && std::abs(a.y - b.y) < 1e-5f && std::abs(a.z - b.z) < 1e-5f && std::abs(a.w - b.w) < 1e-5f;
+}
+
+// True when loading the file adds nothing and fails
+static bool IsRejected(const std::vector<unsigned char>& bytes)
+{
+    WriteBytes(DAMAGED_FILE, bytes);
+
+    GameObject parent("Damaged");
+    bool loaded = SceneSerializer::GetInstance().Load(DAMAGED_FILE, &parent);
+    return !loaded && parent.GetChildren().empty();
+}
+
+static void TestSceneRoundTrip()
+{
+    std::shared_ptr<const Mesh> meshA = MakeMesh(0.0f, true);
+    std::shared_ptr<const Mesh> meshB = MakeMesh(10.0f, false);
+
+    // Root
+    //   First   (meshA)
+    //     Child (meshA, meshB, disabled)
+    //     Empty
+    //   Second  (meshB)
+    GameObject* root = new GameObject("Root");
+    GameObject* first = new GameObject("First");
+    GameObject* child = new GameObject("Child");
+    GameObject* empty = new GameObject("Empty");
+    GameObject* second = new GameObject("Second");
+    root->AddChild(first);
+    root->AddChild(second);
+    first->AddChild(child);
+    first->AddChild(empty);
+
+    GetTransform(first)->SetPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    GetTransform(first)->SetRotationQuat(glm::normalize(glm::quat(0.9f, 0.1f, 0.3f, -0.2f)));
+    GetTransform(first)->SetScale(glm::vec3(2.0f, 2.0f, 0.5f));
+    GetTransform(child)->SetPosition(glm::vec3(-4.0f, 0.0f, 8.0f));
+    child->SetActive(false);
+
+    AddMesh(first, meshA, "Assets/Model.fbx", 0);
+    AddMesh(child, meshA, "Assets/Model.fbx", 0);
+    AddMesh(child, meshB, "Assets/Model.fbx", 1);
+    AddMesh(second, meshB, "Assets/Model.fbx", 1);
+
+    CHECK(SceneSerializer::GetInstance().Save(root, SCENE_FILE));
+
+    GameObject* loaded = new GameObject("Loaded");
+    CHECK(SceneSerializer::GetInstance().Load(SCENE_FILE, loaded));
+
+    // Same parents, children in the saved order
+    const std::vector<GameObject*>& top = loaded->GetChildren();
+    CHECK(top.size() == 2);
+    if (top.size() == 2)
+    {
+        GameObject* loadedFirst = top[0];
+        GameObject* loadedSecond = top[1];
+        CHECK(loadedFirst->GetName() == "First");
+        CHECK(loadedSecond->GetName() == "Second");
+        CHECK(loadedSecond->GetChildren().empty());
+
+        const std::vector<GameObject*>& children = loadedFirst->GetChildren();
+        CHECK(children.size() == 2);
+        if (children.size() == 2)
+        {
+            GameObject* loadedChild = children[0];
+            CHECK(loadedChild->GetName() == "Child");
+            CHECK(children[1]->GetName() == "Empty");
+            CHECK(!loadedChild->IsActive());
+            CHECK(loadedFirst->IsActive());
+            CHECK(Near(GetTransform(loadedChild)->GetPosition(), GetTransform(child)->GetPosition()));
+
+            // Meshes still alive are shared, not duplicated
+            CHECK(GetMesh(loadedChild, 0) == meshA.get());
+            CHECK(GetMesh(loadedChild, 1) == meshB.get());
+            CHECK(GetMesh(children[1], 0) == nullptr);
+        }
+
+        CHECK(Near(GetTransform(loadedFirst)->GetPosition(), GetTransform(first)->GetPosition()));
+        CHECK(Near(GetTransform(loadedFirst)->GetRotationQuat(), GetTransform(first)->GetRotationQuat()));
+        CHECK(Near(GetTransform(loadedFirst)->GetScale(), GetTransform(first)->GetScale()));
+
+        CHECK(GetMesh(loadedFirst, 0) == meshA.get());
+        CHECK(GetMesh(loadedSecond, 0) == meshB.get());
+
+        std::vector<Component*> meshComps = loadedSecond->GetComponentsOfType(ComponentType::MESH);
+        CHECK(meshComps.size() == 1);
+        if (meshComps.size() == 1)
+        {
+            ComponentMesh* meshComp = static_cast<ComponentMesh*>(meshComps[0]);
+            CHECK(meshComp->GetSourcePath() == "Assets/Model.fbx");
+            CHECK(meshComp->GetSourceIndex() == 1);
+        }
+    }
+
+    delete loaded;
+    delete root;
+}
+
+static void TestDamagedScenesRejected()
+{
+    std::vector<unsigned char> bytes = ReadBytes(SCENE_FILE);
+    CHECK(bytes.size() > SCENE_HEADER_BYTES);
+    if (bytes.size() <= SCENE_HEADER_BYTES)
+        return;
+
+    std::vector<unsigned char> truncated(bytes.begin(), bytes.end() - 1);
+    CHECK(IsRejected(truncated));
+
+    std::vector<unsigned char> headerOnly(bytes.begin(), bytes.begin() + SCENE_HEADER_BYTES);
+    CHECK(IsRejected(headerOnly));
+
+    std::vector<unsigned char> badMagic = bytes;
+    badMagic[0] ^= 0xFF;
+    CHECK(IsRejected(badMagic));
+
+    // The first record's parent pointing at a later record
+    std::vector<unsigned char> badParent = bytes;
+    int32_t parent = 3;
+    memcpy(&badParent[SCENE_HEADER_BYTES], &parent, sizeof(parent));
+    CHECK(IsRejected(badParent));
+
+    std::vector<unsigned char> empty;
+    CHECK(IsRejected(empty));
+
+    std::remove(DAMAGED_FILE);
+}
+
+static void TestMeshFileRoundTrip()
+{
+    std::shared_ptr<const Mesh> source = MakeMesh(5.0f, true);
+    CHECK(SceneSerializer::WriteMesh(*source, MESH_FILE));
+
+    Mesh mesh;
+    CHECK(SceneSerializer::ReadMesh(MESH_FILE, mesh));
+    CHECK(mesh.vertices.size() == source->vertices.size());
+    CHECK(mesh.indices == source->indices);
+    CHECK(mesh.lods.size() == 1);
+    if (mesh.lods.size() == 1)
+    {
+        CHECK(mesh.lods[0].indices == source->lods[0].indices);
+        CHECK(mesh.lods[0].error == source->lods[0].error);
+    }
+    for (size_t i = 0; i < mesh.vertices.size() && i < source->vertices.size(); ++i)
+    {
+        CHECK(Near(mesh.vertices[i].position, source->vertices[i].position));
+        CHECK(Near(mesh.vertices[i].normal, source->vertices[i].normal));
+    }
+
+    // The content hash names the Library file, equal meshes must agree on it
+    CHECK(SceneSerializer::HashMesh(mesh) == SceneSerializer::HashMesh(*source));
+
+    // Every cut short of the full file is rejected
+    std::vector<unsigned char> bytes = ReadBytes(MESH_FILE);
+    for (size_t size = 0; size < bytes.size(); size += 7)
+    {
+        WriteBytes(MESH_FILE, std::vector<unsigned char>(bytes.begin(), bytes.begin() + size));
+        Mesh truncated;
+        CHECK(!SceneSerializer::ReadMesh(MESH_FILE, truncated));
+    }
+
+    std::remove(MESH_FILE);
+}
+
+int main()
+{
+    TestSceneRoundTrip();
+    TestDamagedScenesRejected();
+    TestMeshFileRoundTrip();
+
+    std::remove(SCENE_FILE);
+    return TEST_RESULT();
+}
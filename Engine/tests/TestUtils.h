@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdio>
+
+// Failed checks are printed and counted, main returns TEST_RESULT() so ctest sees the failure
+static int testFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++testFailures; \
+        } \
+    } while (0)
+
+#define TEST_RESULT() (testFailures == 0 ? 0 : 1)
@@ -0,0 +1,316 @@
+#include "TextureCooker.h"
+#include "Texture.h"
+#include "TestUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Same cutoff as ALPHA_TEST_THRESHOLD in TextureCooker.cpp
+#define COVERAGE_THRESHOLD (0.1f * 255.0f)
+
+struct BlockError
+{
+    int maxError = 0;   // Largest difference of any channel
+    float rms = 0.0f;   // Over the channels that were compared
+};
+
+// Deterministic noise, the results must not change between runs
+static uint32_t NextRandom(uint32_t& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static BlockError Compare(const unsigned char* expected, const unsigned char* actual, size_t pixels, bool withAlpha)
+{
+    BlockError error;
+    double squared = 0.0;
+    int channels = withAlpha ? 4 : 3;
+
+    for (size_t i = 0; i < pixels; ++i)
+    {
+        for (int c = 0; c < channels; ++c)
+        {
+            int difference = std::abs(expected[i * 4 + c] - actual[i * 4 + c]);
+            error.maxError = std::max(error.maxError, difference);
+            squared += difference * difference;
+        }
+    }
+
+    error.rms = static_cast<float>(std::sqrt(squared / (pixels * channels)));
+    return error;
+}
+
+static BlockError RoundTrip(TextureFormat format, const unsigned char* block)
+{
+    unsigned char encoded[16];
+    unsigned char decoded[64];
+
+    if (format == TextureFormat::BC1)
+        TextureCooker::EncodeBC1Block(block, encoded);
+    else if (format == TextureFormat::BC3)
+        TextureCooker::EncodeBC3Block(block, encoded);
+    else
+        TextureCooker::EncodeBC7Block(block, encoded);
+
+    TextureCooker::DecodeBlock(format, encoded, decoded);
+    return Compare(block, decoded, 16, format != TextureFormat::BC1);
+}
+
+static void FillSolid(unsigned char* block, int r, int g, int b, int a)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        block[i * 4 + 0] = static_cast<unsigned char>(r);
+        block[i * 4 + 1] = static_cast<unsigned char>(g);
+        block[i * 4 + 2] = static_cast<unsigned char>(b);
+        block[i * 4 + 3] = static_cast<unsigned char>(a);
+    }
+}
+
+// Ramp between two colors across the block, alpha fading along with it
+static void FillGradient(unsigned char* block, int offset)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        unsigned char* pixel = &block[i * 4];
+        pixel[0] = static_cast<unsigned char>(offset + i * 3);
+        pixel[1] = static_cast<unsigned char>(offset + 60 - i * 4);
+        pixel[2] = static_cast<unsigned char>(offset + i * 2);
+        pixel[3] = static_cast<unsigned char>(255 - i * 8);
+    }
+}
+
+static void FillRandom(unsigned char* block, uint32_t& state)
+{
+    for (int i = 0; i < 64; ++i)
+        block[i] = static_cast<unsigned char>(NextRandom(state) & 0xFF);
+}
+
+static float Coverage(const TextureMip& mip)
+{
+    size_t pixels = static_cast<size_t>(mip.width) * mip.height;
+    size_t covered = 0;
+    for (size_t i = 0; i < pixels; ++i)
+    {
+        if (mip.data[i * 4 + 3] >= COVERAGE_THRESHOLD)
+            ++covered;
+    }
+    return static_cast<float>(covered) / pixels;
+}
+
+static void TestSolidBlocks()
+{
+    const int colors[][4] = { { 0, 0, 0, 255 }, { 255, 255, 255, 255 }, { 200, 100, 50, 128 }, { 17, 240, 99, 0 } };
+    unsigned char block[64];
+
+    for (const int* color : colors)
+    {
+        FillSolid(block, color[0], color[1], color[2], color[3]);
+
+        // BC1 stores 565 endpoints, BC3 adds an 8 bit alpha pair, BC7 mode 6 keeps 7 bits and a p-bit
+        CHECK(RoundTrip(TextureFormat::BC1, block).maxError <= 4);
+        CHECK(RoundTrip(TextureFormat::BC3, block).maxError <= 4);
+        CHECK(RoundTrip(TextureFormat::BC7, block).maxError <= 1);
+    }
+}
+
+static void TestGradientBlocks()
+{
+    unsigned char block[64];
+
+    for (int offset = 0; offset <= 192; offset += 64)
+    {
+        FillGradient(block, offset);
+
+        BlockError bc1 = RoundTrip(TextureFormat::BC1, block);
+        BlockError bc3 = RoundTrip(TextureFormat::BC3, block);
+        BlockError bc7 = RoundTrip(TextureFormat::BC7, block);
+
+        CHECK(bc1.maxError <= 12 && bc1.rms <= 6.0f);
+        CHECK(bc3.maxError <= 12 && bc3.rms <= 6.0f);
+        CHECK(bc7.maxError <= 4 && bc7.rms <= 1.5f);
+        CHECK(bc7.rms < bc1.rms);
+    }
+}
+
+static void TestRandomBlocks()
+{
+    uint32_t state = 12345;
+    unsigned char block[64];
+    float bc1Total = 0.0f;
+    float bc3Total = 0.0f;
+    float bc7Total = 0.0f;
+    const int blockCount = 256;
+
+    // Noise is the worst case for a single endpoint pair, only the average error is bounded
+    for (int i = 0; i < blockCount; ++i)
+    {
+        FillRandom(block, state);
+        bc1Total += RoundTrip(TextureFormat::BC1, block).rms;
+        bc3Total += RoundTrip(TextureFormat::BC3, block).rms;
+        bc7Total += RoundTrip(TextureFormat::BC7, block).rms;
+    }
+
+    CHECK(bc1Total / blockCount <= 70.0f);
+    CHECK(bc3Total / blockCount <= 70.0f);
+    CHECK(bc7Total / blockCount <= 70.0f);
+}
+
+static void TestBC1IsOpaque()
+{
+    unsigned char block[64];
+    unsigned char encoded[8];
+    unsigned char decoded[64];
+
+    FillGradient(block, 32);
+    TextureCooker::EncodeBC1Block(block, encoded);
+    TextureCooker::DecodeBlock(TextureFormat::BC1, encoded, decoded);
+
+    for (int i = 0; i < 16; ++i)
+        CHECK(decoded[i * 4 + 3] == 255);
+}
+
+static void TestImageRoundTrip()
+{
+    // Odd size for partial edge blocks, tall enough for Compress to split rows across the workers
+    const TextureFormat formats[] = { TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC7 };
+    TextureMip image;
+    image.width = 37;
+    image.height = 45;
+    image.data.resize(static_cast<size_t>(image.width) * image.height * 4);
+
+    for (int y = 0; y < image.height; ++y)
+    {
+        for (int x = 0; x < image.width; ++x)
+        {
+            unsigned char* pixel = &image.data[(static_cast<size_t>(y) * image.width + x) * 4];
+            pixel[0] = static_cast<unsigned char>(x * 6);
+            pixel[1] = static_cast<unsigned char>(y * 5);
+            pixel[2] = static_cast<unsigned char>(128 + (x - y) * 2);
+            pixel[3] = static_cast<unsigned char>(255 - y * 3);
+        }
+    }
+
+    for (TextureFormat format : formats)
+    {
+        std::vector<unsigned char> compressed = TextureCooker::Compress(image, format);
+        CHECK(compressed.size() == TextureCooker::GetImageSize(format, image.width, image.height));
+
+        std::vector<unsigned char> decompressed = TextureCooker::Decompress(compressed.data(), image.width, image.height, format);
+        CHECK(decompressed.size() == image.data.size());
+
+        BlockError error = Compare(image.data.data(), decompressed.data(), decompressed.size() / 4, format != TextureFormat::BC1);
+        CHECK(error.rms <= 6.0f);
+    }
+}
+
+static void TestMipChain()
+{
+    std::vector<unsigned char> pixels(16 * 8 * 4, 255);
+    std::vector<TextureMip> mips;
+
+    TextureCooker::GenerateMips(pixels.data(), 16, 8, false, mips);
+    CHECK(mips.size() == 5);
+    CHECK(mips.back().width == 1 && mips.back().height == 1);
+
+    TextureCooker::GenerateMips(pixels.data(), 5, 3, false, mips);
+    CHECK(mips.size() == 3);
+    CHECK(mips[1].width == 2 && mips[1].height == 1);
+    CHECK(mips[2].width == 1 && mips[2].height == 1);
+}
+
+static void TestLinearSpaceMips()
+{
+    // Black and white checkerboard: half the light, which is sRGB 188 and not 128
+    std::vector<unsigned char> pixels(8 * 8 * 4);
+    for (int i = 0; i < 64; ++i)
+    {
+        unsigned char value = ((i % 8 + i / 8) % 2) ? 255 : 0;
+        pixels[i * 4 + 0] = pixels[i * 4 + 1] = pixels[i * 4 + 2] = value;
+        pixels[i * 4 + 3] = 255;
+    }
+
+    std::vector<TextureMip> mips;
+    TextureCooker::GenerateMips(pixels.data(), 8, 8, false, mips);
+
+    for (size_t i = 0; i < mips[1].data.size(); i += 4)
+    {
+        CHECK(std::abs(mips[1].data[i] - 188) <= 1);
+        CHECK(mips[1].data[i + 3] == 255);
+    }
+
+    // One opaque red texel among transparent green ones: the color must stay red
+    unsigned char quad[16] = {
+        255, 0, 0, 255,   0, 255, 0, 0,
+        0, 255, 0, 0,     0, 255, 0, 0
+    };
+    TextureCooker::GenerateMips(quad, 2, 2, false, mips);
+    CHECK(mips[1].data[0] == 255 && mips[1].data[1] == 0 && mips[1].data[2] == 0);
+    CHECK(std::abs(mips[1].data[3] - 64) <= 1);
+}
+
+static void TestCoveragePreserved()
+{
+    // Foliage-like alpha: mostly faint, a bit over half of the texels pass the alpha test
+    const int size = 64;
+    uint32_t state = 777;
+    std::vector<unsigned char> pixels(size * size * 4, 255);
+    for (int i = 0; i < size * size; ++i)
+    {
+        float u = (NextRandom(state) & 0xFFFF) / 65535.0f;
+        pixels[i * 4 + 3] = static_cast<unsigned char>(u * u * u * 255.0f);
+    }
+
+    std::vector<TextureMip> plain;
+    std::vector<TextureMip> preserved;
+    TextureCooker::GenerateMips(pixels.data(), size, size, false, plain);
+    TextureCooker::GenerateMips(pixels.data(), size, size, true, preserved);
+
+    float baseCoverage = Coverage(preserved[0]);
+    CHECK(baseCoverage > 0.4f && baseCoverage < 0.6f);
+
+    // Averaging alone drifts the coverage, the rescaled levels keep it. Below 16x16 there are
+    // too few distinct alpha values left to hit the target closely.
+    float plainDrift = 0.0f;
+    for (size_t level = 1; level < preserved.size(); ++level)
+    {
+        if (preserved[level].width < 16)
+            break;
+
+        CHECK(std::abs(Coverage(preserved[level]) - baseCoverage) <= 0.05f);
+        plainDrift = std::max(plainDrift, std::abs(Coverage(plain[level]) - baseCoverage));
+    }
+
+    CHECK(plainDrift > 0.1f);
+}
+
+static void TestCook()
+{
+    std::vector<unsigned char> pixels(32 * 16 * 4, 200);
+    CookedTexture cooked;
+
+    CHECK(!TextureCooker::Cook(nullptr, 32, 16, AlphaMode::Opaque, TextureFormat::BC1, cooked));
+    CHECK(TextureCooker::Cook(pixels.data(), 32, 16, AlphaMode::Cutout, TextureFormat::BC3, cooked));
+
+    CHECK(cooked.levelCount == 6);
+    CHECK(cooked.mips.size() == 6);
+    for (const TextureMip& mip : cooked.mips)
+        CHECK(mip.data.size() == TextureCooker::GetImageSize(TextureFormat::BC3, mip.width, mip.height));
+}
+
+int main()
+{
+    TestSolidBlocks();
+    TestGradientBlocks();
+    TestRandomBlocks();
+    TestBC1IsOpaque();
+    TestImageRoundTrip();
+    TestMipChain();
+    TestLinearSpaceMips();
+    TestCoveragePreserved();
+    TestCook();
+
+    return TEST_RESULT();
+}
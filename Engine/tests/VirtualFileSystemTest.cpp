@@ -0,0 +1,151 @@
+#include "VirtualFileSystem.h"
+#include "TestUtils.h"
+#include <windows.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define SOURCE_DIRECTORY "VirtualFileSystemTest"
+#define PACK_FILE "VirtualFileSystemTest.pack"
+#define DAMAGED_PACK_FILE "VirtualFileSystemTest.damaged.pack"
+#define MOUNT_POINT "Packed"
+
+static void WriteBytes(const std::string& path, const std::vector<unsigned char>& bytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+static std::vector<unsigned char> ReadBytes(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Repeated text, LZ4 shrinks it well below the raw threshold
+static std::vector<unsigned char> MakeCompressible()
+{
+    std::string text;
+    for (int i = 0; i < 2000; ++i)
+        text += "Every file read of the engine goes through here. " + std::to_string(i % 10) + "\n";
+    return std::vector<unsigned char>(text.begin(), text.end());
+}
+
+// Noise, LZ4 cannot shrink it so it is stored raw
+static std::vector<unsigned char> MakeIncompressible()
+{
+    std::vector<unsigned char> bytes(20000);
+    uint32_t state = 2024;
+    for (unsigned char& byte : bytes)
+    {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<unsigned char>(state >> 24);
+    }
+    return bytes;
+}
+
+static std::vector<unsigned char> Slice(const std::vector<unsigned char>& bytes, size_t offset, size_t size)
+{
+    return std::vector<unsigned char>(bytes.begin() + offset, bytes.begin() + offset + size);
+}
+
+static void TestPackRoundTrip(const std::vector<unsigned char>& text, const std::vector<unsigned char>& noise)
+{
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+
+    CHECK(VirtualFileSystem::BuildPack(SOURCE_DIRECTORY, PACK_FILE));
+    CHECK(vfs.MountPack(PACK_FILE, MOUNT_POINT));
+
+    std::vector<unsigned char> bytes;
+
+    // Whole files
+    CHECK(vfs.ReadFile(MOUNT_POINT "/empty.bin", bytes) && bytes.empty());
+    CHECK(vfs.ReadFile(MOUNT_POINT "/text.txt", bytes) && bytes == text);
+    CHECK(vfs.ReadFile(MOUNT_POINT "/Data/noise.bin", bytes) && bytes == noise);
+
+    // Paths are case insensitive
+    CHECK(vfs.ReadFile(MOUNT_POINT "/TEXT.txt", bytes) && bytes == text);
+
+    // Ranges, in the middle of the LZ4 entry and of the raw one
+    CHECK(vfs.ReadRange(MOUNT_POINT "/text.txt", 1000, 5000, bytes) && bytes == Slice(text, 1000, 5000));
+    CHECK(vfs.ReadRange(MOUNT_POINT "/text.txt", 0, 100, bytes) && bytes == Slice(text, 0, 100));
+    CHECK(vfs.ReadRange(MOUNT_POINT "/Data/noise.bin", 4097, 3000, bytes) && bytes == Slice(noise, 4097, 3000));
+
+    // Past the end: the bytes that exist, nothing when the start is already outside
+    CHECK(vfs.ReadRange(MOUNT_POINT "/text.txt", text.size() - 10, 100, bytes) && bytes == Slice(text, text.size() - 10, 10));
+    CHECK(vfs.ReadRange(MOUNT_POINT "/Data/noise.bin", 0, 0, bytes) && bytes == noise);
+    CHECK(!vfs.ReadRange(MOUNT_POINT "/Data/noise.bin", noise.size(), 10, bytes));
+    CHECK(!vfs.ReadFile(MOUNT_POINT "/missing.bin", bytes));
+
+    // Only raw entries can be mapped, which tells how each one was stored
+    MappedFile mapped;
+    CHECK(vfs.MapFile(MOUNT_POINT "/Data/noise.bin", mapped));
+    CHECK(mapped.size == noise.size());
+    CHECK(mapped.data != nullptr && std::vector<unsigned char>(mapped.data, mapped.data + mapped.size) == noise);
+    CHECK(!vfs.MapFile(MOUNT_POINT "/text.txt", mapped));
+
+    // The pack holds the text compressed and pads the raw entry, so it is smaller than the raw files and a page
+    std::vector<unsigned char> pack = ReadBytes(PACK_FILE);
+    CHECK(pack.size() < text.size() + noise.size() + 2 * 4096);
+
+    vfs.Unmount(PACK_FILE);
+    CHECK(!vfs.ReadFile(MOUNT_POINT "/text.txt", bytes));
+}
+
+static void TestDamagedPackRejected()
+{
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+    std::vector<unsigned char> pack = ReadBytes(PACK_FILE);
+    CHECK(pack.size() > 64);
+    if (pack.size() <= 64)
+        return;
+
+    // Table of contents cut off
+    WriteBytes(DAMAGED_PACK_FILE, Slice(pack, 0, pack.size() - 8));
+    CHECK(!vfs.MountPack(DAMAGED_PACK_FILE, MOUNT_POINT));
+
+    std::vector<unsigned char> badMagic = pack;
+    badMagic[0] ^= 0xFF;
+    WriteBytes(DAMAGED_PACK_FILE, badMagic);
+    CHECK(!vfs.MountPack(DAMAGED_PACK_FILE, MOUNT_POINT));
+
+    WriteBytes(DAMAGED_PACK_FILE, Slice(pack, 0, 16));
+    CHECK(!vfs.MountPack(DAMAGED_PACK_FILE, MOUNT_POINT));
+
+    std::remove(DAMAGED_PACK_FILE);
+}
+
+static void TestEmptyLooseFile()
+{
+    std::vector<unsigned char> bytes(1, 0);
+    CHECK(VirtualFileSystem::GetInstance().ReadFile(SOURCE_DIRECTORY "\\empty.bin", bytes) && bytes.empty());
+    CHECK(!VirtualFileSystem::GetInstance().ReadRange(SOURCE_DIRECTORY "\\empty.bin", 1, 0, bytes));
+}
+
+int main()
+{
+    std::vector<unsigned char> text = MakeCompressible();
+    std::vector<unsigned char> noise = MakeIncompressible();
+
+    CreateDirectoryA(SOURCE_DIRECTORY, NULL);
+    CreateDirectoryA(SOURCE_DIRECTORY "\\Data", NULL);
+    WriteBytes(SOURCE_DIRECTORY "\\empty.bin", std::vector<unsigned char>());
+    WriteBytes(SOURCE_DIRECTORY "\\text.txt", text);
+    WriteBytes(SOURCE_DIRECTORY "\\Data\\noise.bin", noise);
+
+    TestEmptyLooseFile();
+    TestPackRoundTrip(text, noise);
+    TestDamagedPackRejected();
+
+    std::remove(SOURCE_DIRECTORY "\\empty.bin");
+    std::remove(SOURCE_DIRECTORY "\\text.txt");
+    std::remove(SOURCE_DIRECTORY "\\Data\\noise.bin");
+    RemoveDirectoryA(SOURCE_DIRECTORY "\\Data");
+    RemoveDirectoryA(SOURCE_DIRECTORY);
+    std::remove(PACK_FILE);
+
+    return TEST_RESULT();
+}